@@ -0,0 +1,226 @@
+#include "assign.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define AUCTION_EPS_FACTOR 5 // Her aşamada ε bu oranda küçülür
+
+// Dikdörtgen problemde önceki aşamalardan kalan yüksek fiyatlı ama sahipsiz
+// nesneler en iyiliği bozar. λ = atanmış en düşük fiyat olmak üzere, fiyatı λ'dan
+// büyük her sahipsiz nesne ters teklif verir: ya fiyatını λ'ya indirir ya da
+// kârı en yüksek kişiyi kendine çeker (asimetrik atama için ileri-geri açık
+// artırma). Bitince sahipsiz nesnelerin fiyatı <= λ olur. Her aşamada
+// çalıştırılması bir sonraki aşamaya tutarlı fiyatlar bırakır; yalnız son aşamada
+// çalıştırmak fiyat savaşını ε = 1 adımlarla yürütür ve çok yavaştır.
+static void reverse_phase(const int32_t *a, int bidders, int objects, int64_t scale,
+                          int64_t eps, int *owner_of, int *object_of, int64_t *price, AuctionStats *stats)
+{
+    int64_t *profit = malloc((size_t)bidders * sizeof(int64_t));
+    int *pending = malloc((size_t)objects * sizeof(int));
+    if (!profit || !pending)
+    {
+        free(profit);
+        free(pending);
+        return;
+    }
+    int64_t lambda = 0;
+    bool have_lambda = false;
+    for (int i = 0; i < bidders; i++)
+    {
+        int j = object_of[i];
+        profit[i] = (int64_t)a[(size_t)i * objects + j] * scale - price[j];
+        if (!have_lambda || price[j] < lambda)
+            lambda = price[j];
+        have_lambda = true;
+    }
+
+    int pending_len = 0;
+    for (int j = 0; j < objects; j++)
+        if (owner_of[j] < 0 && price[j] > lambda)
+            pending[pending_len++] = j;
+
+    while (pending_len > 0)
+    {
+        int j = pending[--pending_len];
+        int best = -1;
+        int64_t best_value = 0, second_value = 0;
+        bool have_second = false;
+        for (int i = 0; i < bidders; i++)
+        {
+            int64_t v = (int64_t)a[(size_t)i * objects + j] * scale - profit[i];
+            if (best < 0 || v > best_value)
+            {
+                if (best >= 0)
+                {
+                    second_value = best_value;
+                    have_second = true;
+                }
+                best_value = v;
+                best = i;
+            }
+            else if (!have_second || v > second_value)
+            {
+                second_value = v;
+                have_second = true;
+            }
+        }
+        stats->bids++;
+        if (lambda >= best_value - eps)
+        {
+            price[j] = lambda; // Kimseyi çekemez; sahipsiz nesne fiyatı λ'ya iner
+            continue;
+        }
+        int64_t new_price = have_second && second_value - eps > lambda ? second_value - eps : lambda;
+        int released = object_of[best];
+        price[j] = new_price;
+        profit[best] = (int64_t)a[(size_t)best * objects + j] * scale - new_price;
+        owner_of[j] = best;
+        object_of[best] = j;
+        owner_of[released] = -1;
+        if (price[released] > lambda)
+            pending[pending_len++] = released;
+    }
+
+    free(profit);
+    free(pending);
+}
+
+// bidders <= objects olan problemi çözer; a bidders x objects faydadır, teklifler
+// scale ile çarpılmış değerler üzerinden verilir.
+static void auction_solve(const int32_t *a, int bidders, int objects, int64_t scale, int64_t benefit_range,
+                          int *owner_of, int *object_of, int64_t *price, int *queue, AuctionStats *stats)
+{
+    memset(price, 0, (size_t)objects * sizeof(int64_t));
+    int64_t eps = benefit_range / 2 > 1 ? benefit_range / 2 : 1;
+    for (;;)
+    {
+        stats->phases++;
+        // Her aşama atamaları sıfırlar, fiyatları korur (ε-ölçekleme)
+        for (int j = 0; j < objects; j++)
+            owner_of[j] = -1;
+        int queue_len = 0;
+        for (int i = 0; i < bidders; i++)
+        {
+            object_of[i] = -1;
+            queue[queue_len++] = i;
+        }
+
+        while (queue_len > 0)
+        {
+            int i = queue[--queue_len];
+            const int32_t *row = a + (size_t)i * objects;
+            int best = -1;
+            int64_t best_value = 0, second_value = 0;
+            bool have_second = false;
+            for (int j = 0; j < objects; j++)
+            {
+                int64_t v = (int64_t)row[j] * scale - price[j];
+                if (best < 0 || v > best_value)
+                {
+                    if (best >= 0)
+                    {
+                        second_value = best_value;
+                        have_second = true;
+                    }
+                    best_value = v;
+                    best = j;
+                }
+                else if (!have_second || v > second_value)
+                {
+                    second_value = v;
+                    have_second = true;
+                }
+            }
+            stats->bids++;
+            // Teklif: en iyi ile ikinci en iyi arasındaki fark + ε kadar fiyat artışı
+            price[best] += (have_second ? best_value - second_value : 0) + eps;
+            int previous = owner_of[best];
+            owner_of[best] = i;
+            object_of[i] = best;
+            if (previous >= 0)
+            {
+                object_of[previous] = -1;
+                queue[queue_len++] = previous;
+            }
+        }
+
+        if (bidders < objects)
+            reverse_phase(a, bidders, objects, scale, eps, owner_of, object_of, price, stats);
+        if (eps == 1)
+            break;
+        eps /= AUCTION_EPS_FACTOR;
+        if (eps < 1)
+            eps = 1;
+    }
+}
+
+bool auction_assign(const int32_t *benefit, int rows, int cols, int *row_to_col, AuctionStats *stats)
+{
+    AuctionStats local;
+    if (!stats)
+        stats = &local;
+    memset(stats, 0, sizeof(*stats));
+    for (int i = 0; i < rows; i++)
+        row_to_col[i] = -1;
+    if (rows == 0 || cols == 0)
+        return true;
+
+    // Teklif verenler küçük taraf olur; gerekirse matris devrilir
+    bool transposed = rows > cols;
+    int bidders = transposed ? cols : rows;
+    int objects = transposed ? rows : cols;
+    int64_t scale = (int64_t)bidders + 1; // ε = 1 ölçekli, 1/(n+1) ölçeksiz: en iyiye eşit
+
+    int32_t *transposed_copy = transposed ? malloc((size_t)bidders * objects * sizeof(int32_t)) : NULL;
+    int64_t *price = malloc((size_t)objects * sizeof(int64_t));
+    int *owner_of = malloc((size_t)objects * sizeof(int));
+    int *object_of = malloc((size_t)bidders * sizeof(int));
+    int *queue = malloc((size_t)bidders * sizeof(int));
+    if ((transposed && !transposed_copy) || !price || !owner_of || !object_of || !queue)
+    {
+        free(transposed_copy);
+        free(price);
+        free(owner_of);
+        free(object_of);
+        free(queue);
+        return false;
+    }
+
+    int32_t min_benefit = benefit[0], max_benefit = benefit[0];
+    for (size_t k = 0; k < (size_t)rows * cols; k++)
+    {
+        if (benefit[k] < min_benefit)
+            min_benefit = benefit[k];
+        if (benefit[k] > max_benefit)
+            max_benefit = benefit[k];
+    }
+    const int32_t *a = benefit;
+    if (transposed)
+    {
+        for (int i = 0; i < rows; i++)
+            for (int j = 0; j < cols; j++)
+                transposed_copy[(size_t)j * rows + i] = benefit[(size_t)i * cols + j];
+        a = transposed_copy;
+    }
+
+    auction_solve(a, bidders, objects, scale, ((int64_t)max_benefit - min_benefit) * scale,
+                  owner_of, object_of, price, queue, stats);
+
+    for (int i = 0; i < bidders; i++)
+    {
+        int j = object_of[i];
+        if (j < 0)
+            continue;
+        if (transposed)
+            row_to_col[j] = i;
+        else
+            row_to_col[i] = j;
+        stats->total_benefit += a[(size_t)i * objects + j];
+    }
+
+    free(transposed_copy);
+    free(price);
+    free(owner_of);
+    free(object_of);
+    free(queue);
+    return true;
+}
@@ -0,0 +1,26 @@
+#ifndef ASSIGN_H
+#define ASSIGN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Toplu görev atama için açık artırma (auction) çözücüsü. benefit rows x cols
+// satır öncelikli tamsayı fayda matrisidir (controller'da: satır drone, sütun
+// survivor, değer skor). Toplam faydayı en büyükleyen bire bir eşleştirmeyi arar;
+// min(rows, cols) atama yapılır.
+//
+// Faydalar (n+1) ile ölçeklenip ε-ölçekleme ile çözülür (n = teklif veren
+// sayısı); son aşama ε = 1 olduğundan bulunan atama en iyidir. rows != cols
+// iken her aşama ileri açık artırmanın ardından sahipsiz nesnelerin ters
+// teklifleriyle kapanır.
+typedef struct
+{
+    unsigned long bids;   // Toplam teklif sayısı (her teklif bir satır taraması)
+    int phases;           // ε-ölçekleme aşaması sayısı
+    int64_t total_benefit; // Bulunan atamanın toplam faydası (ölçeksiz)
+} AuctionStats;
+
+// row_to_col[i]: i. satıra atanan sütun, atanmadıysa -1. Bellek ayrılamazsa false.
+bool auction_assign(const int32_t *benefit, int rows, int cols, int *row_to_col, AuctionStats *stats);
+
+#endif
@@ -0,0 +1,1373 @@
+#define _POSIX_C_SOURCE 200112L // clock_gettime, pthread_barrier_t
+// bench.c: sunucu algoritmaları için bağımsız ölçüm programı (ağ/json-c gerekmez).
+//   ./bench assign [drones] [survivors]   greedy ve toplu atama karşılaştırması
+//   ./bench region [drones] [survivors] [workers]   bölgelere ayrılmış paralel atama
+//   ./bench route [stops] [trials]   çok duraklı rota: en yakın komşu, 2-opt ve en iyi sıra
+//   ./bench path [size] [drones] [goals]   engelli haritada A* ve yol önbelleği
+//   ./bench field [size] [survivors] [queries]   uzaklık alanları: bellek ve sorgu hızı
+//   ./bench mpsc [producers] [items]   kilitsiz olay kuyruğu ile add_list/pop_list
+//   ./bench alloc [threads] [ops]   survivor slab havuzu ile malloc/free
+//   ./bench soa [survivors] [drones]   bağlı liste taraması ile sütun tablosu SIMD skorlaması
+//   ./bench map [threads] [lookups]   ID ile arama: kilitli liste taraması ve parçalı hash map
+//   ./bench telemetry [readers] [updates]   STATUS_UPDATE: drone kilidi ile seqlock
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "assign.h"
+#include "region.h"
+#include "route.h"
+#include "navmap.h"
+#include "list.h"
+#include "slab.h"
+#include "survtab.h"
+#include "hashmap.h"
+
+#define MAP_X_LIMIT 40 // server.c ile aynı harita
+#define MAP_Y_LIMIT 60
+#define SIM_TICK_S 2   // Controller periyodu
+#define SIM_SPEED 1    // Drone hızı: saniyede bir hücre
+#define BIG_MAP 1000   // bench region: büyük harita kenarı
+#define BIG_MAP_CELL 8
+#define BIG_MAP_REGION_CELLS 32
+#define ROUTE_EXACT_MAX 9 // bench route: en iyi sıra bu kadar durağa kadar tam aranır
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static int manhattan(int ax, int ay, int bx, int by)
+{
+    return abs(ax - bx) + abs(ay - by);
+}
+
+// server.c'deki skor: priority*100 + yaş - mesafe*2
+static int32_t score(int priority, long age, int dist)
+{
+    return (int32_t)(priority * 100 + age - dist * 2);
+}
+
+// Controller'ın greedy kuralı: satırlar sırayla, her biri kalan en iyi sütunu alır.
+static void greedy_assign(const int32_t *benefit, int rows, int cols, int *row_to_col)
+{
+    char *taken = calloc((size_t)cols, 1);
+    for (int i = 0; i < rows; i++)
+    {
+        int best = -1;
+        for (int j = 0; j < cols; j++)
+            if (!taken[j] && (best < 0 || benefit[(size_t)i * cols + j] > benefit[(size_t)i * cols + best]))
+                best = j;
+        row_to_col[i] = best;
+        if (best >= 0)
+            taken[best] = 1;
+    }
+    free(taken);
+}
+
+typedef struct
+{
+    int x, y;
+    int tx, ty;
+    int target; // Survivor indeksi, boşsa -1
+    int next;   // Sıraya alınmış survivor (QUEUE_MISSION), yoksa -1
+} SimDrone;
+
+typedef struct
+{
+    int x, y;
+    int priority;
+    long created;
+    int state; // 0: açık, 1: hedeflenmiş, 2: kurtarıldı
+} SimSurvivor;
+
+typedef struct
+{
+    double latency;  // Ortalama kurtarma süresi (oluşturma -> varış), saniye
+    double solve_ms; // Atama çözücüsünde geçen toplam süre
+    long rescued;
+    double busy;     // Drone'ların hareket ettiği zaman oranı
+} SimResult;
+
+// Bir stratejiyi simüle eder (karşılaştırma için çağrılar aynı tohumu kullanır):
+// her turda arrivals yeni survivor, boştaki drone'lara atama, drone'lar SIM_SPEED
+// ile ilerler. pipeline açıksa görevdeki drone'lara, hedefinden en iyi skoru veren
+// açık survivor sıraya alınır; drone varınca aynı saniyede ona yönelir.
+static void simulate(bool batch, bool pipeline, int drones, int arrivals, long duration_s, unsigned seed, SimResult *result)
+{
+    srand(seed);
+    long max_survivors = arrivals * (duration_s / SIM_TICK_S + 1);
+    SimDrone *d = calloc((size_t)drones, sizeof(SimDrone));
+    SimSurvivor *s = calloc((size_t)max_survivors, sizeof(SimSurvivor));
+    int32_t *benefit = malloc((size_t)drones * max_survivors * sizeof(int32_t));
+    int *open = malloc((size_t)max_survivors * sizeof(int));
+    int *idle = malloc((size_t)drones * sizeof(int));
+    int *choice = malloc((size_t)drones * sizeof(int));
+    for (int i = 0; i < drones; i++)
+    {
+        d[i].x = rand() % MAP_X_LIMIT;
+        d[i].y = rand() % MAP_Y_LIMIT;
+        d[i].target = -1;
+        d[i].next = -1;
+    }
+
+    long survivor_count = 0, rescued = 0, busy_steps = 0;
+    double latency = 0.0;
+    result->solve_ms = 0.0;
+    for (long t = 0; t < duration_s; t += SIM_TICK_S)
+    {
+        for (int k = 0; k < arrivals; k++)
+        {
+            SimSurvivor *sv = &s[survivor_count++];
+            sv->x = rand() % MAP_X_LIMIT;
+            sv->y = rand() % MAP_Y_LIMIT;
+            sv->priority = rand() % 3 + 1;
+            sv->created = t;
+        }
+
+        int idle_count = 0, open_count = 0;
+        for (int i = 0; i < drones; i++)
+            if (d[i].target < 0)
+                idle[idle_count++] = i;
+        for (long j = 0; j < survivor_count; j++)
+            if (s[j].state == 0)
+                open[open_count++] = (int)j;
+        for (int i = 0; i < idle_count; i++)
+            for (int j = 0; j < open_count; j++)
+            {
+                const SimDrone *dr = &d[idle[i]];
+                const SimSurvivor *sv = &s[open[j]];
+                benefit[(size_t)i * open_count + j] = score(sv->priority, t - sv->created, manhattan(dr->x, dr->y, sv->x, sv->y));
+            }
+
+        double started = now_ms();
+        if (batch)
+            auction_assign(benefit, idle_count, open_count, choice, NULL);
+        else
+            greedy_assign(benefit, idle_count, open_count, choice);
+        result->solve_ms += now_ms() - started;
+
+        for (int i = 0; i < idle_count; i++)
+        {
+            if (choice[i] < 0)
+                continue;
+            SimDrone *dr = &d[idle[i]];
+            dr->target = open[choice[i]];
+            s[dr->target].state = 1;
+            dr->tx = s[dr->target].x;
+            dr->ty = s[dr->target].y;
+        }
+
+        // server.c queue_next_missions: skor, drone'un konumundan değil hedefinden
+        for (int i = 0; pipeline && i < drones; i++)
+        {
+            SimDrone *dr = &d[i];
+            if (dr->target < 0 || dr->next >= 0)
+                continue;
+            int best = -1;
+            int32_t best_score = 0;
+            for (long j = 0; j < survivor_count; j++)
+            {
+                if (s[j].state != 0)
+                    continue;
+                int32_t sc = score(s[j].priority, t - s[j].created, manhattan(dr->tx, dr->ty, s[j].x, s[j].y));
+                if (best < 0 || sc > best_score)
+                {
+                    best = (int)j;
+                    best_score = sc;
+                }
+            }
+            if (best >= 0)
+            {
+                dr->next = best;
+                s[best].state = 1;
+            }
+        }
+
+        // Drone'ları bir tur boyunca ilerlet; varış anı saniye hassasiyetinde
+        for (int i = 0; i < drones; i++)
+        {
+            SimDrone *dr = &d[i];
+            for (int step = 0; step < SIM_TICK_S && dr->target >= 0; step++)
+            {
+                busy_steps++;
+                for (int m = 0; m < SIM_SPEED; m++)
+                {
+                    if (dr->x != dr->tx)
+                        dr->x += dr->x < dr->tx ? 1 : -1;
+                    else if (dr->y != dr->ty)
+                        dr->y += dr->y < dr->ty ? 1 : -1;
+                }
+                if (dr->x == dr->tx && dr->y == dr->ty)
+                {
+                    s[dr->target].state = 2;
+                    latency += (double)(t + step + 1 - s[dr->target].created);
+                    rescued++;
+                    dr->target = dr->next;
+                    dr->next = -1;
+                    if (dr->target >= 0)
+                    {
+                        dr->tx = s[dr->target].x;
+                        dr->ty = s[dr->target].y;
+                    }
+                }
+            }
+        }
+    }
+
+    free(d);
+    free(s);
+    free(benefit);
+    free(open);
+    free(idle);
+    free(choice);
+    result->latency = rescued ? latency / rescued : 0.0;
+    result->rescued = rescued;
+    result->busy = (double)busy_steps / ((double)drones * duration_s);
+}
+
+static int bench_assign(int argc, char **argv)
+{
+    int drones = argc > 2 ? atoi(argv[2]) : 500;
+    int survivors = argc > 3 ? atoi(argv[3]) : 5000;
+    if (drones < 1 || survivors < 1)
+    {
+        fprintf(stderr, "Usage: %s assign [drones] [survivors]\n", argv[0]);
+        return 1;
+    }
+
+    // Tek tur maliyeti: drones x survivors rastgele anlık durum
+    srand(42);
+    int32_t *benefit = malloc((size_t)drones * survivors * sizeof(int32_t));
+    int *dx = malloc((size_t)drones * sizeof(int)), *dy = malloc((size_t)drones * sizeof(int));
+    int *choice = malloc((size_t)drones * sizeof(int));
+    if (!benefit || !dx || !dy || !choice)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    for (int i = 0; i < drones; i++)
+    {
+        dx[i] = rand() % MAP_X_LIMIT;
+        dy[i] = rand() % MAP_Y_LIMIT;
+    }
+    for (int j = 0; j < survivors; j++)
+    {
+        int sx = rand() % MAP_X_LIMIT, sy = rand() % MAP_Y_LIMIT;
+        int priority = rand() % 3 + 1;
+        long age = rand() % 300;
+        for (int i = 0; i < drones; i++)
+            benefit[(size_t)i * survivors + j] = score(priority, age, manhattan(dx[i], dy[i], sx, sy));
+    }
+
+    double started = now_ms();
+    greedy_assign(benefit, drones, survivors, choice);
+    double greedy_ms = now_ms() - started;
+    long long greedy_total = 0;
+    for (int i = 0; i < drones; i++)
+        if (choice[i] >= 0)
+            greedy_total += benefit[(size_t)i * survivors + choice[i]];
+
+    AuctionStats stats;
+    started = now_ms();
+    auction_assign(benefit, drones, survivors, choice, &stats);
+    double auction_ms = now_ms() - started;
+
+    printf("Single tick, %d drones x %d survivors:\n", drones, survivors);
+    printf("  greedy:  total score %lld, %.2f ms\n", greedy_total, greedy_ms);
+    printf("  auction: total score %lld, %.2f ms (%lu bids, %d phases)\n",
+           (long long)stats.total_benefit, auction_ms, stats.bids, stats.phases);
+    free(benefit);
+    free(dx);
+    free(dy);
+    free(choice);
+
+    // Kurtarma süresi: sürekli gelen survivor'larla kısa bir simülasyon
+    // 40 drone rahat, 10 drone doymuş filo: sıraya alma ancak ikincisinde kazandırır
+    static const int sim_fleets[] = {40, 10};
+    int sim_arrivals = 2;
+    long sim_duration = 3600;
+    static const struct
+    {
+        const char *name;
+        bool batch, pipeline;
+    } modes[] = {
+        {"greedy:         ", false, false},
+        {"batch:          ", true, false},
+        {"greedy+queue:   ", false, true},
+        {"batch+queue:    ", true, true},
+    };
+    for (size_t f = 0; f < sizeof(sim_fleets) / sizeof(sim_fleets[0]); f++)
+    {
+        printf("Simulation, %d drones, %d survivors per %d s tick, %ld s:\n",
+               sim_fleets[f], sim_arrivals, SIM_TICK_S, sim_duration);
+        for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+        {
+            SimResult r;
+            simulate(modes[m].batch, modes[m].pipeline, sim_fleets[f], sim_arrivals, sim_duration, 7, &r);
+            printf("  %s mean time-to-rescue %.1f s, %.0f rescues/h, drones busy %.1f%% (solver %.1f ms total)\n",
+                   modes[m].name, r.latency, r.rescued * 3600.0 / sim_duration, r.busy * 100.0, r.solve_ms);
+        }
+    }
+    return 0;
+}
+
+static void release_picks(PlanDrone *drones, int count)
+{
+    for (int i = 0; i < count; i++)
+        if (drones[i].pick)
+            drones[i].pick->is_targeted = false;
+}
+
+static double total_score(const PlanDrone *drones, int count)
+{
+    double total = 0.0;
+    for (int i = 0; i < count; i++)
+        if (drones[i].pick)
+            total += drones[i].score;
+    return total;
+}
+
+static int bench_region(int argc, char **argv)
+{
+    int drones = argc > 2 ? atoi(argv[2]) : 2000;
+    int survivors = argc > 3 ? atoi(argv[3]) : 200000;
+    int workers = argc > 4 ? atoi(argv[4]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (drones < 1 || survivors < 1 || workers < 1)
+    {
+        fprintf(stderr, "Usage: %s region [drones] [survivors] [workers]\n", argv[0]);
+        return 1;
+    }
+
+    srand(42);
+    time_t now = time(NULL);
+    SurvivorGrid grid;
+    PlanDrone *plan = calloc((size_t)drones, sizeof(PlanDrone));
+    Survivor **all = malloc((size_t)survivors * sizeof(Survivor *));
+    if (!plan || !all || !survgrid_init(&grid, BIG_MAP, BIG_MAP, BIG_MAP_CELL))
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    for (int j = 0; j < survivors; j++)
+    {
+        all[j] = create_survivor(j, rand() % BIG_MAP, rand() % BIG_MAP, rand() % 3 + 1);
+        all[j]->creation_time = now - rand() % 300;
+        survgrid_insert(&grid, all[j]);
+    }
+    for (int i = 0; i < drones; i++)
+        plan[i].pos = (Coordinate){rand() % BIG_MAP, rand() % BIG_MAP};
+
+    // Tek thread: controller'ın greedy geçişi (her drone tüm ızgarada sorgular)
+    double started = now_ms();
+    for (int i = 0; i < drones; i++)
+    {
+        plan[i].pick = survgrid_best(&grid, plan[i].pos, now, &plan[i].score);
+        if (plan[i].pick)
+            plan[i].pick->is_targeted = true;
+    }
+    double greedy_ms = now_ms() - started;
+    printf("%d drones, %d survivors, %dx%d map, %d-cell regions:\n", drones, survivors, BIG_MAP, BIG_MAP, BIG_MAP_REGION_CELLS);
+    printf("  greedy (1 thread): total score %.0f, %.2f ms\n", total_score(plan, drones), greedy_ms);
+    release_picks(plan, drones);
+
+    int counts[2] = {1, workers};
+    for (int k = 0; k < (workers > 1 ? 2 : 1); k++)
+    {
+        WorkPool *pool = workpool_create(counts[k]);
+        RegionPlanner planner;
+        if (!pool || !region_planner_init(&planner, &grid, pool, BIG_MAP_REGION_CELLS))
+        {
+            fprintf(stderr, "Worker pool setup failed\n");
+            return 1;
+        }
+        started = now_ms();
+        region_plan(&planner, plan, drones, now);
+        double region_ms = now_ms() - started;
+        printf("  region (%d worker%s): total score %.0f, %.2f ms, %lu reconciled, %lu steals\n",
+               counts[k], counts[k] == 1 ? "" : "s", total_score(plan, drones), region_ms,
+               planner.stat_reconciled, pool->stat_steals);
+        release_picks(plan, drones);
+        region_planner_destroy(&planner);
+        workpool_destroy(pool);
+    }
+
+    survgrid_destroy(&grid);
+    for (int j = 0; j < survivors; j++)
+        free_survivor(all[j]);
+    free(all);
+    free(plan);
+    return 0;
+}
+
+// start'tan tüm durakları gezen en kısa açık yol (dal-sınır ile tam arama).
+static void exact_route(Coordinate at, const Coordinate *stops, int count, bool *used, int depth, int length, int *best)
+{
+    if (length >= *best)
+        return;
+    if (depth == count)
+    {
+        *best = length;
+        return;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        if (used[i])
+            continue;
+        used[i] = true;
+        exact_route(stops[i], stops, count, used, depth + 1, length + manhattan(at.x, at.y, stops[i].x, stops[i].y), best);
+        used[i] = false;
+    }
+}
+
+static int bench_route(int argc, char **argv)
+{
+    int stops = argc > 2 ? atoi(argv[2]) : ROUTE_MAX_STOPS;
+    int trials = argc > 3 ? atoi(argv[3]) : 10000;
+    if (stops < 1 || trials < 1)
+    {
+        fprintf(stderr, "Usage: %s route [stops] [trials]\n", argv[0]);
+        return 1;
+    }
+
+    // Drone haritada rastgele bir yerde, duraklar 6 hücre yarıçaplı bir kümede
+    srand(42);
+    Coordinate *pts = malloc((size_t)stops * sizeof(Coordinate));
+    int *order = malloc((size_t)stops * sizeof(int));
+    bool *used = calloc((size_t)stops, sizeof(bool));
+    if (!pts || !order || !used)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    long long nn_total = 0, opt_total = 0, exact_total = 0, swaps = 0;
+    double plan_ms = 0.0;
+    bool exact = stops <= ROUTE_EXACT_MAX;
+    for (int t = 0; t < trials; t++)
+    {
+        Coordinate start = {rand() % MAP_X_LIMIT, rand() % MAP_Y_LIMIT};
+        int cx = rand() % MAP_X_LIMIT, cy = rand() % MAP_Y_LIMIT;
+        for (int i = 0; i < stops; i++)
+            pts[i] = (Coordinate){cx + rand() % 13 - 6, cy + rand() % 13 - 6};
+        RouteStats stats;
+        double started = now_ms();
+        route_plan(start, pts, stops, 1 << 30, order, &stats);
+        plan_ms += now_ms() - started;
+        nn_total += stats.nn_length;
+        opt_total += stats.length;
+        swaps += stats.swaps;
+        if (exact)
+        {
+            int best = stats.length;
+            exact_route(start, pts, stops, used, 0, 0, &best);
+            exact_total += best;
+        }
+    }
+
+    printf("Route planning, %d stops in a 13x13 cluster, %d trials:\n", stops, trials);
+    printf("  nearest neighbor: mean length %.1f cells\n", (double)nn_total / trials);
+    printf("  + 2-opt:          mean length %.1f cells, %.2f swaps, %.2f us per plan\n",
+           (double)opt_total / trials, (double)swaps / trials, plan_ms * 1000.0 / trials);
+    if (exact)
+        printf("  exact:            mean length %.1f cells (2-opt within %.2f%%)\n", (double)exact_total / trials,
+               100.0 * (opt_total - exact_total) / exact_total);
+    // Rotasız greedy kümedeki her survivor'a ayrı drone gönderir
+    printf("  drones tied up per cluster: %d without routes, %d with routes\n", stops,
+           (stops + ROUTE_MAX_STOPS) / (ROUTE_MAX_STOPS + 1));
+    free(pts);
+    free(order);
+    free(used);
+    return 0;
+}
+
+// Haritaya rastgele duvarlar: her biri ortasında geçit bırakan dikey veya yatay şerit.
+static void build_walls(NavMap *map, int size, int walls)
+{
+    for (int w = 0; w < walls; w++)
+    {
+        int len = size / 4 + rand() % (size / 2), at = rand() % size, from = rand() % (size - len);
+        int gap = from + len / 4 + rand() % (len / 2), gap_len = 2 + size / 50;
+        if (w % 2)
+        {
+            navmap_block(map, at, from, at, gap - 1);
+            navmap_block(map, at, gap + gap_len, at, from + len);
+        }
+        else
+        {
+            navmap_block(map, from, at, gap - 1, at);
+            navmap_block(map, gap + gap_len, at, from + len, at);
+        }
+    }
+}
+
+static Coordinate free_cell(const NavMap *map, int size)
+{
+    Coordinate c;
+    do
+    {
+        c = (Coordinate){rand() % size, rand() % size};
+    } while (navmap_blocked(map, c));
+    return c;
+}
+
+// Dönüş noktaları üzerinden to'ya doğru steps hücre ilerler (client.c step_drone gibi).
+static Coordinate walk_path(Coordinate at, const Coordinate *points, int count, Coordinate to, int steps)
+{
+    int next = 0;
+    while (steps-- > 0)
+    {
+        Coordinate target = next < count ? points[next] : to;
+        if (at.x != target.x)
+            at.x += at.x < target.x ? 1 : -1;
+        else if (at.y != target.y)
+            at.y += at.y < target.y ? 1 : -1;
+        if (at.x == target.x && at.y == target.y && next < count)
+            next++;
+    }
+    return at;
+}
+
+static int bench_path(int argc, char **argv)
+{
+    int size = argc > 2 ? atoi(argv[2]) : 200;
+    int drones = argc > 3 ? atoi(argv[3]) : 24;
+    int goals = argc > 4 ? atoi(argv[4]) : 20;
+    if (size < 16 || drones < 1 || goals < 1)
+    {
+        fprintf(stderr, "Usage: %s path [size>=16] [drones] [goals]\n", argv[0]);
+        return 1;
+    }
+    srand(42);
+    NavMap map;
+    if (!navmap_init(&map, size, size))
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    build_walls(&map, size, 24);
+    navmap_set_field_budget(&map, 0); // Sadece A* ve yol önbelleği; alanlar: bench field
+    Coordinate *from = malloc((size_t)drones * sizeof(Coordinate));
+    Coordinate *to = malloc((size_t)goals * sizeof(Coordinate));
+    if (!from || !to)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    for (int i = 0; i < drones; i++)
+        from[i] = free_cell(&map, size);
+    for (int j = 0; j < goals; j++)
+        to[j] = free_cell(&map, size);
+
+    printf("Path planning, %dx%d map, %d of %d cells blocked, %d drones x %d goals:\n", size, size,
+           map.blocked_count, size * size, drones, goals);
+    long long manhattan_total = 0;
+    for (int i = 0; i < drones; i++)
+        for (int j = 0; j < goals; j++)
+            manhattan_total += manhattan(from[i].x, from[i].y, to[j].x, to[j].y);
+    // Controller her geçişte aynı çiftleri yeniden skorlar: ilki soğuk, ikincisi önbellekten
+    // (hedef başına NAVMAP_PATHS_PER_GOAL yol tutulur; filo bundan büyükse fazlası yeniden aranır)
+    for (int pass = 0; pass < 2; pass++)
+    {
+        NavStats before, after;
+        navmap_get_stats(&map, &before);
+        long long cost_total = 0;
+        int unreachable = 0;
+        double started = now_ms();
+        for (int i = 0; i < drones; i++)
+            for (int j = 0; j < goals; j++)
+            {
+                int cost = navmap_cost(&map, from[i], to[j]);
+                if (cost < 0)
+                    unreachable++;
+                else
+                    cost_total += cost;
+            }
+        double ms = now_ms() - started;
+        navmap_get_stats(&map, &after);
+        unsigned long searches = after.searches - before.searches;
+        printf("  score %s: %.2f ms (%.2f us per pair), %lu A* searches, %.0f cells expanded each, "
+               "%lu cache hits, %d unreachable\n",
+               pass == 0 ? "cold" : "warm", ms, ms * 1000.0 / ((double)drones * goals), searches,
+               searches ? (double)(after.expanded - before.expanded) / searches : 0.0, after.hits - before.hits,
+               unreachable);
+        if (pass == 0)
+            printf("  mean path %.1f cells vs Manhattan %.1f\n",
+                   (double)cost_total / (drones * goals - unreachable), (double)manhattan_total / (drones * goals));
+    }
+
+    // Görev yolunda ilerleyen drone: her drone bir hedefe atanır, yolun yarısını uçar ve
+    // yeniden skorlanır. Konumu kendi yolunun üzerinde olduğu için önbellekten yanıtlanır.
+    Coordinate points[256];
+    int assigned = 0;
+    double search_ms = 0, requery_ms = 0;
+    NavStats before, after;
+    navmap_get_stats(&map, &before);
+    for (int i = 0; i < drones; i++)
+    {
+        int cost;
+        Coordinate goal = to[i % goals];
+        navmap_forget(&map, goal); // Atama anında hedefin yolu ilk kez aranıyor
+        double started = now_ms();
+        int n = navmap_waypoints(&map, from[i], goal, points, 256, &cost);
+        search_ms += now_ms() - started;
+        if (n < 0)
+            continue;
+        Coordinate midway = walk_path(from[i], points, n, goal, cost / 2);
+        started = now_ms();
+        int rest = navmap_cost(&map, midway, goal);
+        requery_ms += now_ms() - started;
+        if (rest != cost - cost / 2)
+            printf("  mismatch: drone %d midway cost %d, expected %d\n", i, rest, cost - cost / 2);
+        assigned++;
+    }
+    navmap_get_stats(&map, &after);
+    printf("  en route: %d missions, first path %.2f us, midway re-score %.2f us, %lu of %d re-scores from cache\n",
+           assigned, assigned ? search_ms * 1000.0 / assigned : 0.0, assigned ? requery_ms * 1000.0 / assigned : 0.0,
+           after.hits - before.hits, assigned);
+    navmap_destroy(&map);
+    free(from);
+    free(to);
+    return 0;
+}
+
+// Rastgele (drone, survivor) sorguları; ortalama süre (us) döner.
+static double run_queries(NavMap *map, const Coordinate *from, const Coordinate *to, int count, int goals,
+                          int queries, long long *cost_total)
+{
+    *cost_total = 0;
+    double started = now_ms();
+    for (int q = 0; q < queries; q++)
+        *cost_total += navmap_cost(map, from[q % count], to[(q * 7 + q / count) % goals]);
+    return (now_ms() - started) * 1000.0 / queries;
+}
+
+static int bench_field(int argc, char **argv)
+{
+    int size = argc > 2 ? atoi(argv[2]) : 1000;
+    int goals = argc > 3 ? atoi(argv[3]) : 20;
+    int queries = argc > 4 ? atoi(argv[4]) : 100000;
+    if (size < 16 || goals < 1 || queries < 1)
+    {
+        fprintf(stderr, "Usage: %s field [size>=16] [survivors] [queries]\n", argv[0]);
+        return 1;
+    }
+    // A* sorgusu pahalı: karşılaştırma için sorguların küçük bir kısmı yeterli
+    int astar_queries = queries / 500 > goals ? queries / 500 : goals;
+    int count = 1024;
+    NavMap map;
+    Coordinate *from = malloc((size_t)count * sizeof(Coordinate));
+    Coordinate *to = malloc((size_t)goals * sizeof(Coordinate));
+    if (!from || !to || !navmap_init(&map, size, size))
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    srand(7);
+    build_walls(&map, size, 24);
+    for (int i = 0; i < count; i++)
+        from[i] = free_cell(&map, size);
+    for (int j = 0; j < goals; j++)
+        to[j] = free_cell(&map, size);
+    printf("Distance fields, %dx%d map, %d cells blocked, %d survivors:\n", size, size, map.blocked_count, goals);
+
+    long long astar_total, field_total;
+    NavStats stats;
+    navmap_set_field_budget(&map, 0);
+    double astar_us = run_queries(&map, from, to, count, goals, astar_queries, &astar_total);
+    navmap_get_stats(&map, &stats);
+    printf("  A* + path cache: %.1f us per query over %d queries (%lu searches, %lu cache hits), "
+           "%.1f MB of cached paths\n",
+           astar_us, astar_queries, stats.searches, stats.hits,
+           map.cached_cells * sizeof(Coordinate) / (1024.0 * 1024.0));
+    for (int j = 0; j < goals; j++)
+        navmap_forget(&map, to[j]);
+
+    navmap_set_field_budget(&map, NAVMAP_FIELD_BUDGET);
+    double started = now_ms();
+    for (int j = 0; j < goals; j++)
+        navmap_track(&map, to[j]);
+    double track_ms = now_ms() - started;
+    navmap_get_stats(&map, &stats);
+    printf("  fields opened at survivor creation: %.3f ms each, %.2f MB each (2 bytes per cell)\n",
+           track_ms / goals, stats.field_bytes / (1024.0 * 1024.0) / goals);
+    // İlk geçiş alanları ihtiyaç oldukça genişletir, ikincisi sadece okur
+    double field_us = 0;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        field_us = run_queries(&map, from, to, count, goals, queries, &field_total);
+        NavStats now;
+        navmap_get_stats(&map, &now);
+        printf("  field pass %d: %.3f us per query over %d queries, %lu cells labelled, peak %.1f MB for %lu fields\n",
+               pass + 1, field_us, queries, now.field_expanded - stats.field_expanded,
+               now.field_peak_bytes / (1024.0 * 1024.0), now.fields);
+        stats = now;
+    }
+    long long check;
+    run_queries(&map, from, to, count, goals, astar_queries, &check);
+    if (check != astar_total)
+        printf("  mismatch: field costs %lld, A* costs %lld\n", check, astar_total);
+
+    Coordinate next;
+    int steps = 0;
+    started = now_ms();
+    for (int q = 0; q < queries; q++)
+        steps += navmap_next_step(&map, from[q % count], to[q % goals], &next) > 0;
+    printf("  next step: %.3f us per query (%d of %d en route)\n", (now_ms() - started) * 1000.0 / queries, steps,
+           queries);
+    // Bir alan, hedefe giden kaç önbellekli yol kadar yer tutar
+    double path_cells = (double)astar_total / astar_queries;
+    printf("  fields answer %.0fx faster than A*; one field costs as much memory as %.0f cached paths of %.0f cells\n",
+           astar_us / field_us, (double)size * size * sizeof(uint16_t) / (path_cells * sizeof(Coordinate)), path_cells);
+    navmap_destroy(&map);
+    free(from);
+    free(to);
+    return 0;
+}
+
+typedef struct
+{
+    List *list;        // NULL ise queue
+    MpscQueue *queue;
+    int items;
+    int id;
+    double push_ns;    // Üreticinin ekleme başına harcadığı ortalama süre
+    pthread_barrier_t *start;
+} Producer;
+
+static void *produce(void *arg)
+{
+    Producer *p = arg;
+    pthread_barrier_wait(p->start);
+    double started = now_ms();
+    for (int i = 0; i < p->items; i++)
+    {
+        // Veri NULL olamaz: (üretici, sıra) çifti 1'den başlayan tamsayıya kodlanır
+        void *data = (void *)(uintptr_t)((uint64_t)p->id << 32 | (uint64_t)(i + 1));
+        if (p->list)
+            add_list(p->list, data);
+        else
+            while (!mpsc_push(p->queue, data))
+                ;
+    }
+    p->push_ns = (now_ms() - started) * 1e6 / p->items;
+    return NULL;
+}
+
+// producers thread'i items'ar eleman ekler; tüketici (bu thread) hepsini çeker.
+// Geçen süreyi döndürür; sıra ihlali (üretici başına FIFO) order_errors'a yazılır.
+static double run_intake(bool lock_free, int producers, int items, double *push_ns, int *order_errors)
+{
+    List *list = lock_free ? NULL : create_list();
+    MpscQueue queue;
+    mpsc_init(&queue);
+    Producer *p = calloc((size_t)producers, sizeof(Producer));
+    pthread_t *tids = calloc((size_t)producers, sizeof(pthread_t));
+    int *last = calloc((size_t)producers, sizeof(int));
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, (unsigned)producers + 1);
+    for (int i = 0; i < producers; i++)
+    {
+        p[i] = (Producer){list, &queue, items, i, 0.0, &start};
+        pthread_create(&tids[i], NULL, produce, &p[i]);
+    }
+    pthread_barrier_wait(&start);
+    double started = now_ms();
+    *order_errors = 0;
+    for (long got = 0; got < (long)producers * items; got++)
+    {
+        void *data;
+        if (list)
+            data = pop_list(list);
+        else
+            while ((data = mpsc_pop(&queue)) == NULL)
+                sched_yield();
+        uint64_t v = (uint64_t)(uintptr_t)data;
+        int id = (int)(v >> 32), seq = (int)(v & 0xffffffffu);
+        if (seq <= last[id])
+            (*order_errors)++;
+        last[id] = seq;
+    }
+    double elapsed = now_ms() - started;
+    *push_ns = 0;
+    for (int i = 0; i < producers; i++)
+    {
+        pthread_join(tids[i], NULL);
+        *push_ns += p[i].push_ns / producers;
+    }
+    pthread_barrier_destroy(&start);
+    if (list)
+        destroy_list(list, NULL);
+    mpsc_destroy(&queue, NULL);
+    free(p);
+    free(tids);
+    free(last);
+    return elapsed;
+}
+
+static int bench_mpsc(int argc, char **argv)
+{
+    int producers = argc > 2 ? atoi(argv[2]) : 16;
+    int items = argc > 3 ? atoi(argv[3]) : 200000;
+    if (producers < 1 || items < 1)
+    {
+        fprintf(stderr, "Usage: %s mpsc [producers] [items per producer]\n", argv[0]);
+        return 1;
+    }
+    printf("Event intake, %d producers x %d items, 1 consumer:\n", producers, items);
+    for (int lock_free = 0; lock_free < 2; lock_free++)
+    {
+        double push_ns;
+        int order_errors;
+        double ms = run_intake(lock_free, producers, items, &push_ns, &order_errors);
+        // add_list başa ekler ve pop_list baştan alır: List LIFO'dur, sıra denetimi anlamsız
+        printf("  %-22s %8.1f ms, %6.2f M events/s, %7.1f ns per push", lock_free ? "mpsc_push/mpsc_pop" : "add_list/pop_list",
+               ms, (double)producers * items / ms / 1000.0, push_ns);
+        if (lock_free)
+            printf(", %d per-producer order violations", order_errors);
+        printf("\n");
+    }
+    return 0;
+}
+
+typedef struct
+{
+    bool pool;
+    int ops;
+    unsigned seed;
+    double ns; // Ayırma + bırakma çifti başına
+    pthread_barrier_t *start;
+} Churner;
+
+// 1024 survivor'lık çalışma kümesinde rastgele birini bırakıp yenisini ayırır:
+// survivor üreteci ve kurtarma akışının bellek deseni.
+static void *churn(void *arg)
+{
+    enum { WORKING_SET = 1024 };
+    Churner *c = arg;
+    Survivor *live[WORKING_SET];
+    for (int i = 0; i < WORKING_SET; i++)
+        live[i] = c->pool ? create_survivor(i, 0, 0, 1) : malloc(sizeof(Survivor));
+    pthread_barrier_wait(c->start);
+    double started = now_ms();
+    for (int i = 0; i < c->ops; i++)
+    {
+        int k = (int)(rand_r(&c->seed) % WORKING_SET);
+        if (c->pool)
+        {
+            free_survivor(live[k]);
+            live[k] = create_survivor(i, k, k, 1);
+        }
+        else
+        {
+            free(live[k]);
+            live[k] = malloc(sizeof(Survivor));
+            live[k]->id = i; // create_survivor kadar dokunsun
+        }
+    }
+    c->ns = (now_ms() - started) * 1e6 / c->ops;
+    for (int i = 0; i < WORKING_SET; i++)
+        c->pool ? free_survivor(live[i]) : free(live[i]);
+    return NULL;
+}
+
+typedef struct
+{
+    bool pool;
+    int items;
+    MpscQueue *queue;
+    pthread_barrier_t *start;
+} Handoff;
+
+static void *handoff_produce(void *arg)
+{
+    Handoff *h = arg;
+    pthread_barrier_wait(h->start);
+    for (int i = 0; i < h->items; i++)
+    {
+        Survivor *s = h->pool ? create_survivor(i, 0, 0, 1) : malloc(sizeof(Survivor));
+        s->id = i;
+        while (!mpsc_push(h->queue, s))
+            ;
+    }
+    return NULL;
+}
+
+// Üreticiler ayırır, tek tüketici bırakır (üreteç -> controller akışı). Olay başına ns.
+static double run_handoff(bool pool, int producers, int items)
+{
+    MpscQueue queue;
+    mpsc_init(&queue);
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, (unsigned)producers + 1);
+    Handoff h = {pool, items, &queue, &start};
+    pthread_t *tids = calloc((size_t)producers, sizeof(pthread_t));
+    for (int i = 0; i < producers; i++)
+        pthread_create(&tids[i], NULL, handoff_produce, &h);
+    pthread_barrier_wait(&start);
+    double started = now_ms();
+    for (long got = 0; got < (long)producers * items; got++)
+    {
+        Survivor *s;
+        while ((s = mpsc_pop(&queue)) == NULL)
+            sched_yield();
+        pool ? free_survivor(s) : free(s);
+    }
+    double ns = (now_ms() - started) * 1e6 / ((double)producers * items);
+    for (int i = 0; i < producers; i++)
+        pthread_join(tids[i], NULL);
+    pthread_barrier_destroy(&start);
+    free(tids);
+    return ns;
+}
+
+static int bench_alloc(int argc, char **argv)
+{
+    int threads = argc > 2 ? atoi(argv[2]) : 4;
+    int ops = argc > 3 ? atoi(argv[3]) : 2000000;
+    if (threads < 1 || ops < 1)
+    {
+        fprintf(stderr, "Usage: %s alloc [threads] [ops per thread]\n", argv[0]);
+        return 1;
+    }
+    printf("Survivor churn, %d threads x %d free+alloc pairs, 1024 live per thread:\n", threads, ops);
+    for (int pool = 0; pool < 2; pool++)
+    {
+        Churner *c = calloc((size_t)threads, sizeof(Churner));
+        pthread_t *tids = calloc((size_t)threads, sizeof(pthread_t));
+        pthread_barrier_t start;
+        pthread_barrier_init(&start, NULL, (unsigned)threads);
+        for (int i = 0; i < threads; i++)
+        {
+            c[i] = (Churner){pool, ops, (unsigned)(i + 1) * 2654435761u, 0.0, &start};
+            pthread_create(&tids[i], NULL, churn, &c[i]);
+        }
+        double ns = 0;
+        for (int i = 0; i < threads; i++)
+        {
+            pthread_join(tids[i], NULL);
+            ns += c[i].ns / threads;
+        }
+        pthread_barrier_destroy(&start);
+        // Hedef yük dakikada 10k survivor: oluşturma + kurtarma çifti başına maliyetle
+        printf("  %-12s %6.1f ns per pair, %.4f ms of CPU per minute at 10k survivors/min\n",
+               pool ? "slab pool" : "malloc/free", ns, ns * 10000 / 1e6);
+        free(c);
+        free(tids);
+    }
+    printf("Cross-thread handoff, %d producers allocate, 1 consumer frees:\n", threads);
+    for (int pool = 0; pool < 2; pool++)
+        printf("  %-12s %6.1f ns per survivor\n", pool ? "slab pool" : "malloc/free",
+               run_handoff(pool, threads, ops / 4));
+    SlabStats stats[SLAB_MAX_POOLS];
+    int pools = slab_get_stats(stats, SLAB_MAX_POOLS);
+    for (int i = 0; i < pools; i++)
+        if (strcmp(stats[i].name, "survivor") == 0)
+            printf("  pool: %lu allocs, %lu slabs (%.0f KB), %lu refills, %lu flushes (lock taken on %.2f%% of ops)\n",
+                   stats[i].allocs, stats[i].slabs, stats[i].bytes / 1024.0, stats[i].refills, stats[i].flushes,
+                   100.0 * (stats[i].refills + stats[i].flushes) / (stats[i].allocs + stats[i].frees));
+    return 0;
+}
+
+typedef struct
+{
+    List *list; // NULL ise map
+    HashMap *map;
+    int entries;
+    int lookups;
+    unsigned seed;
+    double ns;
+    pthread_barrier_t *start;
+} Looker;
+
+static int compare_survivor_id(void *data, void *key)
+{
+    return ((Survivor *)data)->id != *(int *)key;
+}
+
+// Eski sunucudaki gibi: listenin kilidi tutularak ID eşleşmesine kadar tarama.
+static Survivor *list_find(List *list, int id)
+{
+    pthread_mutex_lock(&list->lock);
+    Node *node = list->head;
+    while (node && compare_survivor_id(node->data, &id) != 0)
+        node = node->next;
+    pthread_mutex_unlock(&list->lock);
+    return node ? node->data : NULL;
+}
+
+static void *look_up(void *arg)
+{
+    Looker *l = arg;
+    int found = 0;
+    pthread_barrier_wait(l->start);
+    double started = now_ms();
+    for (int i = 0; i < l->lookups; i++)
+    {
+        int id = (int)(rand_r(&l->seed) % (unsigned)l->entries);
+        found += (l->list ? list_find(l->list, id) : get_hashmap(l->map, (uint64_t)id)) != NULL;
+    }
+    l->ns = (now_ms() - started) * 1e6 / l->lookups;
+    if (found != l->lookups)
+        fprintf(stderr, "lookup missed %d of %d ids\n", l->lookups - found, l->lookups);
+    return NULL;
+}
+
+static double run_lookups(List *list, HashMap *map, int entries, int threads, int lookups)
+{
+    Looker *l = calloc((size_t)threads, sizeof(Looker));
+    pthread_t *tids = calloc((size_t)threads, sizeof(pthread_t));
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, (unsigned)threads);
+    for (int i = 0; i < threads; i++)
+    {
+        l[i] = (Looker){list, map, entries, lookups, (unsigned)(i + 1) * 2654435761u, 0.0, &start};
+        pthread_create(&tids[i], NULL, look_up, &l[i]);
+    }
+    double ns = 0;
+    for (int i = 0; i < threads; i++)
+    {
+        pthread_join(tids[i], NULL);
+        ns += l[i].ns / threads;
+    }
+    pthread_barrier_destroy(&start);
+    free(l);
+    free(tids);
+    return ns;
+}
+
+static int bench_map(int argc, char **argv)
+{
+    int threads = argc > 2 ? atoi(argv[2]) : 4;
+    int lookups = argc > 3 ? atoi(argv[3]) : 1000000;
+    if (threads < 1 || lookups < 1)
+    {
+        fprintf(stderr, "Usage: %s map [threads] [lookups per thread]\n", argv[0]);
+        return 1;
+    }
+    printf("Lookup by id, %d threads:\n", threads);
+    for (int entries = 100; entries <= 100000; entries *= 10)
+    {
+        List *list = create_list();
+        HashMap *map = create_hashmap();
+        Survivor **all = malloc((size_t)entries * sizeof(Survivor *));
+        if (!list || !map || !all)
+            return 1;
+        for (int j = 0; j < entries; j++)
+        {
+            all[j] = create_survivor(j, 0, 0, 1);
+            add_list(list, all[j]);
+            put_hashmap(map, (uint64_t)j, all[j]);
+        }
+        // Liste taraması O(n): toplam süre sabit kalsın diye arama sayısı n ile azalır
+        int list_lookups = lookups / (entries / 100);
+        if (list_lookups < 100)
+            list_lookups = 100;
+        double list_ns = run_lookups(list, NULL, entries, threads, list_lookups);
+        double map_ns = run_lookups(NULL, map, entries, threads, lookups);
+        printf("  %6d entries: list %10.1f ns, hash map %6.1f ns per lookup (%.0fx)\n", entries, list_ns, map_ns,
+               list_ns / map_ns);
+        destroy_list(list, NULL);
+        destroy_hashmap(map, NULL);
+        for (int j = 0; j < entries; j++)
+            free_survivor(all[j]);
+        free(all);
+    }
+    return 0;
+}
+
+#define TELEMETRY_DRONES 64
+#define TELEMETRY_HOLD_US 200 // Görev atamasının drone kilidini tuttuğu süre (yol arama dahil)
+
+typedef struct
+{
+    Drone **drones;
+    bool seqlock;
+    int updates;           // Yazıcı: yapılacak güncelleme; okuyucu ve görev thread'i için 0
+    bool *done;            // Yazıcı bitince (atomik)
+    double ns;             // Yazıcı: güncelleme başına, okuyucu: görüntü başına
+    double max_us;         // Yazıcı: en uzun tek güncelleme
+    unsigned long count;
+    pthread_barrier_t *start;
+} TelemetryWorker;
+
+static void *telemetry_writer(void *arg)
+{
+    TelemetryWorker *w = arg;
+    pthread_barrier_wait(w->start);
+    double started = now_ms();
+    for (int i = 0; i < w->updates; i++)
+    {
+        Drone *d = w->drones[i % TELEMETRY_DRONES];
+        DroneTelemetry t = {.coord = {i % 40, i % 60}, .status = i & 1 ? ON_MISSION : IDLE, .battery = 100 - i % 100};
+        double t0 = now_ms();
+        if (w->seqlock)
+            drone_store_telemetry(d, &t, DRONE_TELEMETRY_ALL);
+        else
+        { // Eski yol: her STATUS_UPDATE drone kilidini alır
+            pthread_mutex_lock(&d->lock);
+            d->coord = t.coord;
+            d->status = t.status;
+            d->battery = t.battery;
+            pthread_mutex_unlock(&d->lock);
+        }
+        double us = (now_ms() - t0) * 1000;
+        if (us > w->max_us)
+            w->max_us = us;
+    }
+    w->ns = (now_ms() - started) * 1e6 / w->updates;
+    __atomic_store_n(w->done, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void *telemetry_reader(void *arg)
+{
+    TelemetryWorker *w = arg;
+    long sum = 0;
+    pthread_barrier_wait(w->start);
+    double started = now_ms();
+    while (!__atomic_load_n(w->done, __ATOMIC_ACQUIRE))
+    {
+        for (int i = 0; i < TELEMETRY_DRONES; i++)
+        {
+            Drone *d = w->drones[i];
+            DroneTelemetry t;
+            if (w->seqlock)
+                drone_load_telemetry(d, &t);
+            else
+            {
+                pthread_mutex_lock(&d->lock);
+                t = (DroneTelemetry){d->coord, d->status, d->battery};
+                pthread_mutex_unlock(&d->lock);
+            }
+            sum += t.battery;
+        }
+        w->count++;
+    }
+    w->ns = (now_ms() - started) * 1e6 / (w->count ? w->count : 1);
+    return (void *)sum;
+}
+
+// Controller gibi: drone kilidini tutarak görev atar; yazıcı eski yolda bunu bekler.
+static void *telemetry_mission(void *arg)
+{
+    TelemetryWorker *w = arg;
+    pthread_barrier_wait(w->start);
+    for (int i = 0; !__atomic_load_n(w->done, __ATOMIC_ACQUIRE); i++)
+    {
+        Drone *d = w->drones[i % TELEMETRY_DRONES];
+        pthread_mutex_lock(&d->lock);
+        double until = now_ms() + TELEMETRY_HOLD_US / 1000.0;
+        while (now_ms() < until)
+            ;
+        if (w->seqlock)
+            drone_store_telemetry(d, &(DroneTelemetry){.status = ON_MISSION}, DRONE_TELEMETRY_STATUS);
+        else
+            d->status = ON_MISSION;
+        pthread_mutex_unlock(&d->lock);
+        w->count++;
+        nanosleep(&(struct timespec){0, 1000000}, NULL); // Atamalar arasında 1 ms
+    }
+    return NULL;
+}
+
+static int bench_telemetry(int argc, char **argv)
+{
+    int readers = argc > 2 ? atoi(argv[2]) : 2;
+    int updates = argc > 3 ? atoi(argv[3]) : 500000;
+    if (readers < 0 || updates < 1)
+    {
+        fprintf(stderr, "Usage: %s telemetry [readers] [updates]\n", argv[0]);
+        return 1;
+    }
+    Drone *drones[TELEMETRY_DRONES];
+    for (int i = 0; i < TELEMETRY_DRONES; i++)
+        drones[i] = create_drone(i, -1, -1);
+    printf("%d drones, 1 status writer (%d updates), %d snapshot readers, 1 mission thread holding a drone lock "
+           "%d us per assignment:\n", TELEMETRY_DRONES, updates, readers, TELEMETRY_HOLD_US);
+    for (int mode = 0; mode < 2; mode++)
+    {
+        int threads = readers + 2;
+        bool done = false;
+        TelemetryWorker *w = calloc((size_t)threads, sizeof(TelemetryWorker));
+        pthread_t *tids = calloc((size_t)threads, sizeof(pthread_t));
+        pthread_barrier_t start;
+        pthread_barrier_init(&start, NULL, (unsigned)threads);
+        for (int i = 0; i < threads; i++)
+        {
+            w[i] = (TelemetryWorker){drones, mode == 1, i == 0 ? updates : 0, &done, 0.0, 0.0, 0, &start};
+            pthread_create(&tids[i], NULL, i == 0 ? telemetry_writer : i == 1 ? telemetry_mission : telemetry_reader,
+                           &w[i]);
+        }
+        double reader_ns = 0;
+        unsigned long snapshots = 0;
+        for (int i = 0; i < threads; i++)
+        {
+            pthread_join(tids[i], NULL);
+            if (i >= 2)
+            {
+                reader_ns += w[i].ns / readers;
+                snapshots += w[i].count;
+            }
+        }
+        pthread_barrier_destroy(&start);
+        printf("  %-10s update %7.1f ns (max %8.1f us), fleet snapshot %8.1f ns, %lu snapshots, %lu assignments\n",
+               mode ? "seqlock" : "drone lock", w[0].ns, w[0].max_us, reader_ns, snapshots, w[1].count);
+        free(w);
+        free(tids);
+    }
+    for (int i = 0; i < TELEMETRY_DRONES; i++)
+        free_drone(drones[i]);
+    return 0;
+}
+
+// Eski yol: Node zincirini gezip her survivor'ı double SURVGRID_SCORE ile skorlar.
+static Survivor *list_best(const List *list, Coordinate pos, time_t now, double *score)
+{
+    Survivor *best = NULL;
+    for (const Node *node = list->head; node; node = node->next)
+    {
+        Survivor *s = node->data;
+        if (s->is_targeted)
+            continue;
+        double sc = SURVGRID_SCORE(s->priority, now - s->creation_time, manhattan(pos.x, pos.y, s->coord.x, s->coord.y));
+        if (!best || sc > *score)
+        {
+            best = s;
+            *score = sc;
+        }
+    }
+    return best;
+}
+
+static int bench_soa(int argc, char **argv)
+{
+    int n = argc > 2 ? atoi(argv[2]) : 100000;
+    int drones = argc > 3 ? atoi(argv[3]) : 64;
+    if (n < 1 || drones < 1)
+    {
+        fprintf(stderr, "Usage: %s soa [survivors] [drones]\n", argv[0]);
+        return 1;
+    }
+    srand(11);
+    time_t now = time(NULL);
+    Survivor **all = malloc((size_t)n * sizeof(Survivor *));
+    Coordinate *pos = malloc((size_t)drones * sizeof(Coordinate));
+    int32_t *row = malloc((size_t)n * sizeof(int32_t));
+    List *list = create_list();
+    SurvivorTable table;
+    if (!all || !pos || !row || !list || !survtab_init(&table, n))
+        return 1;
+    for (int j = 0; j < n; j++)
+    {
+        all[j] = create_survivor(j, rand() % BIG_MAP, rand() % BIG_MAP, 1 + rand() % 5);
+        all[j]->creation_time = now - rand() % 600;
+        all[j]->is_targeted = rand() % 10 == 0; // Onda biri yolda: maske de ölçülsün
+        survtab_insert(&table, all[j]);
+    }
+    for (int j = n - 1; j >= 0; j--) // add_list başa ekler: liste sırası slot sırası olsun
+        add_list(list, all[j]);
+    for (int i = 0; i < drones; i++)
+        pos[i] = (Coordinate){rand() % BIG_MAP, rand() % BIG_MAP};
+
+    int targeted = 0;
+    for (int j = 0; j < n; j++)
+        targeted += all[j]->is_targeted;
+    printf("Best survivor for %d drones over %d survivors (%d targeted):\n", drones, n, targeted);
+    Survivor **expect = malloc((size_t)drones * sizeof(Survivor *));
+    double *expect_score = malloc((size_t)drones * sizeof(double));
+    double t0 = now_ms();
+    for (int i = 0; i < drones; i++)
+        expect[i] = list_best(list, pos[i], now, &expect_score[i]);
+    double list_ns = (now_ms() - t0) * 1e6 / ((double)drones * n);
+    printf("  %-14s %6.2f ns per survivor\n", "linked list", list_ns);
+
+    SurvtabKernel best_kernel = survtab_best_kernel();
+    for (int k = SURVTAB_SCALAR; k <= SURVTAB_AVX2; k++)
+    {
+        if (survtab_use_kernel((SurvtabKernel)k) != (SurvtabKernel)k)
+        {
+            printf("  %-14s not supported by this CPU\n", survtab_kernel_name((SurvtabKernel)k));
+            continue;
+        }
+        int mismatches = 0;
+        t0 = now_ms();
+        for (int i = 0; i < drones; i++)
+        {
+            int32_t score;
+            int slot = survtab_best(&table, pos[i], now, &score);
+            Survivor *got = slot < 0 ? NULL : table.owner[slot];
+            mismatches += got != expect[i] || (got && score != (int32_t)expect_score[i]);
+        }
+        double best_ns = (now_ms() - t0) * 1e6 / ((double)drones * n);
+        t0 = now_ms();
+        for (int i = 0; i < drones; i++)
+            survtab_score(&table, pos[i], now, row);
+        double row_ns = (now_ms() - t0) * 1e6 / ((double)drones * n);
+        for (int j = 0; j < n; j++) // Son satırı tek tek doğrula
+        {
+            const Survivor *s = all[j];
+            int32_t want = s->is_targeted ? INT32_MIN
+                                          : (int32_t)SURVGRID_SCORE(s->priority, now - s->creation_time,
+                                                                    manhattan(pos[drones - 1].x, pos[drones - 1].y,
+                                                                              s->coord.x, s->coord.y));
+            mismatches += row[s->table_slot] != want;
+        }
+        printf("  %-14s %6.2f ns per survivor (%.1fx), full score row %6.2f ns per survivor, %d mismatches\n",
+               survtab_kernel_name((SurvtabKernel)k), best_ns, list_ns / best_ns, row_ns, mismatches);
+    }
+    survtab_use_kernel(best_kernel);
+    printf("  selected kernel: %s\n", survtab_kernel_name(best_kernel));
+
+    destroy_list(list, NULL);
+    survtab_destroy(&table);
+    for (int j = 0; j < n; j++)
+        free_survivor(all[j]);
+    free(all);
+    free(pos);
+    free(row);
+    free(expect);
+    free(expect_score);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "assign") == 0)
+        return bench_assign(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "region") == 0)
+        return bench_region(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "route") == 0)
+        return bench_route(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "path") == 0)
+        return bench_path(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "field") == 0)
+        return bench_field(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "mpsc") == 0)
+        return bench_mpsc(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "alloc") == 0)
+        return bench_alloc(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "soa") == 0)
+        return bench_soa(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "map") == 0)
+        return bench_map(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "telemetry") == 0)
+        return bench_telemetry(argc, argv);
+    fprintf(stderr, "Usage: %s assign [drones] [survivors]\n"
+                    "       %s region [drones] [survivors] [workers]\n"
+                    "       %s route [stops] [trials]\n"
+                    "       %s path [size] [drones] [goals]\n"
+                    "       %s field [size] [survivors] [queries]\n"
+                    "       %s mpsc [producers] [items]\n"
+                    "       %s alloc [threads] [ops]\n"
+                    "       %s soa [survivors] [drones]\n"
+                    "       %s map [threads] [lookups]\n"
+                    "       %s telemetry [readers] [updates]\n",
+            argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0]);
+    return 1;
+}
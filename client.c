@@ -1,3 +1,4 @@
+#define _POSIX_C_SOURCE 200809L // nanosleep
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -9,10 +10,43 @@
 #include <json-c/json.h>
 #include <time.h> // YENİ: time() için
 #include "drone.h"
+#include "protocol.h"
 
 #define SERVER_IP "127.0.0.1"
 #define PORT 8080
-#define PROCESS_BUFFER_SIZE (4096 * 2) // GÜNCELLENDİ: Buffer boyutu
+#define RECV_BUFFER_SIZE 4096
+#define STATUS_INTERVAL_MS 2000    // TCP üzerinden STATUS_UPDATE aralığı
+#define TELEMETRY_INTERVAL_MS 100  // UDP telemetri aralığı (10 Hz)
+
+// HANDSHAKE_ACK ikili çerçevelemeyi onaylarsa true olur; drone->lock altında okunur/yazılır.
+bool use_binary = false;
+// HANDSHAKE_ACK "telemetry" verirse STATUS_UPDATE bu UDP sokete gider; drone->lock altında.
+int udp_sock = -1;
+ProtoMessage telemetry = {.type = MSG_TELEMETRY}; // session, slot ve son seq
+
+// Drone'un sadece client'ın kullandığı uçuş durumu. Ortak Drone yapısı sunucu ve view
+// ile paylaşıldığından bu alanlar orada değil burada durur; drone->lock altında kullanılır.
+typedef struct
+{
+    Drone *drone;
+    Waypoints path;                         // Mevcut hedefe kadar kalan dönüş noktaları
+    Waypoints route_paths[ROUTE_MAX_STOPS]; // drone->route[i]'ye giden ayağın dönüş noktaları
+    Waypoints pending_path;                 // Sıradaki ASSIGN/QUEUE_MISSION'ı bekleyen WAYPOINT'ler
+    char mission_id[MISSION_ID_LEN];        // Mevcut hedefin mission_id'si, MISSION_COMPLETE'te geri gönderilir ("": yok)
+    char route_ids[ROUTE_MAX_STOPS][MISSION_ID_LEN]; // drone->route[i]'nin mission_id'si
+} ClientDrone;
+
+// Gateway modu: tek bağlantı ve iki thread (recv + simülasyon) birden çok drone taşır.
+// Sunucu mesajları drone_id'ye göre ilgili drone'a yönlendirilir.
+typedef struct
+{
+    ClientDrone *drones;
+    int count;
+    int sock;
+    int alive; // Bağlantı kapanınca 0; drone->sock 0 ise sadece o drone durmuştur
+} Gateway;
+
+Gateway *gateway = NULL;
 
 int connect_to_server()
 {
@@ -36,98 +70,234 @@ void send_json(int sock, json_object *jobj)
     send(sock, "\n", 1, 0); // Mesaj ayırıcı
 }
 
-void *navigate_to_target(void *arg)
+// Sunucunun shard'a özel telemetri portuna bağlı bir UDP soketi açar.
+int connect_telemetry(int port)
 {
-    Drone *d = (Drone *)arg;
-    int sock = d->sock;
-    int move_count = 0;
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0)
+        return -1;
+    struct sockaddr_in server_addr = {.sin_family = AF_INET, .sin_port = htons(port)};
+    inet_pton(AF_INET, SERVER_IP, &server_addr.sin_addr);
+    if (connect(sock, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0)
+    {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
 
-    while (d->sock > 0) // GÜNCELLENDİ: sock kontrolü
+void send_frame(int sock, const ProtoMessage *msg)
+{
+    if (sock <= 0)
+        return;
+    uint8_t frame[PROTO_MAX_FRAME];
+    size_t len = proto_encode(msg, frame, sizeof(frame));
+    if (len)
+        send(sock, frame, len, 0);
+}
+
+// Aşağıdaki report_* fonksiyonları d->lock tutularak çağrılır ve anlaşılan
+// protokole göre ikili çerçeve veya JSON gönderir.
+void report_battery_depleted(Drone *d, int sock)
+{
+    if (use_binary)
     {
-        pthread_mutex_lock(&d->lock);
-        if (d->battery <= 0)
+        ProtoMessage msg = {.type = MSG_BATTERY_DEPLETED, .drone_id = d->id};
+        send_frame(sock, &msg);
+        return;
+    }
+    json_object *jobj = json_object_new_object();
+    json_object_object_add(jobj, "type", json_object_new_string("BATTERY_DEPLETED"));
+    char drone_id_str[10];
+    snprintf(drone_id_str, sizeof(drone_id_str), "D%d", d->id);
+    json_object_object_add(jobj, "drone_id", json_object_new_string(drone_id_str));
+    json_object_object_add(jobj, "timestamp", json_object_new_int64(time(NULL))); // time_t için int64
+    send_json(sock, jobj);
+    json_object_put(jobj);
+}
+
+void report_mission_complete(ClientDrone *cd, int sock)
+{
+    Drone *d = cd->drone;
+    if (use_binary)
+    {
+        ProtoMessage msg = {.type = MSG_MISSION_COMPLETE, .drone_id = d->id,
+                            .x = d->target.x, .y = d->target.y, .success = 1};
+        send_frame(sock, &msg);
+        return;
+    }
+    json_object *jobj = json_object_new_object();
+    json_object_object_add(jobj, "type", json_object_new_string("MISSION_COMPLETE"));
+    char drone_id_str[10];
+    snprintf(drone_id_str, sizeof(drone_id_str), "D%d", d->id);
+    json_object_object_add(jobj, "drone_id", json_object_new_string(drone_id_str));
+    if (cd->mission_id[0]) // Sunucu görevi bununla kesin bulur; ikili çerçevede alan yok
+        json_object_object_add(jobj, "mission_id", json_object_new_string(cd->mission_id));
+    json_object_object_add(jobj, "timestamp", json_object_new_int64(time(NULL)));
+    json_object_object_add(jobj, "success", json_object_new_boolean(true));
+    json_object *completed_target_loc = json_object_new_object(); // YENİ: Hangi görevin tamamlandığı
+    json_object_object_add(completed_target_loc, "x", json_object_new_int(d->target.x));
+    json_object_object_add(completed_target_loc, "y", json_object_new_int(d->target.y));
+    json_object_object_add(jobj, "completed_target", completed_target_loc);
+    send_json(sock, jobj);
+    json_object_put(jobj);
+}
+
+void report_status(Drone *d, int sock)
+{
+    if (udp_sock >= 0)
+    { // Kayıp veya geç kalan datagram yeniden gönderilmez; bir sonraki zaten daha taze
+        telemetry.drone_id = d->id;
+        telemetry.seq++;
+        telemetry.x = d->coord.x;
+        telemetry.y = d->coord.y;
+        telemetry.battery = (uint16_t)(d->battery > 0 ? d->battery : 0);
+        telemetry.status = (uint8_t)d->status;
+        send_frame(udp_sock, &telemetry);
+        return;
+    }
+    if (use_binary)
+    { // ~150 bayt JSON yerine 20 baytlık sabit çerçeve
+        ProtoMessage msg = {.type = MSG_STATUS_UPDATE, .drone_id = d->id, .x = d->coord.x, .y = d->coord.y,
+                            .battery = (uint16_t)(d->battery > 0 ? d->battery : 0), .status = (uint8_t)d->status};
+        send_frame(sock, &msg);
+        return;
+    }
+    json_object *jobj = json_object_new_object();
+    json_object_object_add(jobj, "type", json_object_new_string("STATUS_UPDATE"));
+    char drone_id_str[10];
+    snprintf(drone_id_str, sizeof(drone_id_str), "D%d", d->id);
+    json_object_object_add(jobj, "drone_id", json_object_new_string(drone_id_str));
+    json_object_object_add(jobj, "timestamp", json_object_new_int64(time(NULL)));
+    json_object *loc = json_object_new_object();
+    json_object_object_add(loc, "x", json_object_new_int(d->coord.x));
+    json_object_object_add(loc, "y", json_object_new_int(d->coord.y));
+    json_object_object_add(jobj, "location", loc);
+    json_object_object_add(jobj, "status", json_object_new_string(d->status == IDLE ? "idle" : "busy"));
+    json_object_object_add(jobj, "battery", json_object_new_int(d->battery));
+    // json_object_object_add(jobj, "speed", json_object_new_int(5)); // İsteğe bağlı
+    send_json(sock, jobj);
+    json_object_put(jobj);
+}
+
+void report_heartbeat_ack(Drone *d, int sock)
+{
+    if (use_binary)
+    {
+        ProtoMessage msg = {.type = MSG_HEARTBEAT_ACK, .drone_id = d->id};
+        send_frame(sock, &msg);
+        return;
+    }
+    json_object *ack_jobj = json_object_new_object();
+    json_object_object_add(ack_jobj, "type", json_object_new_string("HEARTBEAT_ACK"));
+    char drone_id_ack_str[10];
+    snprintf(drone_id_ack_str, sizeof(drone_id_ack_str), "D%d", d->id);
+    json_object_object_add(ack_jobj, "drone_id", json_object_new_string(drone_id_ack_str));
+    json_object_object_add(ack_jobj, "timestamp", json_object_new_int64(time(NULL)));
+    send_json(sock, ack_jobj);
+    json_object_put(ack_jobj);
+}
+
+// Drone'u hedefine bir adım yaklaştırır; d->lock tutularak çağrılır. Pil bittiyse
+// sunucuya bildirir, d->sock'u 0 yapar ve false döner.
+bool step_drone(ClientDrone *cd, int sock, int *move_count)
+{
+    Drone *d = cd->drone;
+    if (d->battery <= 0)
+    {
+        d->status = IDLE; // Pili bitti, boşta
+        printf("Drone %d: Battery depleted, stopping mission.\n", d->id);
+        report_battery_depleted(d, sock);
+        d->sock = 0; // Tek drone modunda ana döngünün de sonlanması için
+        return false;
+    }
+
+    if (d->status == ON_MISSION)
+    {
+        // Sunucu engelli bir yol verdiyse önce dönüş noktalarından geçilir
+        Coordinate goal = cd->path.count > 0 ? cd->path.points[0] : d->target;
+        int moved = 0;
+        if (d->coord.x < goal.x)
         {
-            d->status = IDLE; // Pili bitti, boşta
-            printf("Drone %d: Battery depleted, stopping mission.\n", d->id);
-            json_object *jobj = json_object_new_object();
-            json_object_object_add(jobj, "type", json_object_new_string("BATTERY_DEPLETED"));
-            char drone_id_str[10];
-            snprintf(drone_id_str, sizeof(drone_id_str), "D%d", d->id);
-            json_object_object_add(jobj, "drone_id", json_object_new_string(drone_id_str));
-            json_object_object_add(jobj, "timestamp", json_object_new_int64(time(NULL))); // time_t için int64
-            send_json(sock, jobj);
-            json_object_put(jobj);
-            pthread_mutex_unlock(&d->lock);
-            // Pili biten drone'un thread'i burada sonlanabilir veya ana döngüde handle edilir.
-            // Şimdilik döngüyü kırıp thread'in sonlanmasını sağlıyoruz.
-            d->sock = 0; // Ana döngünün de sonlanması için
-            break;
+            d->coord.x++;
+            moved = 1;
+        }
+        else if (d->coord.x > goal.x)
+        {
+            d->coord.x--;
+            moved = 1;
         }
 
-        if (d->status == ON_MISSION)
+        // Sadece X ekseninde hedefteyse Y ekseninde hareket et
+        if (d->coord.x == goal.x)
         {
-            int moved = 0;
-            if (d->coord.x < d->target.x)
+            if (d->coord.y < goal.y)
             {
-                d->coord.x++;
+                d->coord.y++;
                 moved = 1;
             }
-            else if (d->coord.x > d->target.x)
+            else if (d->coord.y > goal.y)
             {
-                d->coord.x--;
+                d->coord.y--;
                 moved = 1;
             }
+        }
+        if (cd->path.count > 0 && d->coord.x == goal.x && d->coord.y == goal.y)
+        {
+            cd->path.count--;
+            memmove(cd->path.points, cd->path.points + 1, (size_t)cd->path.count * sizeof(Coordinate));
+        }
 
-            // Sadece X ekseninde hedefteyse Y ekseninde hareket et
-            if (d->coord.x == d->target.x)
-            {
-                if (d->coord.y < d->target.y)
-                {
-                    d->coord.y++;
-                    moved = 1;
-                }
-                else if (d->coord.y > d->target.y)
-                {
-                    d->coord.y--;
-                    moved = 1;
-                }
-            }
-
-            if (moved)
+        if (moved)
+        {
+            (*move_count)++;
+            if (*move_count >= DRONE_MOVES_PER_BATTERY)
             {
-                move_count++;
-                if (move_count >= 5)
-                {
-                    d->battery--;
-                    move_count = 0;
-                }
+                d->battery--;
+                *move_count = 0;
             }
+        }
 
-            // printf("Drone %d at (%d, %d), moving to (%d, %d), battery: %d\n",
-            //        d->id, d->coord.x, d->coord.y, d->target.x, d->target.y, d->battery);
+        // printf("Drone %d at (%d, %d), moving to (%d, %d), battery: %d\n",
+        //        d->id, d->coord.x, d->coord.y, d->target.x, d->target.y, d->battery);
 
-            if (d->coord.x == d->target.x && d->coord.y == d->target.y)
-            {
-                d->status = IDLE;
-                printf("Drone %d: Mission completed at (%d, %d)\n", d->id, d->target.x, d->target.y);
-                json_object *jobj = json_object_new_object();
-                json_object_object_add(jobj, "type", json_object_new_string("MISSION_COMPLETE"));
-                char drone_id_str[10];
-                snprintf(drone_id_str, sizeof(drone_id_str), "D%d", d->id);
-                json_object_object_add(jobj, "drone_id", json_object_new_string(drone_id_str));
-                // mission_id sunucudan gelmeli, şimdilik sabit veya yok.
-                // json_object_object_add(jobj, "mission_id", json_object_new_string("M123"));
-                json_object_object_add(jobj, "timestamp", json_object_new_int64(time(NULL)));
-                json_object_object_add(jobj, "success", json_object_new_boolean(true));
-                json_object *completed_target_loc = json_object_new_object(); // YENİ: Hangi görevin tamamlandığı
-                json_object_object_add(completed_target_loc, "x", json_object_new_int(d->target.x));
-                json_object_object_add(completed_target_loc, "y", json_object_new_int(d->target.y));
-                json_object_object_add(jobj, "completed_target", completed_target_loc);
-                send_json(sock, jobj);
-                json_object_put(jobj);
+        if (d->coord.x == d->target.x && d->coord.y == d->target.y)
+        {
+            d->status = IDLE;
+            printf("Drone %d: Mission completed at (%d, %d)\n", d->id, d->target.x, d->target.y);
+            report_mission_complete(cd, sock);
+            if (d->route_len > 0)
+            { // Rotanın sıradaki durağı: yeni atama beklemeden yola devam
+                d->target = d->route[0];
+                cd->path = cd->route_paths[0];
+                memcpy(cd->mission_id, cd->route_ids[0], MISSION_ID_LEN);
+                d->route_len--;
+                memmove(d->route, d->route + 1, (size_t)d->route_len * sizeof(Coordinate));
+                memmove(cd->route_paths, cd->route_paths + 1, (size_t)d->route_len * sizeof(Waypoints));
+                memmove(cd->route_ids, cd->route_ids + 1, (size_t)d->route_len * MISSION_ID_LEN);
+                d->status = ON_MISSION;
+                printf("Drone %d: Continuing to queued mission at (%d, %d), %d more stop(s)\n", d->id,
+                       d->target.x, d->target.y, d->route_len);
             }
         }
+    }
+    return true;
+}
+
+void *navigate_to_target(void *arg)
+{
+    ClientDrone *cd = (ClientDrone *)arg;
+    Drone *d = cd->drone;
+    int sock = d->sock;
+    int move_count = 0;
+
+    while (d->sock > 0) // GÜNCELLENDİ: sock kontrolü
+    {
+        pthread_mutex_lock(&d->lock);
+        bool active = step_drone(cd, sock, &move_count);
         pthread_mutex_unlock(&d->lock);
+        if (!active)
+            break; // Pili biten drone'un thread'i burada sonlanır
         sleep(1); // Saniyede 1 hareket
     }
     printf("Drone %d: Navigate thread exiting.\n", d->id);
@@ -147,37 +317,413 @@ void *send_status_update(void *arg)
             break;
         }
 
-        json_object *jobj = json_object_new_object();
-        json_object_object_add(jobj, "type", json_object_new_string("STATUS_UPDATE"));
-        char drone_id_str[10];
-        snprintf(drone_id_str, sizeof(drone_id_str), "D%d", d->id);
-        json_object_object_add(jobj, "drone_id", json_object_new_string(drone_id_str));
-        json_object_object_add(jobj, "timestamp", json_object_new_int64(time(NULL)));
-        json_object *loc = json_object_new_object();
-        json_object_object_add(loc, "x", json_object_new_int(d->coord.x));
-        json_object_object_add(loc, "y", json_object_new_int(d->coord.y));
-        json_object_object_add(jobj, "location", loc);
-        json_object_object_add(jobj, "status", json_object_new_string(d->status == IDLE ? "idle" : "busy"));
-        json_object_object_add(jobj, "battery", json_object_new_int(d->battery));
-        // json_object_object_add(jobj, "speed", json_object_new_int(5)); // İsteğe bağlı
-        send_json(sock, jobj);
-        json_object_put(jobj);
+        report_status(d, sock);
+        int interval_ms = udp_sock >= 0 ? TELEMETRY_INTERVAL_MS : STATUS_INTERVAL_MS;
 
         pthread_mutex_unlock(&d->lock);
-        // sleep(5); // Daha sık güncelleme, örn. 2 saniyede bir
-        sleep(2);
+        struct timespec ts = {.tv_sec = interval_ms / 1000, .tv_nsec = (long)(interval_ms % 1000) * 1000000};
+        nanosleep(&ts, NULL);
     }
     printf("Drone %d: Status update thread exiting.\n", d->id);
     return NULL;
 }
 
+// Gateway'in tüm drone'larının durumunu tek çerçevede gönderir. İkili protokol
+// anlaşılmadıysa drone başına JSON STATUS_UPDATE'e düşer.
+void report_gateway_status(Gateway *gw)
+{
+    ProtoMessage batch[PROTO_MAX_BATCH];
+    uint8_t frame[PROTO_BATCH_FRAME_SIZE(PROTO_MAX_BATCH)];
+    size_t n = 0;
+    for (int i = 0; i < gw->count; i++)
+    {
+        Drone *d = gw->drones[i].drone;
+        pthread_mutex_lock(&d->lock);
+        if (d->sock > 0 && !use_binary)
+            report_status(d, gw->sock);
+        else if (d->sock > 0)
+            batch[n++] = (ProtoMessage){.type = MSG_STATUS_UPDATE, .drone_id = d->id, .x = d->coord.x,
+                                        .y = d->coord.y, .battery = (uint16_t)(d->battery > 0 ? d->battery : 0),
+                                        .status = (uint8_t)d->status};
+        pthread_mutex_unlock(&d->lock);
+        if (n == PROTO_MAX_BATCH || (n > 0 && i == gw->count - 1))
+        {
+            size_t len = proto_encode_status_batch(batch, n, frame, sizeof(frame));
+            if (len)
+                send(gw->sock, frame, len, 0);
+            n = 0;
+        }
+    }
+}
+
+// Gateway simülasyon thread'i: her saniye tüm drone'ları ilerletir, STATUS_INTERVAL_MS'de
+// bir durumlarını toplu gönderir. Drone başına iki thread yerine tek thread.
+void *gateway_loop(void *arg)
+{
+    Gateway *gw = (Gateway *)arg;
+    int *move_counts = calloc(gw->count, sizeof(int));
+    int ticks = 0;
+    while (gw->alive && move_counts)
+    {
+        for (int i = 0; i < gw->count; i++)
+        {
+            Drone *d = gw->drones[i].drone;
+            pthread_mutex_lock(&d->lock);
+            if (d->sock > 0)
+                step_drone(&gw->drones[i], gw->sock, &move_counts[i]);
+            pthread_mutex_unlock(&d->lock);
+        }
+        if (ticks++ % (STATUS_INTERVAL_MS / 1000) == 0)
+            report_gateway_status(gw);
+        sleep(1); // Saniyede 1 hareket
+    }
+    free(move_counts);
+    printf("Gateway: Simulation thread exiting.\n");
+    return NULL;
+}
+
+// Gateway modunda mesajın hedeflediği drone; tek drone modunda her zaman kendisi.
+ClientDrone *route_drone(ClientDrone *cd, int id)
+{
+    if (!gateway)
+        return cd;
+    for (int i = 0; i < gateway->count; i++)
+    {
+        if (gateway->drones[i].drone->id == id)
+            return &gateway->drones[i];
+    }
+    return NULL;
+}
+
+// Heartbeat'i hâlâ kayıtlı bir drone adına yanıtla (gateway'de ilk drone düşmüş olabilir).
+ClientDrone *heartbeat_drone(ClientDrone *cd)
+{
+    if (!gateway)
+        return cd;
+    for (int i = 0; i < gateway->count; i++)
+    {
+        if (gateway->drones[i].drone->sock > 0)
+            return &gateway->drones[i];
+    }
+    return cd;
+}
+
+// ASSIGN_MISSION: mevcut hedefin yerine geçer; sunucu varsa rotadaki durakları da iptal etmiştir.
+// Mesajdan önce gelen dönüş noktaları bu ayağın yoludur. mission_id MISSION_COMPLETE'te
+// geri gönderilir (ikili çerçevede yok: NULL). drone->lock tutularak çağrılır.
+void start_mission(ClientDrone *cd, int x, int y, const char *mission_id)
+{
+    Drone *drone = cd->drone;
+    drone->target.x = x;
+    drone->target.y = y;
+    snprintf(cd->mission_id, sizeof(cd->mission_id), "%s", mission_id ? mission_id : "");
+    cd->path = cd->pending_path;
+    cd->pending_path.count = 0;
+    drone->route_len = 0;
+    drone->status = ON_MISSION;
+    printf("Drone %d: Assigned mission to (%d, %d)\n", drone->id, drone->target.x, drone->target.y);
+}
+
+// QUEUE_MISSION: rotanın sonuna eklenen durak; duraklar geliş sırasıyla gezilir ve
+// her biri ayrı MISSION_COMPLETE ile bildirilir. Mesaj geldiğinde görev zaten
+// bittiyse (sunucu tamamlamayı henüz görmemişti) hemen başlanır.
+void queue_mission(ClientDrone *cd, int x, int y, const char *mission_id)
+{
+    Drone *drone = cd->drone;
+    if (drone->status != ON_MISSION)
+    {
+        start_mission(cd, x, y, mission_id);
+        return;
+    }
+    if (drone->route_len == ROUTE_MAX_STOPS)
+    {
+        fprintf(stderr, "Drone %d: Route full, dropping stop (%d, %d).\n", drone->id, x, y);
+        cd->pending_path.count = 0;
+        return;
+    }
+    drone->route[drone->route_len].x = x;
+    drone->route[drone->route_len].y = y;
+    cd->route_paths[drone->route_len] = cd->pending_path; // Önceki duraktan bu durağa
+    snprintf(cd->route_ids[drone->route_len], MISSION_ID_LEN, "%s", mission_id ? mission_id : "");
+    cd->pending_path.count = 0;
+    drone->route_len++;
+    printf("Drone %d: Queued stop %d at (%d, %d)\n", drone->id, drone->route_len, x, y);
+}
+
+void handle_server_json(ClientDrone *cd, int sock, json_object *jobj)
+{
+    Drone *drone = cd->drone;
+    json_object *type_obj = json_object_object_get(jobj, "type");
+    const char *type_str = type_obj ? json_object_get_string(type_obj) : NULL;
+    if (!type_str)
+    {
+        fprintf(stderr, "Drone %d: Received JSON without 'type' field.\n", drone->id);
+        return;
+    }
+
+    if (strcmp(type_str, "ASSIGN_MISSION") == 0 || strcmp(type_str, "QUEUE_MISSION") == 0)
+    {
+        const char *id_str = json_object_get_string(json_object_object_get(jobj, "drone_id"));
+        cd = route_drone(cd, id_str ? atoi(id_str + (id_str[0] == 'D')) : -1);
+        if (!cd)
+            return;
+        drone = cd->drone;
+        pthread_mutex_lock(&drone->lock);
+        json_object *target_json_obj = json_object_object_get(jobj, "target");
+        json_object *waypoints = json_object_object_get(jobj, "waypoints");
+        cd->pending_path.count = 0;
+        for (size_t i = 0; waypoints && i < json_object_array_length(waypoints) && i < MISSION_MAX_WAYPOINTS; i++)
+        {
+            json_object *point = json_object_array_get_idx(waypoints, i);
+            cd->pending_path.points[i].x = json_object_get_int(json_object_object_get(point, "x"));
+            cd->pending_path.points[i].y = json_object_get_int(json_object_object_get(point, "y"));
+            cd->pending_path.count++;
+        }
+        if (target_json_obj)
+        {
+            int x = json_object_get_int(json_object_object_get(target_json_obj, "x"));
+            int y = json_object_get_int(json_object_object_get(target_json_obj, "y"));
+            const char *mission_id = json_object_get_string(json_object_object_get(jobj, "mission_id"));
+            if (type_str[0] == 'Q')
+                queue_mission(cd, x, y, mission_id);
+            else
+                start_mission(cd, x, y, mission_id);
+        }
+        else
+        {
+            fprintf(stderr, "Drone %d: %s message missing 'target'.\n", drone->id, type_str);
+        }
+        pthread_mutex_unlock(&drone->lock);
+    }
+    else if (strcmp(type_str, "HEARTBEAT") == 0) // YENİ: Sunucudan HEARTBEAT alındı
+    {
+        // printf("Drone %d: Received HEARTBEAT from server.\n", drone->id);
+        drone = heartbeat_drone(cd)->drone;
+        pthread_mutex_lock(&drone->lock);
+        report_heartbeat_ack(drone, sock);
+        pthread_mutex_unlock(&drone->lock);
+    }
+    else if (strcmp(type_str, "HANDSHAKE_ACK") == 0)
+    {
+        const char *protocol = json_object_get_string(json_object_object_get(jobj, "protocol"));
+        bool binary = protocol && strcmp(protocol, PROTO_NAME_BINARY) == 0;
+        json_object *tel = json_object_object_get(jobj, "telemetry");
+        int tel_sock = -1;
+        if (binary && tel)
+        {
+            int port = json_object_get_int(json_object_object_get(tel, "port"));
+            tel_sock = connect_telemetry(port);
+            if (tel_sock < 0)
+                perror("UDP telemetry socket failed, staying on TCP");
+            else
+                printf("Drone %d: Sending telemetry over UDP port %d.\n", drone->id, port);
+        }
+        pthread_mutex_lock(&drone->lock);
+        use_binary = binary;
+        if (tel_sock >= 0)
+        {
+            telemetry.session = (uint32_t)json_object_get_int64(json_object_object_get(tel, "session"));
+            telemetry.slot = (uint32_t)json_object_get_int64(json_object_object_get(tel, "slot"));
+            telemetry.seq = 0;
+            udp_sock = tel_sock;
+        }
+        pthread_mutex_unlock(&drone->lock);
+        printf("Drone %d: Handshake ACK received from server (protocol: %s).\n", drone->id,
+               binary ? PROTO_NAME_BINARY : PROTO_NAME_JSON);
+
+        // Gateway: sunucunun reddettiği (ör. başka yerde bağlı) drone'lar simüle edilmez
+        json_object *rejected = json_object_object_get(jobj, "rejected");
+        for (size_t i = 0; gateway && rejected && i < json_object_array_length(rejected); i++)
+        {
+            const char *id_str = json_object_get_string(json_object_array_get_idx(rejected, i));
+            ClientDrone *rejected_cd = id_str ? route_drone(cd, atoi(id_str + (id_str[0] == 'D'))) : NULL;
+            if (!rejected_cd)
+                continue;
+            Drone *d = rejected_cd->drone;
+            pthread_mutex_lock(&d->lock);
+            d->sock = 0;
+            pthread_mutex_unlock(&d->lock);
+            printf("Gateway: Drone %d rejected by server.\n", d->id);
+        }
+    }
+    // Diğer mesaj türleri...
+}
+
+void handle_server_frame(ClientDrone *cd, int sock, const ProtoMessage *msg)
+{
+    cd = msg->type == MSG_HEARTBEAT ? heartbeat_drone(cd) : route_drone(cd, msg->drone_id);
+    if (!cd)
+        return;
+    Drone *drone = cd->drone;
+    pthread_mutex_lock(&drone->lock);
+    if (msg->type == MSG_ASSIGN_MISSION)
+    {
+        start_mission(cd, msg->x, msg->y, NULL);
+    }
+    else if (msg->type == MSG_QUEUE_MISSION)
+    {
+        queue_mission(cd, msg->x, msg->y, NULL);
+    }
+    else if (msg->type == MSG_WAYPOINT)
+    { // Ait olduğu ASSIGN/QUEUE_MISSION'dan önce gelir
+        if (cd->pending_path.count < MISSION_MAX_WAYPOINTS)
+            cd->pending_path.points[cd->pending_path.count++] = (Coordinate){msg->x, msg->y};
+    }
+    else if (msg->type == MSG_HEARTBEAT)
+    {
+        report_heartbeat_ack(drone, sock);
+    }
+    pthread_mutex_unlock(&drone->lock);
+}
+
+// Desteklenen çerçevelemeler, tercih sırasına göre; sunucu ACK'de birini seçer.
+// "features" sunucunun gönderebileceği isteğe bağlı mesajları bildirir.
+void add_handshake_protocols(json_object *handshake, bool json_only)
+{
+    json_object *protocols = json_object_new_array();
+    if (!json_only)
+        json_object_array_add(protocols, json_object_new_string(PROTO_NAME_BINARY));
+    json_object_array_add(protocols, json_object_new_string(PROTO_NAME_JSON));
+    json_object_object_add(handshake, "protocols", protocols);
+    json_object *features = json_object_new_array();
+    json_object_array_add(features, json_object_new_string(PROTO_FEATURE_QUEUE));
+    json_object_array_add(features, json_object_new_string(PROTO_FEATURE_ROUTE));
+    json_object_object_add(handshake, "features", features);
+}
+
+// Sunucudan gelen akışı *alive sıfırlanana veya bağlantı kapanana kadar işler.
+// cd, drone_id taşımayan mesajların (HANDSHAKE_ACK, HEARTBEAT) hedefidir.
+void receive_loop(ClientDrone *cd, int sock, int *alive)
+{
+    Drone *drone = cd->drone;
+    // Gelen veri halkası + okumalar arasında durumunu koruyan JSON tokener
+    ProtoStream *stream = create_proto_stream(RECV_BUFFER_SIZE);
+    if (!stream)
+    {
+        fprintf(stderr, "Drone %d: Failed to allocate receive stream.\n", drone->id);
+        *alive = 0;
+    }
+
+    while (*alive > 0) // GÜNCELLENDİ: sock kontrolü
+    {
+        size_t space;
+        char *dst = ringbuf_write_ptr(stream->in, &space);
+        int len = recv(sock, dst, space, 0);
+        if (len <= 0)
+        {
+            if (len == 0)
+                printf("Drone %d: Server connection closed.\n", drone->id);
+            else
+                perror("recv failed");
+            *alive = 0; // Diğer thread'lerin durması için
+            break;
+        }
+        ringbuf_commit(stream->in, len);
+
+        // Halkada JSON mesajları ve (ACK'den sonra) ikili çerçeveler karışık olabilir
+        json_object *jobj;
+        ProtoMessage msg;
+        ProtoResult result;
+        while ((result = proto_stream_next(stream, &jobj, &msg)) != PROTO_NEED_MORE)
+        {
+            if (result == PROTO_JSON)
+            {
+                handle_server_json(cd, sock, jobj);
+                json_object_put(jobj);
+            }
+            else if (result == PROTO_FRAME)
+            {
+                handle_server_frame(cd, sock, &msg);
+            }
+            else if (result == PROTO_BAD_JSON)
+            {
+                fprintf(stderr, "Drone %d: Failed to parse JSON: %s\n", drone->id,
+                        json_tokener_error_desc(stream->error));
+            }
+            else
+            {
+                fprintf(stderr, "Drone %d: Malformed binary frame, discarding buffer.\n", drone->id);
+                proto_stream_reset(stream);
+                break;
+            }
+        }
+    }
+    free_proto_stream(stream);
+}
+
+// Gateway modu: first_id'den başlayan count drone'u tek bağlantı üzerinden taşır.
+int run_gateway(int first_id, int count, bool json_only)
+{
+    if (first_id <= 0 || count <= 0)
+    {
+        fprintf(stderr, "Geçersiz gateway parametreleri: %d %d\n", first_id, count);
+        return 1;
+    }
+    int sock = connect_to_server();
+    if (sock < 0)
+        return 1;
+
+    Gateway gw = {.drones = calloc(count, sizeof(ClientDrone)), .count = count, .sock = sock, .alive = 1};
+    if (!gw.drones)
+    {
+        close(sock);
+        return 1;
+    }
+    json_object *handshake = json_object_new_object();
+    json_object_object_add(handshake, "type", json_object_new_string("HANDSHAKE"));
+    char gateway_id_str[16];
+    snprintf(gateway_id_str, sizeof(gateway_id_str), "G%d", first_id);
+    json_object_object_add(handshake, "gateway", json_object_new_string(gateway_id_str));
+    json_object *ids = json_object_new_array();
+    for (int i = 0; i < count; i++)
+    {
+        gw.drones[i].drone = create_drone(first_id + i, -1, -1);
+        gw.drones[i].drone->sock = sock;
+        char id_str[16];
+        snprintf(id_str, sizeof(id_str), "D%d", first_id + i);
+        json_object_array_add(ids, json_object_new_string(id_str));
+    }
+    json_object_object_add(handshake, "drone_ids", ids);
+    add_handshake_protocols(handshake, json_only);
+    gateway = &gw;
+    send_json(sock, handshake);
+    json_object_put(handshake);
+    printf("Gateway %s: Relaying drones D%d-D%d over one connection.\n", gateway_id_str, first_id,
+           first_id + count - 1);
+
+    pthread_t sim_thread;
+    pthread_create(&sim_thread, NULL, gateway_loop, &gw);
+    receive_loop(&gw.drones[0], sock, &gw.alive);
+
+    printf("Gateway %s: Main loop exiting. Waiting for simulation thread...\n", gateway_id_str);
+    pthread_join(sim_thread, NULL);
+    close(sock);
+    gateway = NULL;
+    for (int i = 0; i < count; i++)
+        free_drone(gw.drones[i].drone);
+    free(gw.drones);
+    return 0;
+}
+
 int main(int argc, char *argv[])
 {
     if (argc < 2)
     {
-        fprintf(stderr, "Kullanım: %s <drone_id_sayisi>\nÖrnek: %s D1\n", argv[0], argv[0]);
+        fprintf(stderr, "Kullanım: %s <drone_id_sayisi> [--json]\n"
+                        "          %s --gateway <ilk_id> <drone_sayisi> [--json]\nÖrnek: %s D1\n",
+                argv[0], argv[0], argv[0]);
         return 1;
     }
+    if (strcmp(argv[1], "--gateway") == 0)
+    {
+        if (argc < 4)
+        {
+            fprintf(stderr, "Kullanım: %s --gateway <ilk_id> <drone_sayisi> [--json]\n", argv[0]);
+            return 1;
+        }
+        return run_gateway(atoi(argv[2]), atoi(argv[3]), argc > 4 && strcmp(argv[4], "--json") == 0);
+    }
+    bool json_only = argc > 2 && strcmp(argv[2], "--json") == 0; // İkili protokolü önerme
 
     int sock = connect_to_server();
     if (sock < 0)
@@ -198,6 +744,7 @@ int main(int argc, char *argv[])
 
     Drone *drone = create_drone(drone_id_val, -1, -1); // ID'yi parametreden al
     drone->sock = sock;
+    ClientDrone cd = {.drone = drone};
 
     // HANDSHAKE mesajı gönder
     json_object *handshake = json_object_new_object();
@@ -210,125 +757,22 @@ int main(int argc, char *argv[])
     json_object_object_add(caps, "battery_capacity", json_object_new_int(100)); // Örnek değer
     json_object_object_add(caps, "payload", json_object_new_string("medical")); // Örnek değer
     json_object_object_add(handshake, "capabilities", caps);
+    add_handshake_protocols(handshake, json_only);
+    // STATUS_UPDATE için UDP'yi öner; sunucu --udp ile açıksa ACK'de oturum verir
+    if (!json_only)
+    {
+        json_object *transports = json_object_new_array();
+        json_object_array_add(transports, json_object_new_string(PROTO_TRANSPORT_UDP));
+        json_object_object_add(handshake, "transports", transports);
+    }
     send_json(sock, handshake);
     json_object_put(handshake);
 
     pthread_t navigate_thread, status_thread;
-    pthread_create(&navigate_thread, NULL, navigate_to_target, drone);
+    pthread_create(&navigate_thread, NULL, navigate_to_target, &cd);
     pthread_create(&status_thread, NULL, send_status_update, drone);
 
-    char recv_buffer[1024];                         // Gelen tekil paketler için buffer
-    char process_buffer[PROCESS_BUFFER_SIZE] = {0}; // Birikmiş mesajları işlemek için
-    int process_buffer_len = 0;
-
-    while (drone->sock > 0) // GÜNCELLENDİ: sock kontrolü
-    {
-        int len = recv(sock, recv_buffer, sizeof(recv_buffer) - 1, 0);
-        if (len <= 0)
-        {
-            if (len == 0)
-                printf("Drone %d: Server connection closed.\n", drone->id);
-            else
-                perror("recv failed");
-            drone->sock = 0; // Diğer thread'lerin durması için
-            break;
-        }
-        recv_buffer[len] = '\0';
-
-        // Gelen veriyi process_buffer'a ekle (memcpy ile daha verimli)
-        if (process_buffer_len + len < PROCESS_BUFFER_SIZE)
-        {
-            memcpy(process_buffer + process_buffer_len, recv_buffer, len);
-            process_buffer_len += len;
-            process_buffer[process_buffer_len] = '\0'; // Null terminate
-        }
-        else
-        {
-            fprintf(stderr, "Drone %d: Processing buffer overflow, discarding data.\n", drone->id);
-            process_buffer[0] = '\0'; // Buffer'ı temizle
-            process_buffer_len = 0;
-            continue;
-        }
-
-        char *msg_start = process_buffer;
-        char *msg_end;
-
-        while ((msg_end = strchr(msg_start, '\n')) != NULL)
-        {
-            *msg_end = '\0'; // Mesajı ayır (null-terminate)
-
-            json_object *jobj = json_tokener_parse(msg_start);
-            if (!jobj)
-            {
-                fprintf(stderr, "Drone %d: Failed to parse JSON: %s\n", drone->id, msg_start);
-                msg_start = msg_end + 1;
-                continue;
-            }
-
-            json_object *type_obj = json_object_object_get(jobj, "type");
-            const char *type_str = type_obj ? json_object_get_string(type_obj) : NULL;
-
-            if (type_str)
-            {
-                if (strcmp(type_str, "ASSIGN_MISSION") == 0)
-                {
-                    pthread_mutex_lock(&drone->lock);
-                    json_object *target_json_obj = json_object_object_get(jobj, "target");
-                    if (target_json_obj)
-                    {
-                        drone->target.x = json_object_get_int(json_object_object_get(target_json_obj, "x"));
-                        drone->target.y = json_object_get_int(json_object_object_get(target_json_obj, "y"));
-                        drone->status = ON_MISSION;
-                        printf("Drone %d: Assigned mission to (%d, %d)\n", drone->id, drone->target.x, drone->target.y);
-                    }
-                    else
-                    {
-                        fprintf(stderr, "Drone %d: ASSIGN_MISSION message missing 'target'.\n", drone->id);
-                    }
-                    pthread_mutex_unlock(&drone->lock);
-                }
-                else if (strcmp(type_str, "HEARTBEAT") == 0) // YENİ: Sunucudan HEARTBEAT alındı
-                {
-                    // printf("Drone %d: Received HEARTBEAT from server.\n", drone->id);
-                    json_object *ack_jobj = json_object_new_object();
-                    json_object_object_add(ack_jobj, "type", json_object_new_string("HEARTBEAT_ACK"));
-                    char drone_id_ack_str[10];
-                    snprintf(drone_id_ack_str, sizeof(drone_id_ack_str), "D%d", drone->id);
-                    json_object_object_add(ack_jobj, "drone_id", json_object_new_string(drone_id_ack_str));
-                    json_object_object_add(ack_jobj, "timestamp", json_object_new_int64(time(NULL)));
-                    send_json(sock, ack_jobj);
-                    json_object_put(ack_jobj);
-                }
-                else if (strcmp(type_str, "HANDSHAKE_ACK") == 0)
-                {
-                    printf("Drone %d: Handshake ACK received from server.\n", drone->id);
-                }
-                // Diğer mesaj türleri...
-            }
-            else
-            {
-                fprintf(stderr, "Drone %d: Received JSON without 'type' field.\n", drone->id);
-            }
-
-            json_object_put(jobj);
-            msg_start = msg_end + 1;
-        }
-
-        // Kalan (tamamlanmamış) mesajı tamponun başına taşı
-        if (msg_start != process_buffer && *msg_start != '\0')
-        {
-            size_t remaining_len = process_buffer_len - (msg_start - process_buffer);
-            memmove(process_buffer, msg_start, remaining_len);
-            process_buffer_len = remaining_len;
-            process_buffer[process_buffer_len] = '\0'; // Null terminate
-        }
-        else if (*msg_start == '\0') // Tüm buffer işlendi
-        {
-            process_buffer[0] = '\0';
-            process_buffer_len = 0;
-        }
-        // else: kalan mesaj zaten buffer'ın başında, bir sonraki recv'de devamı gelecek.
-    }
+    receive_loop(&cd, sock, &drone->sock);
 
     printf("Drone %d: Main loop exiting. Waiting for threads to join...\n", drone->id);
     // Thread'lerin sonlanmasını bekle (sock = 0 yapıldı)
@@ -337,6 +781,8 @@ int main(int argc, char *argv[])
 
     if (sock > 0)
         close(sock);
+    if (udp_sock >= 0)
+        close(udp_sock);
     free_drone(drone);
     printf("Drone %d: Exited.\n", drone->id);
     return 0;
@@ -1,8 +1,11 @@
 #include "drone.h"
+#include "slab.h"
+#include <sched.h>
 #include <stdlib.h>
 #include <time.h>
 
 static int initialized = 0;
+static SlabPool drone_pool = SLAB_POOL_INIT("drone", Drone);
 
 Drone *create_drone(int id, int x, int y)
 {
@@ -11,7 +14,7 @@ Drone *create_drone(int id, int x, int y)
         srand(time(NULL));
         initialized = 1;
     }
-    Drone *drone = malloc(sizeof(Drone));
+    Drone *drone = slab_alloc(&drone_pool);
     if (!drone)
         return NULL;
     drone->id = id;
@@ -22,7 +25,11 @@ Drone *create_drone(int id, int x, int y)
     drone->target.y = drone->coord.y;
     drone->battery = 100;
     drone->sock = 0;
+    drone->mission_key = 0;
+    drone->route_len = 0;
+    drone->route_capacity = 0;
     drone->last_message_time = time(NULL); // YENİ: Başlangıç zamanı
+    drone->telemetry_seq = 0;
     pthread_mutex_init(&drone->lock, NULL);
     return drone;
 }
@@ -33,5 +40,57 @@ void free_drone(void *drone)
         return;
     Drone *d = (Drone *)drone;
     pthread_mutex_destroy(&d->lock);
-    free(d);
-}
\ No newline at end of file
+    slab_free(&drone_pool, d);
+}
+// Alanlara atomik (relaxed) erişilir; sıralamayı sayaç ve çitler sağlar. Okuyucu:
+// çift sayaç (acquire), alanlar, acquire çiti, sayaç değişmediyse kopya tutarlı.
+void drone_load_telemetry(const Drone *drone, DroneTelemetry *out)
+{
+    for (;;)
+    {
+        unsigned seq = __atomic_load_n(&drone->telemetry_seq, __ATOMIC_ACQUIRE);
+        if (seq & 1)
+        { // Yazıcı alanların ortasında
+            sched_yield();
+            continue;
+        }
+        out->coord.x = __atomic_load_n(&drone->coord.x, __ATOMIC_RELAXED);
+        out->coord.y = __atomic_load_n(&drone->coord.y, __ATOMIC_RELAXED);
+        out->status = __atomic_load_n(&drone->status, __ATOMIC_RELAXED);
+        out->battery = __atomic_load_n(&drone->battery, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&drone->telemetry_seq, __ATOMIC_RELAXED) == seq)
+            return;
+    }
+}
+
+bool drone_store_telemetry(Drone *drone, const DroneTelemetry *telemetry, unsigned fields)
+{
+    unsigned seq = __atomic_load_n(&drone->telemetry_seq, __ATOMIC_RELAXED);
+    while ((seq & 1) || !__atomic_compare_exchange_n(&drone->telemetry_seq, &seq, seq + 1, true,
+                                                     __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+        if (seq & 1)
+        { // Başka bir yazıcı (ör. controller görev atarken durumu yazıyor)
+            sched_yield();
+            seq = __atomic_load_n(&drone->telemetry_seq, __ATOMIC_RELAXED);
+        }
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE); // Tek sayaç alanlardan önce görünsün
+    DroneStatus previous = __atomic_load_n(&drone->status, __ATOMIC_RELAXED);
+    // Görevi atayan, mission_key'i durumu yazmadan önce koyar; sayaçtaki acquire onu gösterir
+    if ((fields & DRONE_TELEMETRY_REPORT) && telemetry->status == IDLE &&
+        __atomic_load_n(&drone->mission_key, __ATOMIC_RELAXED) != 0)
+        fields &= ~DRONE_TELEMETRY_STATUS;
+    if (fields & DRONE_TELEMETRY_COORD)
+    {
+        __atomic_store_n(&drone->coord.x, telemetry->coord.x, __ATOMIC_RELAXED);
+        __atomic_store_n(&drone->coord.y, telemetry->coord.y, __ATOMIC_RELAXED);
+    }
+    if (fields & DRONE_TELEMETRY_STATUS)
+        __atomic_store_n(&drone->status, telemetry->status, __ATOMIC_RELAXED);
+    if (fields & DRONE_TELEMETRY_BATTERY)
+        __atomic_store_n(&drone->battery, telemetry->battery, __ATOMIC_RELAXED);
+    __atomic_store_n(&drone->telemetry_seq, seq + 2, __ATOMIC_RELEASE);
+    return (fields & DRONE_TELEMETRY_STATUS) && telemetry->status != previous;
+}
@@ -2,8 +2,14 @@
 #define DRONE_H
 
 #include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <time.h> // YENİ: time_t için
 
+#define ROUTE_MAX_STOPS 8        // Mevcut hedeften sonra sıraya alınabilecek en fazla durak
+#define MISSION_ID_LEN 64         // "M_Ctrl_D<id>S<id>_T<zaman>"
+#define DRONE_MOVES_PER_BATTERY 5 // Pil her bu kadar hücrede bir azalır
+
 typedef enum
 {
     IDLE,
@@ -16,19 +22,60 @@ typedef struct
     int y;
 } Coordinate;
 
+#define MISSION_MAX_WAYPOINTS 32 // Bir görev ayağında en fazla dönüş noktası
+
+// Sunucunun engellerden kaçan yolunun dönüş noktaları (hedef hariç). Ardışık
+// noktalar tek eksende farklıdır; drone aralarında düz gider.
+typedef struct
+{
+    Coordinate points[MISSION_MAX_WAYPOINTS];
+    int count;
+} Waypoints;
+
+// Drone'un bildirdiği telemetrinin tutarlı bir kopyası (bkz. drone_load_telemetry).
+typedef struct
+{
+    Coordinate coord;
+    DroneStatus status;
+    int battery;
+} DroneTelemetry;
+
+#define DRONE_TELEMETRY_COORD 1u
+#define DRONE_TELEMETRY_STATUS 2u
+#define DRONE_TELEMETRY_BATTERY 4u
+// Client raporu: mission_key açıkken gelen "idle" yazılmaz. Rapor, client'ın henüz
+// işlemediği bir ASSIGN_MISSION'dan önce gönderilmiş olabilir; görev durumu sunucunundur.
+#define DRONE_TELEMETRY_REPORT 8u
+#define DRONE_TELEMETRY_ALL (DRONE_TELEMETRY_COORD | DRONE_TELEMETRY_STATUS | DRONE_TELEMETRY_BATTERY)
+
 typedef struct
 {
     int id;
+    // Sunucu: coord, status ve battery için seqlock sayacı; koruduğu alanlarla aynı
+    // önbellek satırında. Bu alanlar sadece drone_store_telemetry ile yazılır ve lock
+    // olmadan drone_load_telemetry ile okunur; STATUS_UPDATE yolu kilit almaz. Görev
+    // durumu (target, route, mission_key, sock) lock ile korunmaya devam eder.
+    unsigned telemetry_seq;
     DroneStatus status;
     Coordinate coord;
-    Coordinate target;
     int battery;
+    Coordinate target;
+    Coordinate route[ROUTE_MAX_STOPS]; // QUEUE_MISSION: mevcut hedeften sonra sırayla gidilecek duraklar
+    int route_len;
     int sock;
+    uint64_t mission_key; // Sunucu: açık görevin mission_table anahtarı (0: yok); lock altında atomik yazılır
+    uint64_t route_keys[ROUTE_MAX_STOPS]; // Sunucu: route[i] durağının görev anahtarı
+    int route_capacity; // Sunucu: drone'un kabul ettiği durak sayısı (0: QUEUE_MISSION yok)
     pthread_mutex_t lock;
     time_t last_message_time; // YENİ: Drone'dan gelen son mesaj zamanı (status veya ack)
 } Drone;
 
 Drone *create_drone(int id, int x, int y);
 void free_drone(void *drone);
+// Yazım sürüyorsa bekleyip yeniden dener; okuyucu yazıcıyı hiç bekletmez.
+void drone_load_telemetry(const Drone *drone, DroneTelemetry *out);
+// fields ile seçilen alanları tek sürümde yazar; durum değiştiyse true döndürür.
+// Yazıcılar sayaç üzerinden birbirini bekler (kısa bir döngü); lock gerekmez.
+bool drone_store_telemetry(Drone *drone, const DroneTelemetry *telemetry, unsigned fields);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,213 @@
+#define _GNU_SOURCE // sched_yield
+#include "epoch.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define EPOCH_COLLECT_THRESHOLD 64 // Bu kadar nesne birikince retire kendisi toplar
+
+typedef struct Retired
+{
+    void *ptr;
+    EpochFreeFn free_fn;
+    uint64_t epoch; // Ayrıldığı andaki global epoch
+    struct Retired *next;
+} Retired;
+
+// Thread başına duyuru: 0 ise kritik bölge dışında, değilse (epoch << 1) | 1.
+// Her slot kendi önbellek satırında; okuyucular birbirinin satırına yazmaz.
+typedef struct
+{
+    _Alignas(64) uint64_t state;
+    bool used;
+} EpochSlot;
+
+static EpochSlot slots[EPOCH_MAX_THREADS];
+static int slot_high = 0;          // Kullanılmış en yüksek slot + 1
+static uint64_t global_epoch = 1;
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static Retired *orphans = NULL;    // Çıkan thread'lerden kalanlar; registry_lock ile korunur
+static unsigned long stat_retired = 0, stat_reclaimed = 0, stat_advances = 0;
+
+static _Thread_local int my_slot = -1;
+static _Thread_local int nesting = 0;
+static _Thread_local Retired *limbo = NULL;
+static _Thread_local int limbo_count = 0;
+
+bool epoch_register(void)
+{
+    if (my_slot >= 0)
+        return true;
+    pthread_mutex_lock(&registry_lock);
+    for (int i = 0; i < EPOCH_MAX_THREADS; i++)
+    {
+        if (slots[i].used)
+            continue;
+        slots[i].used = true;
+        __atomic_store_n(&slots[i].state, 0, __ATOMIC_RELEASE);
+        if (i >= slot_high)
+            __atomic_store_n(&slot_high, i + 1, __ATOMIC_RELEASE);
+        my_slot = i;
+        break;
+    }
+    pthread_mutex_unlock(&registry_lock);
+    return my_slot >= 0;
+}
+
+// Tüm aktif okuyucular güncel epoch'u duyurduysa epoch'u bir ilerletir.
+static void try_advance(void)
+{
+    uint64_t e = __atomic_load_n(&global_epoch, __ATOMIC_SEQ_CST);
+    int high = __atomic_load_n(&slot_high, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < high; i++)
+    {
+        uint64_t state = __atomic_load_n(&slots[i].state, __ATOMIC_SEQ_CST);
+        if ((state & 1) && (state >> 1) != e)
+            return; // Bu okuyucu hâlâ önceki epoch'ta
+    }
+    if (__atomic_compare_exchange_n(&global_epoch, &e, e + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+        __atomic_add_fetch(&stat_advances, 1, __ATOMIC_RELAXED);
+}
+
+// Ayrıldığından beri epoch iki kez ilerlemiş nesneleri serbest bırakır; bu arada
+// başlamış hiçbir okuyucu onları göremez. Kalanların sayısını döndürür.
+static int reclaim(Retired **list)
+{
+    uint64_t e = __atomic_load_n(&global_epoch, __ATOMIC_SEQ_CST);
+    int remaining = 0;
+    Retired **link = list;
+    while (*link)
+    {
+        Retired *item = *link;
+        if (item->epoch + 2 <= e)
+        {
+            *link = item->next;
+            item->free_fn(item->ptr);
+            free(item);
+            __atomic_add_fetch(&stat_reclaimed, 1, __ATOMIC_RELAXED);
+            continue;
+        }
+        remaining++;
+        link = &item->next;
+    }
+    return remaining;
+}
+
+void epoch_unregister(void)
+{
+    if (my_slot < 0)
+        return;
+    epoch_collect();
+    pthread_mutex_lock(&registry_lock);
+    while (limbo)
+    {
+        Retired *item = limbo;
+        limbo = item->next;
+        item->next = orphans;
+        orphans = item;
+    }
+    limbo_count = 0;
+    __atomic_store_n(&slots[my_slot].state, 0, __ATOMIC_RELEASE);
+    slots[my_slot].used = false;
+    pthread_mutex_unlock(&registry_lock);
+    my_slot = -1;
+}
+
+void epoch_enter(void)
+{
+    if (nesting++ > 0)
+        return;
+    if (my_slot < 0 && !epoch_register())
+    {
+        fprintf(stderr, "epoch: more than %d threads registered\n", EPOCH_MAX_THREADS);
+        abort();
+    }
+    EpochSlot *slot = &slots[my_slot];
+    uint64_t e = __atomic_load_n(&global_epoch, __ATOMIC_SEQ_CST);
+    for (;;)
+    {
+        __atomic_store_n(&slot->state, (e << 1) | 1, __ATOMIC_SEQ_CST);
+        // Duyuru görünür olmadan epoch ilerlediyse yeni değeri duyur
+        uint64_t current = __atomic_load_n(&global_epoch, __ATOMIC_SEQ_CST);
+        if (current == e)
+            break;
+        e = current;
+    }
+}
+
+void epoch_exit(void)
+{
+    if (--nesting > 0)
+        return;
+    __atomic_store_n(&slots[my_slot].state, 0, __ATOMIC_RELEASE);
+}
+
+void epoch_retire(void *ptr, EpochFreeFn free_fn)
+{
+    if (!ptr)
+        return;
+    __atomic_add_fetch(&stat_retired, 1, __ATOMIC_RELAXED);
+    Retired *item = malloc(sizeof(Retired));
+    if (!item)
+    {
+        // Kayıt tutulamıyor: okuyucular çıkana kadar burada bekle
+        uint64_t target = __atomic_load_n(&global_epoch, __ATOMIC_SEQ_CST) + 2;
+        while (__atomic_load_n(&global_epoch, __ATOMIC_SEQ_CST) < target)
+        {
+            try_advance();
+            sched_yield();
+        }
+        free_fn(ptr);
+        __atomic_add_fetch(&stat_reclaimed, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    item->ptr = ptr;
+    item->free_fn = free_fn;
+    item->epoch = __atomic_load_n(&global_epoch, __ATOMIC_SEQ_CST);
+    item->next = limbo;
+    limbo = item;
+    if (++limbo_count >= EPOCH_COLLECT_THRESHOLD && nesting == 0)
+        epoch_collect();
+}
+
+void epoch_collect(void)
+{
+    try_advance();
+    limbo_count = reclaim(&limbo);
+    if (__atomic_load_n(&orphans, __ATOMIC_RELAXED) && pthread_mutex_trylock(&registry_lock) == 0)
+    {
+        reclaim(&orphans);
+        pthread_mutex_unlock(&registry_lock);
+    }
+}
+
+void epoch_drain(void)
+{
+    pthread_mutex_lock(&registry_lock);
+    while (limbo)
+    {
+        Retired *item = limbo;
+        limbo = item->next;
+        item->next = orphans;
+        orphans = item;
+    }
+    limbo_count = 0;
+    while (orphans)
+    {
+        Retired *item = orphans;
+        orphans = item->next;
+        item->free_fn(item->ptr);
+        free(item);
+        stat_reclaimed++;
+    }
+    pthread_mutex_unlock(&registry_lock);
+}
+
+void epoch_get_stats(EpochStats *stats)
+{
+    stats->epoch = __atomic_load_n(&global_epoch, __ATOMIC_ACQUIRE);
+    stats->retired = __atomic_load_n(&stat_retired, __ATOMIC_RELAXED);
+    stats->reclaimed = __atomic_load_n(&stat_reclaimed, __ATOMIC_RELAXED);
+    stats->advances = __atomic_load_n(&stat_advances, __ATOMIC_RELAXED);
+}
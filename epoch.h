@@ -0,0 +1,41 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Epoch tabanlı bellek geri kazanımı. Okuyucu, paylaşılan bir yapıyı kilitsiz
+// gezmeden önce epoch_enter, bitince epoch_exit çağırır. Yazıcı bir nesneyi
+// erişilemez yaptıktan sonra (ör. yeni görüntüyü yayınlayıp eskisini ayırdıktan
+// sonra) free yerine epoch_retire çağırır; nesne, o anda içeride olan tüm
+// okuyucular çıkana kadar (global epoch iki kez ilerleyene kadar) bekletilir.
+// Her thread kullanmadan önce epoch_register, çıkarken epoch_unregister çağırır.
+#define EPOCH_MAX_THREADS 128
+
+typedef void (*EpochFreeFn)(void *ptr);
+
+typedef struct
+{
+    uint64_t epoch;          // Global epoch
+    unsigned long retired;   // epoch_retire çağrısı
+    unsigned long reclaimed; // Serbest bırakılan nesne
+    unsigned long advances;  // Epoch ilerlemesi
+} EpochStats;
+
+// Slot kalmadıysa false.
+bool epoch_register(void);
+// Thread'in bekleyen nesneleri ortak listeye devredilir; başka bir thread'in
+// epoch_collect'i veya epoch_drain onları serbest bırakır.
+void epoch_unregister(void);
+// İç içe çağrılabilir; sadece en dıştaki enter/exit çifti etkilidir.
+void epoch_enter(void);
+void epoch_exit(void);
+void epoch_retire(void *ptr, EpochFreeFn free_fn);
+// Epoch'u ilerletmeyi dener ve artık görünemeyecek nesneleri serbest bırakır.
+// Kritik bölge dışında çağrılmalı.
+void epoch_collect(void);
+// Tüm thread'ler durduktan sonra kalan her şeyi serbest bırakır (kapanış).
+void epoch_drain(void);
+void epoch_get_stats(EpochStats *stats);
+
+#endif
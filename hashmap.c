@@ -0,0 +1,112 @@
+#include "hashmap.h"
+#include <stdlib.h>
+
+// Parça seçimi için Fibonacci çarpımının üst bitleri; IdTable içeride splitmix64'ün
+// alt bitlerini kullanır, böylece aynı parçadaki anahtarlar tabloya yine düzgün dağılır.
+static HashStripe *stripe_of(HashMap *map, uint64_t key)
+{
+    return &map->stripes[(key * 0x9E3779B97F4A7C15ULL) >> (64 - __builtin_ctz(HASHMAP_STRIPES))];
+}
+
+HashMap *create_hashmap(void)
+{
+    HashMap *map = aligned_alloc(_Alignof(HashMap), sizeof(HashMap));
+    if (!map)
+        return NULL;
+    map->size = 0;
+    for (int i = 0; i < HASHMAP_STRIPES; i++)
+    {
+        pthread_mutex_init(&map->stripes[i].lock, NULL);
+        if (!idtable_init(&map->stripes[i].table, 16))
+        {
+            while (i-- > 0)
+                idtable_destroy(&map->stripes[i].table);
+            free(map);
+            return NULL;
+        }
+    }
+    return map;
+}
+
+void destroy_hashmap(HashMap *map, void (*free_data)(void *))
+{
+    if (!map)
+        return;
+    for (int i = 0; i < HASHMAP_STRIPES; i++)
+    {
+        HashStripe *stripe = &map->stripes[i];
+        size_t pos = 0;
+        void *data;
+        while (free_data && (data = idtable_next(&stripe->table, &pos)) != NULL)
+            free_data(data);
+        idtable_destroy(&stripe->table);
+        pthread_mutex_destroy(&stripe->lock);
+    }
+    free(map);
+}
+
+bool put_hashmap(HashMap *map, uint64_t key, void *data)
+{
+    HashStripe *stripe = stripe_of(map, key);
+    pthread_mutex_lock(&stripe->lock);
+    size_t before = stripe->table.count;
+    bool ok = idtable_put(&stripe->table, key, data);
+    if (stripe->table.count != before)
+        __atomic_add_fetch(&map->size, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&stripe->lock);
+    return ok;
+}
+
+void *insert_hashmap(HashMap *map, uint64_t key, void *data)
+{
+    HashStripe *stripe = stripe_of(map, key);
+    pthread_mutex_lock(&stripe->lock);
+    void *current = idtable_get(&stripe->table, key);
+    if (!current)
+    {
+        current = idtable_put(&stripe->table, key, data) ? data : NULL;
+        if (current)
+            __atomic_add_fetch(&map->size, 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&stripe->lock);
+    return current;
+}
+
+void *get_hashmap(HashMap *map, uint64_t key)
+{
+    HashStripe *stripe = stripe_of(map, key);
+    pthread_mutex_lock(&stripe->lock);
+    void *data = idtable_get(&stripe->table, key);
+    pthread_mutex_unlock(&stripe->lock);
+    return data;
+}
+
+void *remove_hashmap(HashMap *map, uint64_t key)
+{
+    HashStripe *stripe = stripe_of(map, key);
+    pthread_mutex_lock(&stripe->lock);
+    void *data = idtable_remove(&stripe->table, key);
+    if (data)
+        __atomic_sub_fetch(&map->size, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&stripe->lock);
+    return data;
+}
+
+void iterate_hashmap(HashMap *map, void (*func)(void *data, void *ctx), void *ctx)
+{
+    for (int i = 0; i < HASHMAP_STRIPES; i++)
+    {
+        HashStripe *stripe = &map->stripes[i];
+        pthread_mutex_lock(&stripe->lock);
+        size_t pos = 0;
+        void *data;
+        while ((data = idtable_next(&stripe->table, &pos)) != NULL)
+            func(data, ctx);
+        pthread_mutex_unlock(&stripe->lock);
+    }
+}
+
+size_t get_hashmap_size(HashMap *map)
+{
+    return __atomic_load_n(&map->size, __ATOMIC_RELAXED);
+}
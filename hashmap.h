@@ -0,0 +1,50 @@
+#ifndef HASHMAP_H
+#define HASHMAP_H
+
+#include "idtable.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Kendi kilidini tutan, tamsayı anahtarlı hash map; List gibi void* veri saklar.
+// Anahtarlar HASHMAP_STRIPES parçaya dağıtılır, her parça kendi kilidi altında bir
+// IdTable'dır: farklı parçalara düşen işlemler birbirini beklemez ve arama, eleman
+// sayısından bağımsız olarak tek yoklama zinciridir. Veri NULL olamaz.
+#define HASHMAP_STRIPES 16 // 2'nin kuvveti
+
+typedef struct
+{
+    _Alignas(64) pthread_mutex_t lock; // Komşu parçalar aynı önbellek satırını paylaşmasın
+    IdTable table;
+} HashStripe;
+
+typedef struct HashMap
+{
+    HashStripe stripes[HASHMAP_STRIPES];
+    size_t size; // Atomik; kilitsiz okunur
+} HashMap;
+
+HashMap *create_hashmap(void);
+// Kalan verileri free_data ile bırakır (NULL ise dokunmaz). Başka thread kullanmamalıdır.
+void destroy_hashmap(HashMap *map, void (*free_data)(void *));
+// Anahtar varsa verisini değiştirir. Bellek yoksa false.
+bool put_hashmap(HashMap *map, uint64_t key, void *data);
+// Anahtar yoksa data'yı ekler. Map'te kalan veriyi döndürür: eklendiyse data, anahtar
+// zaten varsa mevcut veri, bellek yoksa NULL. Kontrol ve ekleme tek kilit altındadır.
+void *insert_hashmap(HashMap *map, uint64_t key, void *data);
+void *get_hashmap(HashMap *map, uint64_t key);
+// Silinen veriyi (yoksa NULL) döndürür.
+void *remove_hashmap(HashMap *map, uint64_t key);
+// Her veri için func(data, ctx). Parçalar sırayla, her biri kendi kilidi tutularak
+// gezilir: func map'i değiştirmemelidir. Gezinti sırasında başka parçalara yapılan
+// eklemeler görülmeyebilir; func dönene kadar o parçadaki veri silinemez.
+void iterate_hashmap(HashMap *map, void (*func)(void *data, void *ctx), void *ctx);
+size_t get_hashmap_size(HashMap *map);
+// İşaretçi anahtarı (ör. sadece adresiyle tanınan veri için).
+static inline uint64_t hashmap_ptr_key(const void *ptr)
+{
+    return (uint64_t)(uintptr_t)ptr;
+}
+
+#endif
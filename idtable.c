@@ -0,0 +1,132 @@
+#include "idtable.h"
+#include <stdlib.h>
+
+// splitmix64 karıştırıcısı: ardışık ID'ler tabloya düzgün dağılsın
+static size_t slot_of(const IdTable *table, uint64_t key)
+{
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return (size_t)key & (table->cap - 1);
+}
+
+bool idtable_init(IdTable *table, size_t initial_cap)
+{
+    size_t cap = 16;
+    while (cap < initial_cap)
+        cap *= 2;
+    table->slots = calloc(cap, sizeof(IdSlot));
+    table->cap = table->slots ? cap : 0;
+    table->count = 0;
+    return table->slots != NULL;
+}
+
+void idtable_destroy(IdTable *table)
+{
+    free(table->slots);
+    table->slots = NULL;
+    table->cap = table->count = 0;
+}
+
+void *idtable_get(const IdTable *table, uint64_t key)
+{
+    if (table->cap == 0)
+        return NULL;
+    for (size_t i = slot_of(table, key);; i = (i + 1) & (table->cap - 1))
+    {
+        const IdSlot *slot = &table->slots[i];
+        if (!slot->value)
+            return NULL;
+        if (slot->key == key)
+            return slot->value;
+    }
+}
+
+static bool grow(IdTable *table)
+{
+    IdTable bigger;
+    if (!idtable_init(&bigger, table->cap * 2))
+        return false;
+    for (size_t i = 0; i < table->cap; i++)
+    {
+        IdSlot *slot = &table->slots[i];
+        if (!slot->value)
+            continue;
+        size_t j = slot_of(&bigger, slot->key);
+        while (bigger.slots[j].value)
+            j = (j + 1) & (bigger.cap - 1);
+        bigger.slots[j] = *slot;
+    }
+    bigger.count = table->count;
+    free(table->slots);
+    *table = bigger;
+    return true;
+}
+
+bool idtable_put(IdTable *table, uint64_t key, void *value)
+{
+    // Doluluk en fazla %50: doğrusal yoklama kısa kalır
+    if ((table->count + 1) * 2 > table->cap && !grow(table))
+        return false;
+    size_t i = slot_of(table, key);
+    while (table->slots[i].value && table->slots[i].key != key)
+        i = (i + 1) & (table->cap - 1);
+    if (!table->slots[i].value)
+        table->count++;
+    table->slots[i].key = key;
+    table->slots[i].value = value;
+    return true;
+}
+
+void *idtable_remove(IdTable *table, uint64_t key)
+{
+    if (table->cap == 0)
+        return NULL;
+    size_t mask = table->cap - 1;
+    size_t i = slot_of(table, key);
+    while (table->slots[i].value && table->slots[i].key != key)
+        i = (i + 1) & mask;
+    void *value = table->slots[i].value;
+    if (!value)
+        return NULL;
+
+    // Geri kaydırma: boşluktan sonraki girdilerden, ev slotu boşluğu geçmeyenleri
+    // boşluğa taşı. Böylece her girdi ev slotundan kesintisiz ulaşılabilir kalır.
+    size_t hole = i;
+    for (size_t j = (i + 1) & mask; table->slots[j].value; j = (j + 1) & mask)
+    {
+        size_t home = slot_of(table, table->slots[j].key);
+        if (((j - home) & mask) >= ((j - hole) & mask))
+        {
+            table->slots[hole] = table->slots[j];
+            hole = j;
+        }
+    }
+    table->slots[hole].value = NULL;
+    table->count--;
+    return value;
+}
+
+void *idtable_next(const IdTable *table, size_t *pos)
+{
+    while (*pos < table->cap)
+    {
+        void *value = table->slots[(*pos)++].value;
+        if (value)
+            return value;
+    }
+    return NULL;
+}
+
+uint64_t idtable_hash_str(const char *str)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (; *str; str++)
+    {
+        hash ^= (unsigned char)*str;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
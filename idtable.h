@@ -0,0 +1,38 @@
+#ifndef IDTABLE_H
+#define IDTABLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Tamsayı anahtarlı açık adresli (doğrusal yoklamalı) hash tablosu. Değer NULL
+// olamaz; boş slot NULL değerle işaretlenir. Silme, mezar taşı bırakmak yerine
+// sonraki girdileri geri kaydırır; uzun çalışan tabloda yoklama zinciri uzamaz.
+// Kilitsizdir: çağıran, tabloyu koruyan kilidi tutar.
+typedef struct
+{
+    uint64_t key;
+    void *value;
+} IdSlot;
+
+typedef struct
+{
+    IdSlot *slots;
+    size_t cap; // 2'nin kuvveti
+    size_t count;
+} IdTable;
+
+bool idtable_init(IdTable *table, size_t initial_cap);
+void idtable_destroy(IdTable *table);
+void *idtable_get(const IdTable *table, uint64_t key);
+// Anahtar varsa değeri değiştirir. Bellek yoksa false.
+bool idtable_put(IdTable *table, uint64_t key, void *value);
+// Silinen değeri (yoksa NULL) döndürür.
+void *idtable_remove(IdTable *table, uint64_t key);
+// *pos'tan başlayarak sıradaki değeri döndürür; bitince NULL. *pos 0 ile başlatılır.
+// Gezinti sırasında tablo değiştirilmemelidir.
+void *idtable_next(const IdTable *table, size_t *pos);
+// Metin anahtarlar için (ör. mission_id) 64 bit FNV-1a özeti.
+uint64_t idtable_hash_str(const char *str);
+
+#endif
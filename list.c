@@ -1,7 +1,15 @@
 #include "list.h"
+#include "slab.h"
 #include <stdlib.h>
 #include <string.h>
 
+static SlabPool node_pool = SLAB_POOL_INIT("node", Node);
+
+void free_list_node(Node *node)
+{
+    slab_free(&node_pool, node);
+}
+
 List *create_list()
 {
     List *list = malloc(sizeof(List));
@@ -25,7 +33,7 @@ void destroy_list(List *list, void (*free_data)(void *))
         Node *next = current->next;
         if (free_data && current->data)
             free_data(current->data);
-        free(current);
+        free_list_node(current);
         current = next;
     }
     list->head = NULL;
@@ -38,18 +46,23 @@ void destroy_list(List *list, void (*free_data)(void *))
 
 bool add_list(List *list, void *data)
 {
-    Node *node = malloc(sizeof(Node));
+    pthread_mutex_lock(&list->lock);
+    bool ok = add_list_locked(list, data);
+    pthread_mutex_unlock(&list->lock);
+    return ok;
+}
+
+// Çağıran list->lock'u tutuyor olmalı (ekleme başka bir yapıyla birlikte atomik yapılacaksa).
+bool add_list_locked(List *list, void *data)
+{
+    Node *node = slab_alloc(&node_pool);
     if (!node)
         return false;
     node->data = data;
-    node->next = NULL;
-
-    pthread_mutex_lock(&list->lock);
     node->next = list->head;
     list->head = node;
     list->size++;
     pthread_cond_signal(&list->not_empty);
-    pthread_mutex_unlock(&list->lock);
     return true;
 }
 
@@ -66,7 +79,7 @@ bool remove_list(List *list, void *data, int (*compare)(void *, void *))
                 prev->next = current->next;
             else
                 list->head = current->next;
-            free(current);
+            free_list_node(current);
             list->size--;
             pthread_mutex_unlock(&list->lock);
             return true;
@@ -89,7 +102,7 @@ void *pop_list(List *list)
     void *data = node->data;
     list->head = node->next;
     list->size--;
-    free(node);
+    free_list_node(node);
     pthread_mutex_unlock(&list->lock);
     return data;
 }
@@ -112,4 +125,67 @@ int get_size(List *list)
     int size = list->size;
     pthread_mutex_unlock(&list->lock);
     return size;
-}
\ No newline at end of file
+}
+
+void mpsc_init(MpscQueue *queue)
+{
+    queue->stub.data = NULL;
+    queue->stub.next = NULL;
+    queue->head = &queue->stub;
+    queue->tail = &queue->stub;
+}
+
+void mpsc_destroy(MpscQueue *queue, void (*free_data)(void *))
+{
+    void *data;
+    while ((data = mpsc_pop(queue)) != NULL)
+        if (free_data)
+            free_data(data);
+}
+
+static void mpsc_push_node(MpscQueue *queue, Node *node)
+{
+    __atomic_store_n(&node->next, NULL, __ATOMIC_RELAXED);
+    // Düğüm önce head olur, sonra öncekine bağlanır; arada tüketici zinciri kopuk görür
+    Node *prev = __atomic_exchange_n(&queue->head, node, __ATOMIC_ACQ_REL);
+    __atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+}
+
+bool mpsc_push(MpscQueue *queue, void *data)
+{
+    Node *node = slab_alloc(&node_pool);
+    if (!node)
+        return false;
+    node->data = data;
+    mpsc_push_node(queue, node);
+    return true;
+}
+
+void *mpsc_pop(MpscQueue *queue)
+{
+    Node *tail = queue->tail;
+    Node *next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+    if (tail == &queue->stub)
+    { // Yer tutucuyu atla
+        if (!next)
+            return NULL;
+        queue->tail = next;
+        tail = next;
+        next = __atomic_load_n(&next->next, __ATOMIC_ACQUIRE);
+    }
+    if (!next)
+    {
+        // tail son düğümse çıkarılamaz (head onu gösteriyor): arkasına yer tutucu
+        // eklenir. head başka bir düğümse bir üretici bağlamayı henüz bitirmemiştir.
+        if (tail != __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE))
+            return NULL;
+        mpsc_push_node(queue, &queue->stub);
+        next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+        if (!next)
+            return NULL;
+    }
+    queue->tail = next;
+    void *data = tail->data;
+    free_list_node(tail);
+    return data;
+}
@@ -18,12 +18,35 @@ typedef struct List
     int size;
 } List;
 
+// Kilitsiz çok üretici / tek tüketici kuyruğu (Vyukov). Ekleme tek bir atomik
+// değiş tokuş ve bir yayın yazmasıdır: üreticiler ne birbirini ne tüketiciyi bekler.
+// Sıra FIFO'dur. Tüketici tek thread olmalıdır; data NULL olamaz.
+typedef struct
+{
+    Node *head; // Üreticilerin eklediği son düğüm (atomik)
+    Node *tail; // Tüketicinin okuyacağı düğüm; sadece tüketici dokunur
+    Node stub;  // Kuyruk boşken tail'in durduğu yer tutucu
+} MpscQueue;
+
 List *create_list();
 void destroy_list(List *list, void (*free_data)(void *));
 bool add_list(List *list, void *data);
+bool add_list_locked(List *list, void *data);
 bool remove_list(List *list, void *data, int (*compare)(void *, void *));
 void *pop_list(List *list);
 void iterate_list(List *list, void (*func)(void *));
 int get_size(List *list);
 
+// Listeden elle çıkarılan düğümü (ör. kilit altında zinciri düzenleyen kod) havuza iade eder.
+void free_list_node(Node *node);
+
+void mpsc_init(MpscQueue *queue);
+// Kuyrukta kalanları free_data ile bırakır; üretici kalmamış olmalıdır.
+void mpsc_destroy(MpscQueue *queue, void (*free_data)(void *));
+// Bellek yoksa false. Her thread'den çağrılabilir.
+bool mpsc_push(MpscQueue *queue, void *data);
+// Sıradaki veri; kuyruk boşsa NULL. Bir üretici eklemenin ortasındaysa o eleman
+// (ve arkasındakiler) ekleme bitene kadar görünmez, yine NULL döner. Sadece tüketici.
+void *mpsc_pop(MpscQueue *queue);
+
 #endif
\ No newline at end of file
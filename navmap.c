@@ -0,0 +1,719 @@
+#include "navmap.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct
+{
+    int f;
+    int g;
+    int cell;
+} OpenItem;
+
+// Hücre başına arama durumu tek kayıtta: komşu ziyareti tek önbellek satırına dokunur.
+typedef struct
+{
+    unsigned stamp;
+    int g;
+    int parent;
+} CellState;
+
+// Thread başına A* çalışma alanı. stamp != gen olan hücre bu aramada
+// görülmemiştir; dizi her aramada temizlenmez.
+typedef struct
+{
+    unsigned gen;
+    CellState *cells;
+    OpenItem *heap;
+    int heap_len;
+    int heap_cap;
+} Scratch;
+
+static void free_scratch(void *ptr)
+{
+    Scratch *s = ptr;
+    if (!s)
+        return;
+    free(s->cells);
+    free(s->heap);
+    free(s);
+}
+
+static Scratch *get_scratch(NavMap *map)
+{
+    Scratch *s = pthread_getspecific(map->scratch);
+    if (s)
+        return s;
+    size_t cells = (size_t)map->width * map->height;
+    s = calloc(1, sizeof(Scratch));
+    if (!s)
+        return NULL;
+    s->cells = calloc(cells, sizeof(CellState));
+    if (!s->cells || pthread_setspecific(map->scratch, s) != 0)
+    {
+        free_scratch(s);
+        return NULL;
+    }
+    return s;
+}
+
+static size_t field_size(const NavMap *map, const NavField *field)
+{
+    return (size_t)map->width * map->height * sizeof(uint16_t) + (size_t)field->cap * sizeof(int);
+}
+
+static void free_paths(NavMap *map, NavGoal *goal)
+{
+    for (int i = 0; i < goal->count; i++)
+    {
+        map->cached_cells -= goal->paths[i].len;
+        free(goal->paths[i].cells);
+    }
+    goal->count = goal->next = 0;
+}
+
+// Kilit tutulurken; goal'u okuyan sorgu kalmamış olmalı.
+static void free_goal(NavMap *map, NavGoal *goal)
+{
+    free_paths(map, goal);
+    if (goal->field)
+    {
+        map->stats.field_bytes -= field_size(map, goal->field);
+        map->stats.fields--;
+        pthread_mutex_destroy(&goal->field->lock);
+        free(goal->field->dist);
+        free(goal->field->queue);
+        free(goal->field);
+    }
+    free(goal);
+}
+
+bool navmap_init(NavMap *map, int width, int height)
+{
+    memset(map, 0, sizeof(*map));
+    map->width = width;
+    map->height = height;
+    map->field_budget = NAVMAP_FIELD_BUDGET;
+    map->blocked = calloc((size_t)width * height, 1);
+    map->component = calloc((size_t)width * height, sizeof(int)); // Engel yokken tek bileşen: 0
+    if (!map->blocked || !map->component || !idtable_init(&map->goals, 64) ||
+        pthread_key_create(&map->scratch, free_scratch) != 0)
+    {
+        free(map->blocked);
+        free(map->component);
+        idtable_destroy(&map->goals);
+        return false;
+    }
+    pthread_mutex_init(&map->lock, NULL);
+    return true;
+}
+
+// Yol önbelleği dolunca tüm yollar bırakılır; uzaklık alanları kalır.
+static void flush_paths(NavMap *map)
+{
+    size_t pos = 0;
+    NavGoal *goal;
+    while ((goal = idtable_next(&map->goals, &pos)))
+        free_paths(map, goal);
+}
+
+void navmap_destroy(NavMap *map)
+{
+    size_t pos = 0;
+    NavGoal *goal;
+    while ((goal = idtable_next(&map->goals, &pos)))
+        free_goal(map, goal);
+    idtable_destroy(&map->goals);
+    // Sadece çağıran thread'in çalışma alanı; diğerleri thread çıkışında serbest kalır
+    free_scratch(pthread_getspecific(map->scratch));
+    pthread_setspecific(map->scratch, NULL);
+    pthread_key_delete(map->scratch);
+    pthread_mutex_destroy(&map->lock);
+    free(map->blocked);
+    free(map->component);
+}
+
+// Serbest hücreleri 4 komşuluk bileşenlerine ayırır (taşma doldurma, açık yığınla).
+static void label_components(NavMap *map)
+{
+    int cells = map->width * map->height;
+    int *stack = malloc((size_t)cells * sizeof(int));
+    if (!stack)
+    { // Etiket yoksa herkes aynı bileşende sayılır; ulaşılamazlığı arama bulur
+        memset(map->component, 0, (size_t)cells * sizeof(int));
+        return;
+    }
+    for (int c = 0; c < cells; c++)
+        map->component[c] = map->blocked[c] ? -1 : -2;
+    int label = 0;
+    for (int c = 0; c < cells; c++)
+    {
+        if (map->component[c] != -2)
+            continue;
+        int top = 0;
+        stack[top++] = c;
+        map->component[c] = label;
+        while (top > 0)
+        {
+            int cur = stack[--top], x = cur % map->width, y = cur / map->width;
+            int next[4] = {x > 0 ? cur - 1 : -1, x < map->width - 1 ? cur + 1 : -1,
+                           y > 0 ? cur - map->width : -1, y < map->height - 1 ? cur + map->width : -1};
+            for (int k = 0; k < 4; k++)
+                if (next[k] >= 0 && map->component[next[k]] == -2)
+                {
+                    map->component[next[k]] = label;
+                    stack[top++] = next[k];
+                }
+        }
+        label++;
+    }
+    free(stack);
+}
+
+void navmap_block(NavMap *map, int x0, int y0, int x1, int y1)
+{
+    if (x0 > x1 || y0 > y1)
+        return;
+    x0 = x0 < 0 ? 0 : x0;
+    y0 = y0 < 0 ? 0 : y0;
+    x1 = x1 >= map->width ? map->width - 1 : x1;
+    y1 = y1 >= map->height ? map->height - 1 : y1;
+    for (int y = y0; y <= y1; y++)
+        for (int x = x0; x <= x1; x++)
+        {
+            uint8_t *cell = &map->blocked[y * map->width + x];
+            map->blocked_count += !*cell;
+            *cell = 1;
+        }
+    label_components(map);
+}
+
+static bool inside(const NavMap *map, Coordinate c)
+{
+    return c.x >= 0 && c.y >= 0 && c.x < map->width && c.y < map->height;
+}
+
+bool navmap_blocked(const NavMap *map, Coordinate c)
+{
+    return inside(map, c) && map->blocked[c.y * map->width + c.x];
+}
+
+static int manhattan(Coordinate a, Coordinate b)
+{
+    return abs(a.x - b.x) + abs(a.y - b.y);
+}
+
+// f küçük olan önce; eşitlikte g büyük olan (hedefe daha yakın) önce.
+static bool before(const OpenItem *a, const OpenItem *b)
+{
+    return a->f < b->f || (a->f == b->f && a->g > b->g);
+}
+
+static bool heap_push(Scratch *s, OpenItem item)
+{
+    if (s->heap_len == s->heap_cap)
+    {
+        int cap = s->heap_cap ? s->heap_cap * 2 : 256;
+        OpenItem *grown = realloc(s->heap, (size_t)cap * sizeof(OpenItem));
+        if (!grown)
+            return false;
+        s->heap = grown;
+        s->heap_cap = cap;
+    }
+    int i = s->heap_len++;
+    while (i > 0 && before(&item, &s->heap[(i - 1) / 2]))
+    {
+        s->heap[i] = s->heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    s->heap[i] = item;
+    return true;
+}
+
+static OpenItem heap_pop(Scratch *s)
+{
+    OpenItem top = s->heap[0];
+    OpenItem last = s->heap[--s->heap_len];
+    int i = 0;
+    for (;;)
+    {
+        int child = 2 * i + 1;
+        if (child >= s->heap_len)
+            break;
+        if (child + 1 < s->heap_len && before(&s->heap[child + 1], &s->heap[child]))
+            child++;
+        if (!before(&s->heap[child], &last))
+            break;
+        s->heap[i] = s->heap[child];
+        i = child;
+    }
+    if (s->heap_len > 0)
+        s->heap[i] = last;
+    return top;
+}
+
+// A* araması. Bulunursa yolu path'e yazar (hücreler malloc) ve true döner.
+// Eski kayıtlar yığından silinmez; çıkarıldığında g'si güncel değilse atlanır.
+static bool search(NavMap *map, Coordinate from, Coordinate to, NavPath *path, unsigned long *expanded)
+{
+    *expanded = 0;
+    Scratch *s = get_scratch(map);
+    if (!s)
+        return false;
+    if (++s->gen == 0)
+    { // Sayaç taştı: damgalar yeniden sıfırlanmalı
+        for (int c = 0; c < map->width * map->height; c++)
+            s->cells[c].stamp = 0;
+        s->gen = 1;
+    }
+    static const int dx[4] = {1, -1, 0, 0}, dy[4] = {0, 0, 1, -1};
+    int w = map->width;
+    int start = from.y * w + from.x, goal = to.y * w + to.x;
+    s->heap_len = 0;
+    s->cells[start] = (CellState){s->gen, 0, -1};
+    heap_push(s, (OpenItem){manhattan(from, to), 0, start});
+
+    while (s->heap_len > 0)
+    {
+        OpenItem item = heap_pop(s);
+        if (item.g != s->cells[item.cell].g)
+            continue;
+        if (item.cell == goal)
+        {
+            path->len = item.g + 1;
+            path->cells = malloc((size_t)path->len * sizeof(Coordinate));
+            if (!path->cells)
+                return false;
+            for (int c = goal, i = path->len - 1; c >= 0; c = s->cells[c].parent, i--)
+                path->cells[i] = (Coordinate){c % w, c / w};
+            return true;
+        }
+        (*expanded)++;
+        int x = item.cell % w, y = item.cell / w;
+        for (int k = 0; k < 4; k++)
+        {
+            Coordinate next = {x + dx[k], y + dy[k]};
+            if (!inside(map, next) || map->blocked[next.y * w + next.x])
+                continue;
+            int cell = next.y * w + next.x, g = item.g + 1;
+            CellState *state = &s->cells[cell];
+            if (state->stamp == s->gen && state->g <= g)
+                continue;
+            *state = (CellState){s->gen, g, item.cell};
+            if (!heap_push(s, (OpenItem){g + manhattan(next, to), g, cell}))
+                return false;
+        }
+    }
+    return false; // Hedef, başlangıcın bağlı bileşeninde değil
+}
+
+// Kilit tutulurken: to'ya giden önbellekteki bir yol from'dan geçiyorsa onu
+// döndürür, *at from'un yoldaki indeksi olur.
+static const NavPath *cached_suffix(NavMap *map, Coordinate from, Coordinate to, int *at)
+{
+    NavGoal *goal = idtable_get(&map->goals, (uint64_t)(to.y * map->width + to.x));
+    for (int i = 0; goal && i < goal->count; i++)
+    {
+        const NavPath *path = &goal->paths[i];
+        for (int k = 0; k < path->len; k++)
+            if (path->cells[k].x == from.x && path->cells[k].y == from.y)
+            {
+                *at = k;
+                return path;
+            }
+    }
+    return NULL;
+}
+
+// Kilit tutulurken: to hücresinin kaydı, yoksa açılır (bellek yoksa NULL).
+static NavGoal *get_goal(NavMap *map, Coordinate to)
+{
+    uint64_t key = (uint64_t)(to.y * map->width + to.x);
+    NavGoal *goal = idtable_get(&map->goals, key);
+    if (goal)
+        return goal;
+    goal = calloc(1, sizeof(NavGoal));
+    if (!goal || !idtable_put(&map->goals, key, goal))
+    {
+        free(goal);
+        return NULL;
+    }
+    goal->key = key;
+    return goal;
+}
+
+// Kilit tutulurken yolu önbelleğe ekler (sahipliği alır).
+static void cache_path(NavMap *map, Coordinate to, NavPath path)
+{
+    if (map->cached_cells + path.len > NAVMAP_MAX_CACHED_CELLS)
+        flush_paths(map);
+    NavGoal *goal = get_goal(map, to);
+    if (!goal)
+    {
+        free(path.cells);
+        return;
+    }
+    NavPath *slot = &goal->paths[goal->next];
+    if (goal->count < NAVMAP_PATHS_PER_GOAL)
+        goal->count++;
+    else
+    {
+        map->cached_cells -= slot->len;
+        free(slot->cells);
+    }
+    *slot = path;
+    map->cached_cells += path.len;
+    goal->next = (goal->next + 1) % NAVMAP_PATHS_PER_GOAL;
+}
+
+// Kilit tutulurken: to'nun uzaklık alanını (yoksa ve bütçe yetiyorsa açarak) bir
+// referansla döndürür. Referans release_field ile bırakılır.
+static NavGoal *acquire_field(NavMap *map, Coordinate to)
+{
+    size_t bytes = (size_t)map->width * map->height * sizeof(uint16_t) + 64 * sizeof(int);
+    NavGoal *goal = idtable_get(&map->goals, (uint64_t)(to.y * map->width + to.x));
+    if (!goal || !goal->field)
+    {
+        if (map->stats.field_bytes + bytes > map->field_budget || !(goal = get_goal(map, to)))
+            return NULL;
+        NavField *field = calloc(1, sizeof(NavField));
+        if (!field)
+            return NULL;
+        field->dist = malloc((size_t)map->width * map->height * sizeof(uint16_t));
+        field->queue = malloc(64 * sizeof(int));
+        if (!field->dist || !field->queue)
+        {
+            free(field->dist);
+            free(field->queue);
+            free(field);
+            return NULL;
+        }
+        memset(field->dist, 0xFF, (size_t)map->width * map->height * sizeof(uint16_t));
+        int cell = to.y * map->width + to.x;
+        field->dist[cell] = 0;
+        field->queue[field->tail++] = cell;
+        field->cap = 64;
+        pthread_mutex_init(&field->lock, NULL);
+        goal->field = field;
+        map->stats.fields++;
+        map->stats.field_bytes += bytes;
+        if (map->stats.field_bytes > map->stats.field_peak_bytes)
+            map->stats.field_peak_bytes = map->stats.field_bytes;
+    }
+    goal->refs++;
+    return goal;
+}
+
+// Kilit tutulurken referansı bırakır; sorgunun alan üzerindeki etkisini istatistiğe yansıtır.
+static void release_field(NavMap *map, NavGoal *goal, long grown_bytes, unsigned long expanded)
+{
+    map->stats.field_bytes += grown_bytes;
+    if (map->stats.field_bytes > map->stats.field_peak_bytes)
+        map->stats.field_peak_bytes = map->stats.field_bytes;
+    map->stats.field_expanded += expanded;
+    if (--goal->refs == 0 && goal->dead)
+        free_goal(map, goal);
+}
+
+// Alan kilidi tutulurken: BFS'i cell etiketlenene ya da sınır tükenene kadar sürdürür.
+// Bir hücre kuyruğa girerken etiketlenir; d adımlık hücre etiketlendiğinde d-1 ve
+// daha yakın tüm hücreler de etiketlidir. Kuyruk belleğindeki değişim *grown'a eklenir.
+static int field_grow(const NavMap *map, NavField *f, int cell, unsigned long *expanded, long *grown)
+{
+    int w = map->width, h = map->height;
+    while (f->dist[cell] == NAVMAP_FIELD_UNSEEN && f->head < f->tail)
+    {
+        int cur = f->queue[f->head++], x = cur % w, y = cur / w;
+        int d = f->dist[cur] + 1;
+        (*expanded)++;
+        if (d >= NAVMAP_FIELD_UNSEEN)
+        {
+            f->capped = true;
+            continue;
+        }
+        int next[4] = {x > 0 ? cur - 1 : -1, x < w - 1 ? cur + 1 : -1, y > 0 ? cur - w : -1, y < h - 1 ? cur + w : -1};
+        for (int k = 0; k < 4; k++)
+        {
+            int c = next[k];
+            if (c < 0 || map->blocked[c] || f->dist[c] != NAVMAP_FIELD_UNSEEN)
+                continue;
+            if (f->tail == f->cap)
+            {
+                if (f->head > f->cap / 2)
+                { // İşlenmiş baş kısmı at; kuyruk sınır kadar kalır
+                    memmove(f->queue, f->queue + f->head, (size_t)(f->tail - f->head) * sizeof(int));
+                    f->tail -= f->head;
+                    f->head = 0;
+                }
+                else
+                {
+                    int *grown_queue = realloc(f->queue, (size_t)f->cap * 2 * sizeof(int));
+                    if (!grown_queue)
+                    { // Bellek yok: etiketlenmeyen hücreler A*'a düşer
+                        f->capped = true;
+                        continue;
+                    }
+                    f->queue = grown_queue;
+                    *grown += (long)(f->cap * sizeof(int));
+                    f->cap *= 2;
+                }
+            }
+            f->dist[c] = (uint16_t)d;
+            f->queue[f->tail++] = c;
+        }
+    }
+    if (f->head == f->tail && f->queue)
+    { // Bileşen tamamen etiketlendi
+        *grown -= (long)(f->cap * sizeof(int));
+        free(f->queue);
+        f->queue = NULL;
+        f->head = f->tail = f->cap = 0;
+    }
+    return f->dist[cell] == NAVMAP_FIELD_UNSEEN ? -1 : f->dist[cell];
+}
+
+// Etiketli cell'den hedefe bir adım yakın komşu; prefer yönü eşitse ona öncelik verilir.
+static int field_descend(const NavMap *map, const NavField *f, int cell, int prefer)
+{
+    static const int dx[4] = {1, -1, 0, 0}, dy[4] = {0, 0, 1, -1};
+    int x = cell % map->width, y = cell / map->width, d = f->dist[cell];
+    for (int i = prefer < 0 ? 0 : -1; i < 4; i++)
+    {
+        int k = i < 0 ? prefer : i;
+        int nx = x + dx[k], ny = y + dy[k];
+        if (nx >= 0 && ny >= 0 && nx < map->width && ny < map->height && f->dist[ny * map->width + nx] == d - 1)
+            return k;
+    }
+    return -1;
+}
+
+// Alanda cell'den inerek dönüş noktalarını çıkarır; düz gidebildiği sürece yön değiştirmez.
+static int field_corners(const NavMap *map, const NavField *f, int cell, Coordinate *out, int max)
+{
+    static const int step[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    int n = 0, dir = -1;
+    while (f->dist[cell] > 0)
+    {
+        int k = field_descend(map, f, cell, dir);
+        if (dir >= 0 && k != dir)
+        {
+            if (n == max)
+                return -1;
+            out[n++] = (Coordinate){cell % map->width, cell / map->width};
+        }
+        dir = k;
+        cell += step[k][0] + step[k][1] * map->width;
+    }
+    return n;
+}
+
+// Uzaklık alanından yanıt: dönüş noktası sayısı ya da -1. Alan yoksa (bütçe dolu) veya
+// from alanın menzili dışındaysa NAVMAP_NO_FIELD; çağıran A*'a düşer.
+static int field_waypoints(NavMap *map, Coordinate from, Coordinate to, Coordinate *out, int max, int *cost)
+{
+    pthread_mutex_lock(&map->lock);
+    NavGoal *goal = map->field_budget ? acquire_field(map, to) : NULL;
+    pthread_mutex_unlock(&map->lock);
+    if (!goal)
+        return NAVMAP_NO_FIELD;
+
+    unsigned long expanded = 0;
+    long grown = 0;
+    int n = NAVMAP_NO_FIELD, cell = from.y * map->width + from.x;
+    NavField *f = goal->field;
+    pthread_mutex_lock(&f->lock);
+    int d = field_grow(map, f, cell, &expanded, &grown);
+    if (d >= 0)
+    {
+        n = out ? field_corners(map, f, cell, out, max) : 0;
+        *cost = n < 0 ? -1 : d;
+    }
+    pthread_mutex_unlock(&f->lock);
+
+    pthread_mutex_lock(&map->lock);
+    if (n != NAVMAP_NO_FIELD)
+    {
+        map->stats.lookups++;
+        map->stats.field_queries++;
+    }
+    release_field(map, goal, grown, expanded);
+    pthread_mutex_unlock(&map->lock);
+    return n;
+}
+
+// path->cells[at..] son ekinin dönüş noktaları.
+static int corners(const NavPath *path, int at, Coordinate *out, int max)
+{
+    int n = 0;
+    for (int i = at + 1; i < path->len - 1; i++)
+    {
+        Coordinate a = path->cells[i - 1], b = path->cells[i], c = path->cells[i + 1];
+        bool turn = (a.x == b.x) != (b.x == c.x);
+        if (!turn)
+            continue;
+        if (n == max)
+            return -1;
+        out[n++] = b;
+    }
+    return n;
+}
+
+int navmap_waypoints(NavMap *map, Coordinate from, Coordinate to, Coordinate *out, int max, int *cost)
+{
+    if (map->blocked_count == 0 || !inside(map, from) || !inside(map, to))
+    { // Engel yok: eksen boyunca herhangi bir yol en kısadır
+        if (cost)
+            *cost = manhattan(from, to);
+        return 0;
+    }
+    int from_component = map->component[from.y * map->width + from.x];
+    int to_component = map->component[to.y * map->width + to.x];
+    // Engelin içindeki drone'un (from_component < 0) çıkışını arama belirler
+    if (to_component < 0 || (from_component >= 0 && from_component != to_component))
+    {
+        pthread_mutex_lock(&map->lock);
+        map->stats.lookups++;
+        map->stats.unreachable++;
+        pthread_mutex_unlock(&map->lock);
+        if (cost)
+            *cost = -1;
+        return -1;
+    }
+    if (from_component >= 0)
+    {
+        int field_cost;
+        int n = field_waypoints(map, from, to, out, max, &field_cost);
+        if (n != NAVMAP_NO_FIELD)
+        {
+            if (cost)
+                *cost = field_cost;
+            return n;
+        }
+    }
+
+    pthread_mutex_lock(&map->lock);
+    map->stats.lookups++;
+    int at, n = -1, found_cost = -1;
+    const NavPath *path = cached_suffix(map, from, to, &at);
+    if (path)
+    {
+        map->stats.hits++;
+        found_cost = path->len - 1 - at;
+        n = out ? corners(path, at, out, max) : 0;
+    }
+    pthread_mutex_unlock(&map->lock);
+
+    if (!path)
+    {
+        NavPath fresh = {NULL, 0};
+        unsigned long expanded;
+        bool ok = search(map, from, to, &fresh, &expanded);
+        pthread_mutex_lock(&map->lock);
+        map->stats.searches++;
+        map->stats.expanded += expanded;
+        if (ok)
+        {
+            found_cost = fresh.len - 1;
+            n = out ? corners(&fresh, 0, out, max) : 0;
+            cache_path(map, to, fresh);
+        }
+        else
+        {
+            map->stats.unreachable++;
+            free(fresh.cells);
+        }
+        pthread_mutex_unlock(&map->lock);
+    }
+    if (cost)
+        *cost = n < 0 ? -1 : found_cost;
+    return n;
+}
+
+int navmap_cost(NavMap *map, Coordinate from, Coordinate to)
+{
+    int cost;
+    navmap_waypoints(map, from, to, NULL, 0, &cost);
+    return cost;
+}
+
+int navmap_next_step(NavMap *map, Coordinate from, Coordinate to, Coordinate *next)
+{
+    *next = from;
+    if (map->blocked_count == 0 || !inside(map, from) || !inside(map, to))
+    { // Engel yok: client gibi önce X, sonra Y ekseninde
+        if (from.x != to.x)
+            next->x += from.x < to.x ? 1 : -1;
+        else if (from.y != to.y)
+            next->y += from.y < to.y ? 1 : -1;
+        return manhattan(from, to);
+    }
+    int cell = from.y * map->width + from.x;
+    int from_component = map->component[cell], to_component = map->component[to.y * map->width + to.x];
+    if (to_component < 0 || (from_component >= 0 && from_component != to_component))
+        return -1;
+    if (from_component < 0)
+        return NAVMAP_NO_FIELD;
+
+    pthread_mutex_lock(&map->lock);
+    NavGoal *goal = map->field_budget ? acquire_field(map, to) : NULL;
+    pthread_mutex_unlock(&map->lock);
+    if (!goal)
+        return NAVMAP_NO_FIELD;
+    unsigned long expanded = 0;
+    long grown = 0;
+    pthread_mutex_lock(&goal->field->lock);
+    int d = field_grow(map, goal->field, cell, &expanded, &grown);
+    if (d > 0)
+    {
+        static const int dx[4] = {1, -1, 0, 0}, dy[4] = {0, 0, 1, -1};
+        int k = field_descend(map, goal->field, cell, -1);
+        *next = (Coordinate){from.x + dx[k], from.y + dy[k]};
+    }
+    pthread_mutex_unlock(&goal->field->lock);
+    pthread_mutex_lock(&map->lock);
+    if (d >= 0)
+    {
+        map->stats.lookups++;
+        map->stats.field_queries++;
+    }
+    release_field(map, goal, grown, expanded);
+    pthread_mutex_unlock(&map->lock);
+    return d >= 0 ? d : NAVMAP_NO_FIELD;
+}
+
+void navmap_track(NavMap *map, Coordinate to)
+{
+    if (map->blocked_count == 0 || !inside(map, to) || map->component[to.y * map->width + to.x] < 0)
+        return;
+    pthread_mutex_lock(&map->lock);
+    NavGoal *goal = map->field_budget ? acquire_field(map, to) : NULL;
+    if (goal)
+        release_field(map, goal, 0, 0);
+    pthread_mutex_unlock(&map->lock);
+}
+
+void navmap_set_field_budget(NavMap *map, size_t bytes)
+{
+    pthread_mutex_lock(&map->lock);
+    map->field_budget = bytes;
+    pthread_mutex_unlock(&map->lock);
+}
+
+void navmap_forget(NavMap *map, Coordinate to)
+{
+    if (!inside(map, to))
+        return;
+    pthread_mutex_lock(&map->lock);
+    NavGoal *goal = idtable_remove(&map->goals, (uint64_t)(to.y * map->width + to.x));
+    if (goal && goal->refs > 0)
+        goal->dead = true; // Alanı okuyan sorgu bitince release_field serbest bırakır
+    else if (goal)
+        free_goal(map, goal);
+    pthread_mutex_unlock(&map->lock);
+}
+
+void navmap_get_stats(NavMap *map, NavStats *stats)
+{
+    pthread_mutex_lock(&map->lock);
+    *stats = map->stats;
+    pthread_mutex_unlock(&map->lock);
+}
@@ -0,0 +1,114 @@
+#ifndef NAVMAP_H
+#define NAVMAP_H
+
+#include "drone.h"
+#include "idtable.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Uçuşa yasak bölgeleri tutan doluluk ızgarası ve üzerinde yol planlayıcı.
+// Drone'lar eksen boyunca birer hücre ilerlediği için arama 4 komşulu, adım
+// maliyeti 1, sezgisel Manhattan'dır (kabul edilebilir ve tutarlı); engel yoksa
+// yol maliyeti Manhattan mesafesinin kendisidir ve arama yapılmaz.
+//
+// Bulunan yollar hedef hücreye göre önbelleğe alınır. En kısa yolun her son eki
+// de en kısa yol olduğundan, aynı hedefe giden başka bir drone önbellekteki bir
+// yolun üzerindeyse (ör. aynı koridordan gelen ya da bir önceki durağı o yolda
+// olan) arama yapmadan onun devamını kullanır. Engeller başlangıçta kurulur ve
+// değişmez; bu yüzden önbellek sadece hedef kalkınca (navmap_forget) veya dolunca
+// boşaltılır. Sorgular birden çok thread'den (bölge işçileri) aynı anda yapılabilir.
+//
+// Açık hedeflerin çoğu için önbellekten de hızlısı uzaklık alanıdır: hedeften geriye
+// artımlı BFS. Alan sadece gelen sorguyu yanıtlayacak kadar genişletilir, sonraki
+// sorgular kaldığı yerden sürdürür; etiketli hücreden yol maliyeti ve sıradaki adım
+// O(1) okunur. Hücre başına 2 bayt tutar (1000x1000 haritada hedef başına ~2 MB);
+// toplam bütçe dolunca yeni hedefler A* ve yol önbelleğiyle yanıtlanır.
+#define NAVMAP_PATHS_PER_GOAL 32           // Hedef başına tutulan en fazla yol
+#define NAVMAP_MAX_CACHED_CELLS (1 << 22) // Önbellekteki toplam hücre (32 MB); aşılınca boşaltılır
+#define NAVMAP_FIELD_BUDGET ((size_t)256 << 20) // Uzaklık alanlarına ayrılan varsayılan bellek
+#define NAVMAP_FIELD_UNSEEN 0xFFFF              // Alanın henüz etiketlemediği hücre
+#define NAVMAP_NO_FIELD (-2)                    // navmap_next_step: alan kullanılamadı
+
+typedef struct
+{
+    Coordinate *cells; // Başlangıçtan hedefe (ikisi dahil) hücreler
+    int len;
+} NavPath;
+
+typedef struct
+{
+    uint16_t *dist; // Hedefe adım sayısı; NAVMAP_FIELD_UNSEEN henüz ulaşılmadı
+    int *queue;     // BFS sınırı [head, tail); alan tamamlanınca serbest bırakılır
+    int head;
+    int tail;
+    int cap;
+    bool capped;    // 0xFFFE adımdan uzak hücreler etiketlenmez; onlar A*'a düşer
+    pthread_mutex_t lock;
+} NavField;
+
+typedef struct
+{
+    uint64_t key; // Hedef hücre indeksi
+    NavPath paths[NAVMAP_PATHS_PER_GOAL];
+    int count;
+    int next;        // Dolunca üzerine yazılacak yol
+    NavField *field; // Bütçe yetmediyse NULL
+    int refs;        // Alanı kilitsiz okuyan sorgular
+    bool dead;       // navmap_forget edildi; son referansla serbest kalır
+} NavGoal;
+
+typedef struct
+{
+    unsigned long lookups;  // navmap_cost / navmap_waypoints
+    unsigned long hits;     // Önbellekteki bir yolun son ekiyle yanıtlanan
+    unsigned long searches; // Çalıştırılan A* araması
+    unsigned long expanded; // Aramalarda genişletilen toplam hücre
+    unsigned long unreachable;
+    unsigned long field_queries;  // Uzaklık alanından yanıtlanan
+    unsigned long field_expanded; // Alanların genişlettiği toplam hücre
+    unsigned long fields;         // Şu an açık alan
+    size_t field_bytes;
+    size_t field_peak_bytes;
+} NavStats;
+
+typedef struct
+{
+    int width;
+    int height;
+    uint8_t *blocked; // width x height, satır öncelikli
+    int blocked_count;
+    int *component;   // Bağlı bileşen etiketi, engelde -1; ulaşılamazlık aramasız anlaşılır
+    IdTable goals;    // Hedef hücre indeksi -> NavGoal*
+    long cached_cells;
+    size_t field_budget;
+    pthread_mutex_t lock;
+    pthread_key_t scratch; // Thread başına A* çalışma alanı
+    NavStats stats;
+} NavMap;
+
+bool navmap_init(NavMap *map, int width, int height);
+void navmap_destroy(NavMap *map);
+// Kapalı dikdörtgeni [x0, x1] x [y0, y1] uçuşa kapatır (harita dışı kırpılır) ve
+// bileşenleri yeniden etiketler. Sorgulardan önce, başlangıçta çağrılır.
+void navmap_block(NavMap *map, int x0, int y0, int x1, int y1);
+bool navmap_blocked(const NavMap *map, Coordinate c);
+// from'dan to'ya en kısa uçuş yolunun hücre sayısı; ulaşılamıyorsa -1. Harita
+// dışındaki uçlar için Manhattan mesafesi döner.
+int navmap_cost(NavMap *map, Coordinate from, Coordinate to);
+// Yolun dönüş noktalarını (from ve to hariç) sırayla out'a yazar. Ardışık iki
+// nokta tek eksende farklıdır; drone aralarında düz gider. Nokta sayısını,
+// ulaşılamıyorsa veya max'a sığmıyorsa -1'i döndürür. *cost NULL değilse doldurulur.
+int navmap_waypoints(NavMap *map, Coordinate from, Coordinate to, Coordinate *out, int max, int *cost);
+// from'dan to'ya sıradaki adımı *next'e yazar ve kalan maliyeti döndürür (0: hedefte).
+// Ulaşılamıyorsa -1; alan kullanılamıyorsa (bütçe dolu, başlangıç engelde) NAVMAP_NO_FIELD.
+int navmap_next_step(NavMap *map, Coordinate from, Coordinate to, Coordinate *next);
+// to için uzaklık alanı açar (survivor oluşturulunca); genişletme ilk sorguyu bekler.
+void navmap_track(NavMap *map, Coordinate to);
+// Uzaklık alanlarına ayrılan toplam bellek; 0 alanları kapatır. Açık alanlar etkilenmez.
+void navmap_set_field_budget(NavMap *map, size_t bytes);
+// to'ya giden önbellekteki yolları ve uzaklık alanını bırakır (hedef survivor kurtarıldı).
+void navmap_forget(NavMap *map, Coordinate to);
+void navmap_get_stats(NavMap *map, NavStats *stats);
+
+#endif
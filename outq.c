@@ -0,0 +1,89 @@
+#include "outq.h"
+#include <stdlib.h>
+#include <string.h>
+
+void outq_init(OutQueue *q)
+{
+    q->head = NULL;
+    q->tail = NULL;
+    q->bytes = 0;
+}
+
+void outq_clear(OutQueue *q)
+{
+    OutBlock *block = q->head;
+    while (block)
+    {
+        OutBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    outq_init(q);
+}
+
+bool outq_append(OutQueue *q, const char *data, size_t len, bool append_newline)
+{
+    size_t needed = len + (append_newline ? 1 : 0);
+    OutBlock *block = q->tail;
+    if (!block || block->capacity - block->end < needed)
+    {
+        size_t capacity = needed > OUTQ_BLOCK_SIZE ? needed : OUTQ_BLOCK_SIZE;
+        block = malloc(sizeof(OutBlock) + capacity);
+        if (!block)
+            return false;
+        block->next = NULL;
+        block->start = 0;
+        block->end = 0;
+        block->capacity = capacity;
+        if (q->tail)
+            q->tail->next = block;
+        else
+            q->head = block;
+        q->tail = block;
+    }
+    memcpy(block->data + block->end, data, len);
+    block->end += len;
+    if (append_newline)
+        block->data[block->end++] = '\n';
+    q->bytes += needed;
+    return true;
+}
+
+int outq_fill_iov(const OutQueue *q, struct iovec *iov, int max_iov)
+{
+    int count = 0;
+    for (OutBlock *block = q->head; block && count < max_iov; block = block->next)
+    {
+        if (block->end == block->start)
+            continue;
+        iov[count].iov_base = block->data + block->start;
+        iov[count].iov_len = block->end - block->start;
+        count++;
+    }
+    return count;
+}
+
+void outq_advance(OutQueue *q, size_t written)
+{
+    q->bytes -= written;
+    while (written > 0 && q->head)
+    {
+        OutBlock *block = q->head;
+        size_t pending = block->end - block->start;
+        if (written < pending)
+        {
+            block->start += written;
+            return;
+        }
+        written -= pending;
+        block->start = block->end;
+        if (block == q->tail)
+        { // Son blok: bir sonraki mesajlar için yeniden kullan
+            block->start = 0;
+            block->end = 0;
+            return;
+        }
+        q->head = block->next;
+        free(block);
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef OUTQ_H
+#define OUTQ_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/uio.h>
+
+#define OUTQ_BLOCK_SIZE 4096
+#define OUTQ_MAX_IOV 16
+
+// Bağlantı başına giden veri kuyruğu. Küçük mesajlar kuyruğun son bloğuna
+// kopyalanarak birleştirilir; bloklar tek bir writev/sendmsg ile gönderilir.
+// Bloklar hiç taşınmadığı için gönderim sürerken kuyruğa eklemek güvenlidir.
+typedef struct OutBlock
+{
+    struct OutBlock *next;
+    size_t start; // İlk gönderilmemiş bayt
+    size_t end;   // İlk boş bayt
+    size_t capacity;
+    char data[];
+} OutBlock;
+
+typedef struct
+{
+    OutBlock *head;
+    OutBlock *tail;
+    size_t bytes; // Gönderilmeyi bekleyen toplam bayt
+} OutQueue;
+
+void outq_init(OutQueue *q);
+void outq_clear(OutQueue *q);
+bool outq_append(OutQueue *q, const char *data, size_t len, bool append_newline);
+// Bekleyen veriyi en fazla max_iov parçalık iovec dizisine yerleştirir.
+int outq_fill_iov(const OutQueue *q, struct iovec *iov, int max_iov);
+// Gönderilen written baytı kuyruktan düşer; boşalan blokları serbest bırakır.
+void outq_advance(OutQueue *q, size_t written);
+
+#endif
@@ -0,0 +1,320 @@
+#include "protocol.h"
+#include <arpa/inet.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Tür başına sabit gövde uzunlukları; çözümleyici başka uzunluğu kabul etmez.
+static const uint16_t body_sizes[MSG_TYPE_COUNT] = {
+    [MSG_STATUS_UPDATE] = 16,   // drone_id, x, y, battery(u16), status(u8), pad
+    [MSG_MISSION_COMPLETE] = 13, // drone_id, x, y, success(u8)
+    [MSG_BATTERY_DEPLETED] = 4,  // drone_id
+    [MSG_HEARTBEAT_ACK] = 4,     // drone_id
+    [MSG_ASSIGN_MISSION] = 16,   // drone_id, x, y, mission_id
+    [MSG_HEARTBEAT] = 8,         // drone_id, timestamp
+    [MSG_TELEMETRY] = 28,        // drone_id, session, slot, seq, x, y, battery(u16), status(u8), pad
+    [MSG_STATUS_BATCH] = 0,      // Değişken: 2 + sayı * PROTO_STATUS_ENTRY_SIZE
+    [MSG_QUEUE_MISSION] = 16,    // ASSIGN_MISSION ile aynı düzen
+    [MSG_WAYPOINT] = 12,         // drone_id, x, y
+};
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    v = htonl(v);
+    memcpy(p, &v, sizeof(v));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return ntohl(v);
+}
+
+// STATUS_UPDATE gövdesi; STATUS_BATCH girdileri de aynı düzendedir.
+static void encode_status(uint8_t *body, const ProtoMessage *msg)
+{
+    put_u32(body, (uint32_t)msg->drone_id);
+    put_u32(body + 4, (uint32_t)msg->x);
+    put_u32(body + 8, (uint32_t)msg->y);
+    body[12] = (uint8_t)(msg->battery >> 8);
+    body[13] = (uint8_t)(msg->battery & 0xFF);
+    body[14] = msg->status;
+    body[15] = 0;
+}
+
+static void decode_status(const uint8_t *body, ProtoMessage *msg)
+{
+    msg->drone_id = (int32_t)get_u32(body);
+    msg->x = (int32_t)get_u32(body + 4);
+    msg->y = (int32_t)get_u32(body + 8);
+    msg->battery = (uint16_t)((body[12] << 8) | body[13]);
+    msg->status = body[14];
+}
+
+size_t proto_encode(const ProtoMessage *msg, uint8_t *out, size_t cap)
+{
+    if (msg->type <= 0 || msg->type >= MSG_TYPE_COUNT || body_sizes[msg->type] == 0)
+        return 0;
+    uint16_t body_len = body_sizes[msg->type];
+    size_t total = PROTO_HEADER_SIZE + body_len;
+    if (total > cap)
+        return 0;
+
+    out[0] = PROTO_MAGIC;
+    out[1] = (uint8_t)msg->type;
+    out[2] = (uint8_t)(body_len >> 8);
+    out[3] = (uint8_t)(body_len & 0xFF);
+    uint8_t *body = out + PROTO_HEADER_SIZE;
+    memset(body, 0, body_len);
+    put_u32(body, (uint32_t)msg->drone_id);
+
+    switch (msg->type)
+    {
+    case MSG_STATUS_UPDATE:
+        encode_status(body, msg);
+        break;
+    case MSG_MISSION_COMPLETE:
+        put_u32(body + 4, (uint32_t)msg->x);
+        put_u32(body + 8, (uint32_t)msg->y);
+        body[12] = msg->success;
+        break;
+    case MSG_ASSIGN_MISSION:
+    case MSG_QUEUE_MISSION:
+        put_u32(body + 4, (uint32_t)msg->x);
+        put_u32(body + 8, (uint32_t)msg->y);
+        put_u32(body + 12, msg->mission_id);
+        break;
+    case MSG_WAYPOINT:
+        put_u32(body + 4, (uint32_t)msg->x);
+        put_u32(body + 8, (uint32_t)msg->y);
+        break;
+    case MSG_HEARTBEAT:
+        put_u32(body + 4, msg->timestamp);
+        break;
+    case MSG_TELEMETRY:
+        put_u32(body + 4, msg->session);
+        put_u32(body + 8, msg->slot);
+        put_u32(body + 12, msg->seq);
+        put_u32(body + 16, (uint32_t)msg->x);
+        put_u32(body + 20, (uint32_t)msg->y);
+        body[24] = (uint8_t)(msg->battery >> 8);
+        body[25] = (uint8_t)(msg->battery & 0xFF);
+        body[26] = msg->status;
+        break;
+    default: // BATTERY_DEPLETED, HEARTBEAT_ACK: sadece drone_id
+        break;
+    }
+    return total;
+}
+
+size_t proto_encode_status_batch(const ProtoMessage *msgs, size_t count, uint8_t *out, size_t cap)
+{
+    size_t total = PROTO_BATCH_FRAME_SIZE(count);
+    if (count == 0 || count > PROTO_MAX_BATCH || total > cap)
+        return 0;
+    uint16_t body_len = (uint16_t)(total - PROTO_HEADER_SIZE);
+    out[0] = PROTO_MAGIC;
+    out[1] = MSG_STATUS_BATCH;
+    out[2] = (uint8_t)(body_len >> 8);
+    out[3] = (uint8_t)(body_len & 0xFF);
+    out[4] = (uint8_t)(count >> 8);
+    out[5] = (uint8_t)(count & 0xFF);
+    uint8_t *entry = out + PROTO_HEADER_SIZE + 2;
+    for (size_t i = 0; i < count; i++, entry += PROTO_STATUS_ENTRY_SIZE)
+        encode_status(entry, &msgs[i]);
+    return total;
+}
+
+int proto_decode(const uint8_t *buf, size_t len, ProtoMessage *msg)
+{
+    if (len < PROTO_HEADER_SIZE)
+        return 0;
+    if (buf[0] != PROTO_MAGIC || buf[1] == 0 || buf[1] >= MSG_TYPE_COUNT)
+        return -1;
+    uint16_t body_len = (uint16_t)((buf[2] << 8) | buf[3]);
+    if (body_sizes[buf[1]] == 0 || body_len != body_sizes[buf[1]])
+        return -1;
+    if (len < (size_t)PROTO_HEADER_SIZE + body_len)
+        return 0;
+
+    const uint8_t *body = buf + PROTO_HEADER_SIZE;
+    memset(msg, 0, sizeof(*msg));
+    msg->type = (MessageType)buf[1];
+    msg->drone_id = (int32_t)get_u32(body);
+
+    switch (msg->type)
+    {
+    case MSG_STATUS_UPDATE:
+        decode_status(body, msg);
+        break;
+    case MSG_MISSION_COMPLETE:
+        msg->x = (int32_t)get_u32(body + 4);
+        msg->y = (int32_t)get_u32(body + 8);
+        msg->success = body[12];
+        break;
+    case MSG_ASSIGN_MISSION:
+    case MSG_QUEUE_MISSION:
+        msg->x = (int32_t)get_u32(body + 4);
+        msg->y = (int32_t)get_u32(body + 8);
+        msg->mission_id = get_u32(body + 12);
+        break;
+    case MSG_WAYPOINT:
+        msg->x = (int32_t)get_u32(body + 4);
+        msg->y = (int32_t)get_u32(body + 8);
+        break;
+    case MSG_HEARTBEAT:
+        msg->timestamp = get_u32(body + 4);
+        break;
+    case MSG_TELEMETRY:
+        msg->session = get_u32(body + 4);
+        msg->slot = get_u32(body + 8);
+        msg->seq = get_u32(body + 12);
+        msg->x = (int32_t)get_u32(body + 16);
+        msg->y = (int32_t)get_u32(body + 20);
+        msg->battery = (uint16_t)((body[24] << 8) | body[25]);
+        msg->status = body[26];
+        break;
+    default:
+        break;
+    }
+    return PROTO_HEADER_SIZE + body_len;
+}
+
+ProtoStream *create_proto_stream(size_t capacity)
+{
+    ProtoStream *stream = calloc(1, sizeof(ProtoStream));
+    if (!stream)
+        return NULL;
+    stream->in = create_ringbuf(capacity);
+    stream->tok = json_tokener_new();
+    if (!stream->in || !stream->tok)
+    {
+        free_proto_stream(stream);
+        return NULL;
+    }
+    return stream;
+}
+
+void free_proto_stream(ProtoStream *stream)
+{
+    if (!stream)
+        return;
+    free_ringbuf(stream->in);
+    if (stream->tok)
+        json_tokener_free(stream->tok);
+    free(stream);
+}
+
+void proto_stream_reset(ProtoStream *stream)
+{
+    ringbuf_clear(stream->in);
+    json_tokener_reset(stream->tok);
+    stream->in_json = false;
+    stream->resync = false;
+    stream->json_len = 0;
+    stream->batch_left = 0;
+}
+
+// Halkadaki bir sonraki tam mesajı döndürür. Her bayta en fazla bir kez bakılır:
+// tamamlanmamış JSON'un baytları tokener'a verilip halkadan hemen tüketilir.
+ProtoResult proto_stream_next(ProtoStream *stream, json_object **jobj, ProtoMessage *msg)
+{
+    for (;;)
+    {
+        size_t avail;
+        const char *p = ringbuf_read_ptr(stream->in, &avail);
+        if (avail == 0)
+            return PROTO_NEED_MORE;
+
+        if (stream->resync)
+        {
+            const char *nl = memchr(p, '\n', avail);
+            ringbuf_consume(stream->in, nl ? (size_t)(nl - p) + 1 : avail);
+            stream->resync = nl == NULL;
+            continue;
+        }
+
+        if (stream->batch_left > 0)
+        { // STATUS_BATCH girdileri ayrı STATUS_UPDATE mesajları olarak döndürülür
+            uint8_t entry[PROTO_STATUS_ENTRY_SIZE];
+            if (ringbuf_peek(stream->in, entry, sizeof(entry)) < sizeof(entry))
+                return PROTO_NEED_MORE;
+            ringbuf_consume(stream->in, sizeof(entry));
+            stream->batch_left--;
+            memset(msg, 0, sizeof(*msg));
+            msg->type = MSG_STATUS_UPDATE;
+            decode_status(entry, msg);
+            return PROTO_FRAME;
+        }
+
+        if (!stream->in_json)
+        {
+            // Mesajlar arasındaki ayırıcıları atla; ikili çerçeve sadece mesaj sınırında başlar
+            size_t skip = 0;
+            while (skip < avail && isspace((unsigned char)p[skip]))
+                skip++;
+            if (skip)
+            {
+                ringbuf_consume(stream->in, skip);
+                continue;
+            }
+            if ((uint8_t)p[0] == PROTO_MAGIC)
+            {
+                uint8_t frame[PROTO_MAX_FRAME];
+                size_t len = ringbuf_peek(stream->in, frame, sizeof(frame));
+                if (len >= 2 && frame[1] == MSG_STATUS_BATCH)
+                {
+                    if (len < PROTO_HEADER_SIZE + 2)
+                        return PROTO_NEED_MORE;
+                    uint16_t body_len = (uint16_t)((frame[2] << 8) | frame[3]);
+                    uint16_t count = (uint16_t)((frame[4] << 8) | frame[5]);
+                    if (count == 0 || count > PROTO_MAX_BATCH || body_len != PROTO_BATCH_FRAME_SIZE(count) - PROTO_HEADER_SIZE)
+                        return PROTO_BAD_FRAME;
+                    // Başlık tüketilir; girdiler geldikçe tek tek döndürülür
+                    ringbuf_consume(stream->in, PROTO_HEADER_SIZE + 2);
+                    stream->batch_left = count;
+                    continue;
+                }
+                int frame_len = proto_decode(frame, len, msg);
+                if (frame_len == 0)
+                    return PROTO_NEED_MORE; // Çerçevenin devamı bekleniyor
+                if (frame_len < 0)
+                    return PROTO_BAD_FRAME;
+                ringbuf_consume(stream->in, frame_len);
+                return PROTO_FRAME;
+            }
+        }
+
+        json_object *obj = json_tokener_parse_ex(stream->tok, p, (int)avail);
+        enum json_tokener_error err = json_tokener_get_error(stream->tok);
+        if (err == json_tokener_continue)
+        {
+            ringbuf_consume(stream->in, avail);
+            stream->in_json = true;
+            stream->json_len += avail;
+            if (stream->json_len <= PROTO_MAX_JSON)
+                continue;
+            err = json_tokener_error_depth; // Aşırı büyük mesaj: hata olarak ele al
+        }
+        else if (err == json_tokener_success)
+        {
+            ringbuf_consume(stream->in, json_tokener_get_parse_end(stream->tok));
+        }
+        // Hata durumunda hiçbir şey tüketilmez; resync bozuk satırın sonuna kadar atlar
+
+        stream->in_json = false;
+        stream->json_len = 0;
+        if (err != json_tokener_success)
+        {
+            json_tokener_reset(stream->tok);
+            stream->resync = true;
+            stream->error = err;
+            return PROTO_BAD_JSON;
+        }
+        if (!obj)
+            continue; // Üst düzey "null"
+        *jobj = obj;
+        return PROTO_JSON;
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <json-c/json.h>
+#include "ringbuf.h"
+
+// HANDSHAKE sırasında anlaşılabilen sabit düzenli ikili çerçeveleme.
+// Çerçeve: [PROTO_MAGIC][tür][gövde uzunluğu (u16, ağ sırası)][gövde]
+// JSON satırları hiçbir zaman PROTO_MAGIC ile başlamadığı için iki biçim
+// aynı akışta karışık gelebilir (ör. ACK'den önce gönderilmiş JSON mesajları).
+#define PROTO_MAGIC 0xB1
+#define PROTO_HEADER_SIZE 4
+#define PROTO_MAX_FRAME 32
+#define PROTO_NAME_BINARY "binary-v1"
+#define PROTO_NAME_JSON "json"
+#define PROTO_MAX_JSON (64 * 1024) // Tek bir JSON mesajı için üst sınır
+#define PROTO_TRANSPORT_UDP "udp"  // HANDSHAKE "transports": UDP telemetri kanalı
+#define PROTO_FEATURE_QUEUE "queue" // HANDSHAKE "features": drone QUEUE_MISSION'ı anlar
+#define PROTO_FEATURE_ROUTE "route" // HANDSHAKE "features": ROUTE_MAX_STOPS'a kadar QUEUE_MISSION tutar
+#define PROTO_STATUS_ENTRY_SIZE 16 // STATUS_BATCH girdisi, STATUS_UPDATE gövdesiyle aynı düzen
+#define PROTO_MAX_BATCH 256        // Tek STATUS_BATCH çerçevesindeki en fazla girdi
+#define PROTO_BATCH_FRAME_SIZE(n) (PROTO_HEADER_SIZE + 2 + (size_t)(n) * PROTO_STATUS_ENTRY_SIZE)
+
+typedef enum
+{
+    MSG_STATUS_UPDATE = 1,    // drone -> sunucu
+    MSG_MISSION_COMPLETE = 2, // drone -> sunucu
+    MSG_BATTERY_DEPLETED = 3, // drone -> sunucu
+    MSG_HEARTBEAT_ACK = 4,    // drone -> sunucu
+    MSG_ASSIGN_MISSION = 5,   // sunucu -> drone
+    MSG_HEARTBEAT = 6,        // sunucu -> drone
+    MSG_TELEMETRY = 7,        // drone -> sunucu, sadece UDP: sıra numaralı STATUS_UPDATE
+    MSG_STATUS_BATCH = 8,     // gateway -> sunucu: [girdi sayısı u16][sayı x STATUS_UPDATE gövdesi]
+    MSG_QUEUE_MISSION = 9,    // sunucu -> drone: rotanın sonuna, mevcut görevden sonra eklenen durak
+    MSG_WAYPOINT = 10,        // sunucu -> drone: sıradaki ASSIGN/QUEUE_MISSION ayağının dönüş noktası
+    MSG_TYPE_COUNT
+} MessageType;
+
+// Çözülmüş ikili mesaj (host byte sırası). Her tür yalnızca kendi alanlarını taşır.
+typedef struct
+{
+    MessageType type;
+    int32_t drone_id;
+    int32_t x; // STATUS_UPDATE: konum, ASSIGN/QUEUE_MISSION ve MISSION_COMPLETE: hedef, WAYPOINT: nokta
+    int32_t y;
+    uint32_t mission_id; // ASSIGN_MISSION, QUEUE_MISSION
+    uint32_t timestamp;  // HEARTBEAT
+    uint16_t battery;    // STATUS_UPDATE
+    uint8_t status;      // STATUS_UPDATE: DroneStatus
+    uint8_t success;     // MISSION_COMPLETE
+    uint32_t session;    // TELEMETRY: HANDSHAKE_ACK'de verilen oturum anahtarı
+    uint32_t slot;       // TELEMETRY: sunucudaki oturum tablosu indeksi
+    uint32_t seq;        // TELEMETRY: her datagramda artar; eskiler atılır
+} ProtoMessage;
+
+// msg'yi out'a kodlar; yazılan bayt sayısını (veya cap yetmezse 0) döndürür.
+size_t proto_encode(const ProtoMessage *msg, uint8_t *out, size_t cap);
+// count adet STATUS_UPDATE'i tek STATUS_BATCH çerçevesine kodlar (count <= PROTO_MAX_BATCH).
+size_t proto_encode_status_batch(const ProtoMessage *msgs, size_t count, uint8_t *out, size_t cap);
+// buf başındaki sabit uzunluklu çerçeveyi çözer. Tüketilen bayt sayısını, çerçeve
+// henüz tamamlanmadıysa 0'ı, bozuk çerçevede -1'i döndürür. STATUS_BATCH sadece
+// ProtoStream üzerinden çözülür.
+int proto_decode(const uint8_t *buf, size_t len, ProtoMessage *msg);
+
+// Bağlantı başına gelen akış: recv verisi halkaya yazılır, JSON mesajları
+// okumalar arasında durumunu koruyan json_tokener ile artımlı ayrıştırılır.
+// Halka yalnızca henüz ayrıştırılmamış baytları tutar; mesaj boyutu halka
+// kapasitesiyle sınırlı değildir (PROTO_MAX_JSON'a kadar).
+typedef struct
+{
+    RingBuffer *in;
+    json_tokener *tok;
+    bool in_json;                  // Tokener bir nesnenin ortasında
+    bool resync;                   // Hatalı JSON sonrası bir sonraki '\n'e kadar atla
+    size_t json_len;               // Süren JSON mesajının şimdiye kadarki uzunluğu
+    uint16_t batch_left;           // Süren STATUS_BATCH'in henüz döndürülmemiş girdileri
+    enum json_tokener_error error; // Son PROTO_BAD_JSON'un nedeni
+} ProtoStream;
+
+typedef enum
+{
+    PROTO_NEED_MORE, // Halkadaki tüm veri tüketildi
+    PROTO_JSON,      // *jobj dolduruldu; çağıran json_object_put yapar
+    PROTO_FRAME,     // *msg dolduruldu; STATUS_BATCH girdileri tek tek STATUS_UPDATE olarak gelir
+    PROTO_BAD_JSON,  // Mesaj atlandı, akış bir sonraki satırdan devam eder
+    PROTO_BAD_FRAME  // İkili çerçeve bozuk; akış kurtarılamaz
+} ProtoResult;
+
+ProtoStream *create_proto_stream(size_t capacity);
+void free_proto_stream(ProtoStream *stream);
+void proto_stream_reset(ProtoStream *stream);
+ProtoResult proto_stream_next(ProtoStream *stream, json_object **jobj, ProtoMessage *msg);
+
+#endif
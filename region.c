@@ -0,0 +1,131 @@
+#include "region.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool region_planner_init(RegionPlanner *planner, SurvivorGrid *grid, WorkPool *pool, int region_cells)
+{
+    memset(planner, 0, sizeof(*planner));
+    planner->grid = grid;
+    planner->pool = pool;
+    planner->region_cells = region_cells > 0 ? region_cells : 1;
+    planner->region_cols = (grid->cols + planner->region_cells - 1) / planner->region_cells;
+    planner->region_rows = (grid->rows + planner->region_cells - 1) / planner->region_cells;
+    planner->region_start = calloc((size_t)planner->region_cols * planner->region_rows + 1, sizeof(int));
+    return planner->region_start != NULL;
+}
+
+void region_planner_destroy(RegionPlanner *planner)
+{
+    free(planner->region_start);
+    free(planner->order);
+    planner->region_start = NULL;
+    planner->order = NULL;
+}
+
+static GridRect region_rect(const RegionPlanner *planner, int region)
+{
+    GridRect rect;
+    rect.x0 = (region % planner->region_cols) * planner->region_cells;
+    rect.y0 = (region / planner->region_cols) * planner->region_cells;
+    rect.x1 = rect.x0 + planner->region_cells - 1;
+    rect.y1 = rect.y0 + planner->region_cells - 1;
+    if (rect.x1 >= planner->grid->cols)
+        rect.x1 = planner->grid->cols - 1;
+    if (rect.y1 >= planner->grid->rows)
+        rect.y1 = planner->grid->rows - 1;
+    return rect;
+}
+
+// pos'tan bölge dışındaki en yakın noktaya Manhattan mesafesi. Harita kenarına
+// dayanan kenarlar dışa doğru sınırsızdır (kenar hücreler taşan koordinatları tutar).
+static int border_distance(const RegionPlanner *planner, const GridRect *rect, Coordinate pos)
+{
+    const SurvivorGrid *grid = planner->grid;
+    int cs = grid->cell_size;
+    int best = INT_MAX;
+    if (rect->x0 > 0 && pos.x - rect->x0 * cs + 1 < best)
+        best = pos.x - rect->x0 * cs + 1;
+    if (rect->x1 < grid->cols - 1 && (rect->x1 + 1) * cs - pos.x < best)
+        best = (rect->x1 + 1) * cs - pos.x;
+    if (rect->y0 > 0 && pos.y - rect->y0 * cs + 1 < best)
+        best = pos.y - rect->y0 * cs + 1;
+    if (rect->y1 < grid->rows - 1 && (rect->y1 + 1) * cs - pos.y < best)
+        best = (rect->y1 + 1) * cs - pos.y;
+    return best < 0 ? 0 : best;
+}
+
+static void plan_region(void *ctx, int region, int worker)
+{
+    (void)worker;
+    RegionPlanner *planner = (RegionPlanner *)ctx;
+    GridRect rect = region_rect(planner, region);
+    for (int k = planner->region_start[region]; k < planner->region_start[region + 1]; k++)
+    {
+        PlanDrone *d = &planner->drones[planner->order[k]];
+        d->pick = survgrid_best_in(planner->grid, &rect, d->pos, planner->now, &d->score);
+        if (d->pick)
+            d->pick->is_targeted = true;
+    }
+}
+
+void region_plan(RegionPlanner *planner, PlanDrone *drones, int count, time_t now)
+{
+    int region_count = planner->region_cols * planner->region_rows;
+    planner->drones = drones;
+    planner->now = now;
+    planner->stat_passes++;
+    for (int i = 0; i < count; i++)
+        drones[i].pick = NULL;
+    if (count == 0 || planner->grid->count == 0)
+        return;
+
+    if (planner->order_cap < count)
+    {
+        int *order = realloc(planner->order, (size_t)count * sizeof(int));
+        if (!order)
+            return;
+        planner->order = order;
+        planner->order_cap = count;
+    }
+
+    // Drone'ları bölgelere kovala (sayma sıralaması; bölge içi sıra korunur)
+    memset(planner->region_start, 0, (size_t)(region_count + 1) * sizeof(int));
+    for (int i = 0; i < count; i++)
+    {
+        int cx, cy;
+        survgrid_cell_coords(planner->grid, drones[i].pos, &cx, &cy);
+        drones[i].region = (cy / planner->region_cells) * planner->region_cols + cx / planner->region_cells;
+        planner->region_start[drones[i].region + 1]++;
+    }
+    for (int r = 0; r < region_count; r++)
+        planner->region_start[r + 1] += planner->region_start[r];
+    for (int i = 0; i < count; i++)
+        planner->order[planner->region_start[drones[i].region]++] = i;
+    for (int r = region_count; r > 0; r--)
+        planner->region_start[r] = planner->region_start[r - 1];
+    planner->region_start[0] = 0;
+
+    workpool_run(planner->pool, region_count, plan_region, planner);
+
+    // Sınır uzlaştırması: bölge dışından gelebilecek en iyi skor seçimi geçebiliyorsa
+    // drone seçimini bırakıp tüm ızgarada (ayrılmamış survivor'lar arasında) yeniden arar.
+    const SurvivorGrid *grid = planner->grid;
+    for (int i = 0; i < count; i++)
+    {
+        PlanDrone *d = &drones[i];
+        GridRect rect = region_rect(planner, d->region);
+        int dist = border_distance(planner, &rect, d->pos);
+        if (dist == INT_MAX)
+            continue; // Tek bölge: dışarısı yok
+        double outside_bound = SURVGRID_SCORE(grid->max_priority, now - grid->oldest, dist);
+        if (d->pick && outside_bound <= d->score)
+            continue;
+        if (d->pick)
+            d->pick->is_targeted = false;
+        d->pick = survgrid_best(grid, d->pos, now, &d->score);
+        if (d->pick)
+            d->pick->is_targeted = true;
+        planner->stat_reconciled++;
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef REGION_H
+#define REGION_H
+
+#include "survgrid.h"
+#include "workpool.h"
+#include <stdbool.h>
+#include <time.h>
+
+// Bölgelere ayrılmış paralel atama planlayıcısı. Izgara, region_cells x
+// region_cells hücrelik bölgelere bölünür; boştaki drone'lar konumlarının
+// bölgesine kovalanır ve her bölge havuzda bir görev olur. İşçi, bölgesindeki
+// drone'lara sırayla sadece kendi bölgesinin hücrelerinden en iyi survivor'ı
+// seçip is_targeted ile ayırır; bölgeler hücre paylaşmadığı için kilit gerekmez.
+// Ardından sınır uzlaştırması: bölge dışındaki bir survivor'ın (sınıra olan
+// mesafeyle sınırlanan) skoru seçimi geçebilecek drone'lar sırayla tüm ızgarada
+// yeniden sorgulanır.
+typedef struct
+{
+    Coordinate pos;
+    Survivor *pick; // Sonuç: ayrılmış survivor veya NULL
+    double score;
+    int region;
+} PlanDrone;
+
+typedef struct
+{
+    SurvivorGrid *grid;
+    WorkPool *pool;
+    int region_cells;
+    int region_cols;
+    int region_rows;
+    int *region_start; // Bölge r'nin drone'ları order[region_start[r] .. region_start[r+1])
+    int *order;
+    int order_cap;
+    PlanDrone *drones; // Geçiş süresince
+    time_t now;
+    unsigned long stat_passes;
+    unsigned long stat_reconciled; // Sınır uzlaştırmasında yeniden sorgulanan drone
+} RegionPlanner;
+
+bool region_planner_init(RegionPlanner *planner, SurvivorGrid *grid, WorkPool *pool, int region_cells);
+void region_planner_destroy(RegionPlanner *planner);
+// Çağıran, ızgarayı koruyan kilidi (survivor_lock) geçiş boyunca tutar.
+// Seçilen survivor'lar is_targeted = true bırakılır; uygulanamayanları çağıran
+// geri almalıdır.
+void region_plan(RegionPlanner *planner, PlanDrone *drones, int count, time_t now);
+
+#endif
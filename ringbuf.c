@@ -0,0 +1,111 @@
+#include "ringbuf.h"
+#include <stdlib.h>
+#include <string.h>
+
+RingBuffer *create_ringbuf(size_t capacity)
+{
+    size_t rounded = 1;
+    while (rounded < capacity)
+        rounded <<= 1;
+
+    RingBuffer *rb = malloc(sizeof(RingBuffer));
+    if (!rb)
+        return NULL;
+    rb->data = malloc(rounded);
+    if (!rb->data)
+    {
+        free(rb);
+        return NULL;
+    }
+    rb->capacity = rounded;
+    rb->head = 0;
+    rb->tail = 0;
+    return rb;
+}
+
+void free_ringbuf(RingBuffer *rb)
+{
+    if (!rb)
+        return;
+    free(rb->data);
+    free(rb);
+}
+
+void ringbuf_clear(RingBuffer *rb)
+{
+    rb->head = 0;
+    rb->tail = 0;
+}
+
+size_t ringbuf_used(const RingBuffer *rb)
+{
+    return rb->tail - rb->head;
+}
+
+size_t ringbuf_space(const RingBuffer *rb)
+{
+    return rb->capacity - ringbuf_used(rb);
+}
+
+char *ringbuf_write_ptr(RingBuffer *rb, size_t *contiguous)
+{
+    size_t offset = rb->tail & (rb->capacity - 1);
+    size_t to_end = rb->capacity - offset;
+    size_t space = ringbuf_space(rb);
+    *contiguous = space < to_end ? space : to_end;
+    return rb->data + offset;
+}
+
+void ringbuf_commit(RingBuffer *rb, size_t len)
+{
+    rb->tail += len;
+}
+
+size_t ringbuf_write(RingBuffer *rb, const void *src, size_t len)
+{
+    const char *p = (const char *)src;
+    size_t written = 0;
+    while (written < len)
+    {
+        size_t contiguous;
+        char *dst = ringbuf_write_ptr(rb, &contiguous);
+        if (contiguous == 0)
+            break; // Halka dolu; kalan veriyi çağıran tekrar dener
+        size_t chunk = len - written < contiguous ? len - written : contiguous;
+        memcpy(dst, p + written, chunk);
+        ringbuf_commit(rb, chunk);
+        written += chunk;
+    }
+    return written;
+}
+
+const char *ringbuf_read_ptr(const RingBuffer *rb, size_t *contiguous)
+{
+    size_t offset = rb->head & (rb->capacity - 1);
+    size_t to_end = rb->capacity - offset;
+    size_t used = ringbuf_used(rb);
+    *contiguous = used < to_end ? used : to_end;
+    return rb->data + offset;
+}
+
+void ringbuf_consume(RingBuffer *rb, size_t len)
+{
+    rb->head += len;
+    if (rb->head == rb->tail)
+    { // Boşaldığında başa dön: sonraki recv'ler bitişik alana düşer
+        rb->head = 0;
+        rb->tail = 0;
+    }
+}
+
+size_t ringbuf_peek(const RingBuffer *rb, void *dst, size_t len)
+{
+    size_t used = ringbuf_used(rb);
+    if (len > used)
+        len = used;
+    size_t offset = rb->head & (rb->capacity - 1);
+    size_t first = rb->capacity - offset < len ? rb->capacity - offset : len;
+    memcpy(dst, rb->data + offset, first);
+    memcpy((char *)dst + first, rb->data, len - first);
+    return len;
+}
@@ -0,0 +1,35 @@
+#ifndef RINGBUF_H
+#define RINGBUF_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Bağlantı başına bayt halkası. head/tail sürekli artar; indeks için kapasite
+// maskesi kullanılır, bu yüzden kapasite 2'nin kuvvetidir. Okunan veri asla
+// memmove ile kaydırılmaz. Tek thread'den kullanılır (kilitsiz).
+typedef struct
+{
+    char *data;
+    size_t capacity;
+    size_t head; // Okuma konumu
+    size_t tail; // Yazma konumu
+} RingBuffer;
+
+RingBuffer *create_ringbuf(size_t capacity);
+void free_ringbuf(RingBuffer *rb);
+void ringbuf_clear(RingBuffer *rb);
+size_t ringbuf_used(const RingBuffer *rb);
+size_t ringbuf_space(const RingBuffer *rb);
+
+// recv'in doğrudan halkaya yazabilmesi için bitişik boş alan; ardından commit.
+char *ringbuf_write_ptr(RingBuffer *rb, size_t *contiguous);
+void ringbuf_commit(RingBuffer *rb, size_t len);
+size_t ringbuf_write(RingBuffer *rb, const void *src, size_t len);
+
+// Okunmamış verinin bitişik ilk parçası; ardından consume.
+const char *ringbuf_read_ptr(const RingBuffer *rb, size_t *contiguous);
+void ringbuf_consume(RingBuffer *rb, size_t len);
+// Tüketmeden en fazla len baytı (halka sonunu aşarak) dst'ye kopyalar.
+size_t ringbuf_peek(const RingBuffer *rb, void *dst, size_t len);
+
+#endif
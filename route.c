@@ -0,0 +1,106 @@
+#include "route.h"
+#include <stdlib.h>
+
+static int dist(Coordinate a, Coordinate b)
+{
+    return abs(a.x - b.x) + abs(a.y - b.y);
+}
+
+int route_length(Coordinate start, const Coordinate *stops, const int *order, int count)
+{
+    int length = 0;
+    Coordinate at = start;
+    for (int i = 0; i < count; i++)
+    {
+        length += dist(at, stops[order[i]]);
+        at = stops[order[i]];
+    }
+    return length;
+}
+
+static void nearest_neighbor(Coordinate start, const Coordinate *stops, int count, int *order)
+{
+    char *used = calloc((size_t)count, 1);
+    if (!used)
+    { // Sıralama yapılamıyor: verilen sıra da geçerli bir rota
+        for (int i = 0; i < count; i++)
+            order[i] = i;
+        return;
+    }
+    Coordinate at = start;
+    for (int k = 0; k < count; k++)
+    {
+        int best = -1;
+        for (int i = 0; i < count; i++)
+            if (!used[i] && (best < 0 || dist(at, stops[i]) < dist(at, stops[best])))
+                best = i;
+        used[best] = 1;
+        order[k] = best;
+        at = stops[best];
+    }
+    free(used);
+}
+
+// order[i..j]'yi ters çevirmek sadece iki kenarı değiştirir: (önceki, i) ve
+// (j, sonraki) yerine (önceki, j) ve (i, sonraki). Yol açık olduğundan son
+// durağın sonrası yoktur; başlangıç noktası yerinden oynamaz.
+static int two_opt(Coordinate start, const Coordinate *stops, int count, int *order)
+{
+    int swaps = 0;
+    bool improved = true;
+    while (improved)
+    {
+        improved = false;
+        for (int i = 0; i < count - 1; i++)
+        {
+            Coordinate before = i == 0 ? start : stops[order[i - 1]];
+            for (int j = i + 1; j < count; j++)
+            {
+                Coordinate first = stops[order[i]], last = stops[order[j]];
+                int delta = dist(before, last) - dist(before, first);
+                if (j + 1 < count)
+                {
+                    Coordinate after = stops[order[j + 1]];
+                    delta += dist(first, after) - dist(last, after);
+                }
+                if (delta >= 0)
+                    continue;
+                for (int a = i, b = j; a < b; a++, b--)
+                {
+                    int tmp = order[a];
+                    order[a] = order[b];
+                    order[b] = tmp;
+                }
+                swaps++;
+                improved = true;
+            }
+        }
+    }
+    return swaps;
+}
+
+int route_plan(Coordinate start, const Coordinate *stops, int count, int budget, int *order, RouteStats *stats)
+{
+    if (count <= 0)
+        return 0;
+    nearest_neighbor(start, stops, count, order);
+    int nn_length = stats ? route_length(start, stops, order, count) : 0;
+    int swaps = two_opt(start, stops, count, order);
+
+    int fitted = 0, length = 0;
+    Coordinate at = start;
+    for (int i = 0; i < count; i++)
+    {
+        length += dist(at, stops[order[i]]);
+        at = stops[order[i]];
+        if (length <= budget)
+            fitted = i + 1;
+    }
+    if (stats)
+    {
+        stats->nn_length = nn_length;
+        stats->length = length;
+        stats->swaps = swaps;
+    }
+    return fitted;
+}
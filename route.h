@@ -0,0 +1,24 @@
+#ifndef ROUTE_H
+#define ROUTE_H
+
+#include "drone.h"
+
+// Çok duraklı görev rotası: sabit başlangıçtan çıkan, geri dönmeyen (açık) yol
+// için gezgin satıcı sezgiseli. Önce en yakın komşu ile bir sıra kurulur, sonra
+// 2-opt ile kesişen kenarlar, iyileşme kalmayana kadar ters çevrilerek açılır.
+// Mesafe Manhattan'dır (drone'lar eksen boyunca hareket eder).
+typedef struct
+{
+    int nn_length; // En yakın komşu sırasının uzunluğu
+    int length;    // 2-opt sonrası tüm durakların uzunluğu
+    int swaps;     // Uygulanan 2-opt ters çevirmesi
+} RouteStats;
+
+// order'a stops indekslerini gidiş sırasıyla yazar. Başlangıçtan itibaren
+// toplam uzunluğu budget'ı aşmayan en uzun ön ekin durak sayısını döndürür
+// (pil kısıtı: drone o duraktan sonrasına gitmez). stats NULL olabilir.
+int route_plan(Coordinate start, const Coordinate *stops, int count, int budget, int *order, RouteStats *stats);
+// start'tan order sırasıyla count durağın toplam uzunluğu.
+int route_length(Coordinate start, const Coordinate *stops, const int *order, int count);
+
+#endif
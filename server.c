@@ -1,3 +1,4 @@
+#define _GNU_SOURCE // pthread_setaffinity_np, CPU_SET
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -13,26 +14,180 @@
 #include <time.h>       // YENİ: Zaman fonksiyonları için
 #include <sys/select.h> // select, fd_set, FD_ZERO, FD_SET, FD_ISSET için
 #include <sys/time.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <sys/random.h>
 #include "list.h"
 #include "drone.h"
 #include "survivor.h"
+#include "uring.h"
+#include "protocol.h"
+#include "outq.h"
+#include "timerwheel.h"
+#include "snapshot.h"
+#include "survgrid.h"
+#include "assign.h"
+#include "region.h"
+#include "epoch.h"
+#include "idtable.h"
+#include "hashmap.h"
+#include "route.h"
+#include "navmap.h"
+#include "slab.h"
+#include <sys/un.h>
 // #include "view.h" // Eğer view.h sadece view_thread prototipi içeriyorsa ve burada kullanılmıyorsa kaldırılabilir.
 
 #define PORT 8080
 #define VIEW_PORT 8081
+#define TELEMETRY_PORT 8082 // --udp: shard i, TELEMETRY_PORT + i'yi dinler
+#define VIEW_UNIX_PATH "/tmp/drone_server_view.sock" // Aynı makinedeki view'lar için kontrol soketi
+#define VIEW_TICK_MS 100   // Paylaşımlı bellek görüntüsü bu aralıkla yayınlanır
+#define VIEW_JSON_TICKS 10 // TCP view'lara JSON her VIEW_JSON_TICKS turda bir (1 sn)
 #define MAX_DRONES 50
+#define MAX_EPOLL_EVENTS 256
+#define MAX_REACTORS 64
 #define MAX_VIEWS 10
 #define RECV_BUFFER_SIZE 4096
-#define PROCESS_BUFFER_SIZE (RECV_BUFFER_SIZE * 2)
+#define URING_ENTRIES 1024
+#define URING_BUF_COUNT 256 // Shard başına sağlanan recv tamponu (2'nin kuvveti)
+#define URING_BUF_GROUP 1
+
+#define OUTBOUND_SOFT_LIMIT (16 * 1024)  // Üstünde heartbeat'ler atlanır
+#define OUTBOUND_HARD_LIMIT (256 * 1024) // Üstünde yavaş tüketicinin bağlantısı kesilir
+
+#define HEARTBEAT_INTERVAL_MS 10000 // Heartbeat gönderme aralığı
+#define DRONE_TIMEOUT_MS 30000      // Drone'dan bu süre haber alınamazsa bağlantı kesilir
+
+#define TELEMETRY_BATCH 32             // recvmmsg başına en fazla datagram
+#define TELEMETRY_RCVBUF (64 * 1024)   // Telemetri eskir: büyük kuyruk sadece bayat veri biriktirir
+#define TELEMETRY_INITIAL_SESSIONS 64
+
+#define MAP_X_LIMIT 40        // Survivor koordinatları: 0 <= x < 40
+#define MAP_Y_LIMIT 60        //                         0 <= y < 60
+#define SURVIVOR_GRID_CELL 8  // Uzamsal indeks hücre kenarı
+#define CONTROLLER_SWEEP_MS 2000 // Olay kaçsa bile atama bu aralıkla yeniden denenir
+#define CONTROLLER_REGION_CELLS 2 // --assign region: bölge kenarı (ızgara hücresi)
+#define FLEET_PUBLISH_MS 20       // Olay yokken drone görüntüsü en fazla bu sıklıkta yenilenir
+#define QUEUE_MIN_BATTERY 20      // Bu pilin altındaki drone'a sıradaki görev verilmez; rota bu yedeği korur
+#define ROUTE_CLUSTER_RADIUS 6    // Rotanın son durağına bu kadar yakın survivor'lar aynı drone'a eklenir
+#define NAV_UNREACHABLE_BENEFIT (-1000000) // Toplu atamada ulaşılamayan survivor'ın faydası
+
+// Drone ve view soketleri için G/Ç altyapısı; başlangıçta --io ile seçilir.
+typedef enum
+{
+    IO_BACKEND_EPOLL,
+    IO_BACKEND_URING
+} IoBackend;
+
+// Controller'ın atama stratejisi; başlangıçta --assign ile seçilir.
+typedef enum
+{
+    ASSIGN_GREEDY, // Drone'lar sırayla en iyi survivor'ı alır
+    ASSIGN_BATCH,  // Tüm boştaki drone'lar birlikte, açık artırmayla
+    ASSIGN_REGION  // Harita bölgelerinde paralel, iş çalan işçilerle
+} AssignMode;
+
+struct DroneConn;
+
+// Bir shard'ın drone'larının değişmez görüntüsü. Sadece shard thread'i oluşturur
+// ve işaretçiyi atomik olarak değiştirir; eskisi epoch_retire ile, onu görebilecek
+// okuyucular çıkınca silinir. Controller ve view yayını görüntüyü epoch_enter/exit
+// arasında ne liste ne drone kilidi almadan gezer.
+typedef struct
+{
+    Drone *drone; // Atama için; işaretçi okuyucunun epoch'u boyunca geçerli
+    int id;
+    DroneStatus status;
+    Coordinate coord;
+    Coordinate target;
+    int battery;
+    int route_len;       // Rotada sıraya alınmış durak
+    int route_capacity;  // Drone'un kabul ettiği durak sayısı (0: QUEUE_MISSION yok)
+} FleetEntry;
+
+typedef struct
+{
+    int count;
+    FleetEntry entries[];
+} FleetSnapshot;
 
-#define HEARTBEAT_INTERVAL 10 // YENİ: Saniye cinsinden heartbeat gönderme aralığı
-#define DRONE_TIMEOUT 30      // YENİ: Saniye cinsinden drone'dan haber alınamazsa zaman aşımı
+// SO_REUSEPORT ile 8080'i dinleyen reactor thread'lerinden biri. Her shard kendi
+// bağlantılarına ve drone listesine sahiptir; çekirdek yeni bağlantıları shard'lara dağıtır.
+typedef struct ReactorShard
+{
+    int index;
+    int listen_fd;
+    int epoll_fd;
+    int wake_fd; // eventfd: controller'dan gelen komutlar için uyandırma
+    int udp_fd;  // --udp: shard'ın telemetri soketi, kapalıysa -1
+    pthread_t tid;
+    HashMap *drones;             // Shard'a ait Drone*'lar, ID ile
+    List *mailbox;               // ShardCommand*: shard'lar arası tek yol (görev atama)
+    struct DroneConn *conn_head; // Sadece shard'ın kendi thread'i erişir
+    struct DroneConn *flush_head; // Bu turda giden verisi biriken bağlantılar
+    TimerWheel timers;            // Heartbeat ve zaman aşımı zamanlayıcıları
+    uint64_t now_ms;              // Turun başında okunan monotonic zaman
+    Uring ring;                  // Sadece IO_BACKEND_URING
+    UringBufRing bufs;           // Multishot recv için sağlanan tamponlar
+    // UDP oturum tablosu: datagramdaki slot doğrudan indekstir, session anahtarı doğrular
+    struct DroneConn **sessions;
+    uint32_t session_count; // Şimdiye kadar kullanılan en yüksek slot + 1
+    uint32_t session_cap;
+    uint32_t *free_sessions; // Geri verilen slotlar (yığın)
+    uint32_t free_session_count;
+    FleetSnapshot *fleet;        // Yayınlanan görüntü; okuyucular epoch içinde atomik yükler
+    bool fleet_dirty;            // Listede veya drone alanlarında yayınlanmamış değişiklik var
+    uint64_t fleet_published_ms;
+    unsigned pending_events;     // Görüntü yayınlanınca controller'a iletilecek olaylar
+    unsigned long stat_messages; // İşlenen drone mesajı sayısı
+    unsigned long stat_bytes_in; // Drone'lardan alınan bayt
+    unsigned long stat_heartbeats_dropped; // Dolu kuyruk nedeniyle atlanan heartbeat
+    unsigned long stat_slow_disconnects;   // OUTBOUND_HARD_LIMIT aşımıyla kesilen bağlantı
+    unsigned long stat_syscalls; // G/Ç sistem çağrısı sayısı (epoll yolu)
+    unsigned long stat_udp_datagrams; // Kabul edilen telemetri datagramı
+    unsigned long stat_udp_stale;     // Sıra numarası eski olduğu için atılan
+    unsigned long stat_udp_rejected;  // Bozuk, kesilmiş veya oturumu tutmayan
+    unsigned long stat_fleet_publishes; // Yayınlanan drone görüntüsü
+} ReactorShard;
 
 // Global değişkenler
-List *drone_list;
-List *survivor_list;
-List *view_sockets;
+IoBackend io_backend = IO_BACKEND_EPOLL;
+AssignMode assign_mode = ASSIGN_GREEDY;
+int controller_workers = 0; // --workers; 0 ise çevrimiçi çekirdek sayısı
+WorkPool *controller_pool = NULL; // Sadece ASSIGN_REGION
+RegionPlanner region_planner;
+
+static const char *assign_mode_name(void)
+{
+    return assign_mode == ASSIGN_BATCH ? "batch" : assign_mode == ASSIGN_REGION ? "region" : "greedy";
+}
+bool binary_protocol_enabled = true; // --json-only ile kapatılır
+bool udp_telemetry_enabled = false;  // --udp ile açılır
+ReactorShard *shards = NULL;
+int shard_count = 0;
+static _Thread_local ReactorShard *current_shard = NULL; // Reactor thread'lerinde kendi shard'ı
+HashMap *drone_table; // Drone ID -> Drone*, tüm shard'lar; yinelenen ID kontrolü ekleme ile atomik
+// Survivor tablosu, uzamsal indeks ve görev tablosu tek kilitle korunur
+pthread_mutex_t survivor_lock = PTHREAD_MUTEX_INITIALIZER;
+IdTable survivor_table;     // Survivor ID -> Survivor*
+IdTable mission_table;      // Görev anahtarı -> Mission* (açık görevler)
+SurvivorGrid survivor_grid; // Atanmamış survivor'lar; survivor_lock ile korunur
+NavMap nav_map;             // Uçuşa yasak bölgeler ve yol önbelleği (--no-fly); kendi kilidi var
+unsigned long stat_rescues = 0;     // survivor_lock ile korunur
+double stat_rescue_seconds = 0.0;   // Oluşturulmadan MISSION_COMPLETE'e kadar geçen toplam süre
+HashMap *view_sockets; // Soket int*'ı (adresiyle anahtarlı) -> aynı int*
+// Bir view soketini kapatıp -1 ile işaretlemek ile ona gönderim arasındaki sıralama;
+// kapanmış soketleri map'ten çıkarıp bırakan da view_broadcast'tir, bu kilitle.
+pthread_mutex_t view_send_lock = PTHREAD_MUTEX_INITIALIZER;
 volatile sig_atomic_t server_running = 1; // YENİ: Sunucunun çalışıp çalışmadığını kontrol eder
+SnapshotRegion *snapshot_region = NULL; // Yerel view'lar için paylaşımlı durum (view_broadcast yazar)
+int snapshot_fd = -1;
+int snapshot_ro_fd = -1; // Yerel view'lara SCM_RIGHTS ile verilen salt okunur tanıtıcı
+int view_unix_fd = -1;
 
 // Sinyal işleyici fonksiyonu
 void signal_handler(int signum)
@@ -41,6 +196,58 @@ void signal_handler(int signum)
     server_running = 0;
 }
 
+// Controller'ı uyandıran olaylar. Bekleyen olaylar bit maskesinde birleşir;
+// controller bir geçişte hepsini tüketir, böylece olay patlamaları tek geçişe iner.
+typedef enum
+{
+    CONTROLLER_SURVIVOR_ADDED = 1 << 0,
+    CONTROLLER_DRONE_IDLE = 1 << 1,
+    CONTROLLER_DRONE_LOST = 1 << 2,
+    CONTROLLER_TARGET_UNASSIGNED = 1 << 3,
+    CONTROLLER_QUEUE_OPEN = 1 << 4 // Drone rotanın sıradaki durağına geçti; rotada yer açıldı
+} ControllerEvent;
+
+pthread_mutex_t controller_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t controller_wakeup; // CLOCK_MONOTONIC ile main'de kurulur
+unsigned controller_events = 0;     // controller_lock ile korunur
+uint64_t controller_event_ns = 0;   // Bekleyen ilk olayın zamanı (gecikme ölçümü)
+
+static uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void controller_signal(unsigned events)
+{
+    pthread_mutex_lock(&controller_lock);
+    if (controller_events == 0)
+        controller_event_ns = monotonic_ns();
+    controller_events |= events;
+    pthread_cond_signal(&controller_wakeup);
+    pthread_mutex_unlock(&controller_lock);
+}
+
+// Reactor thread'inde olay, shard'ın drone görüntüsü yayınlanana kadar (tur sonu)
+// bekletilir; aksi halde controller değişikliği görmeden uyanırdı.
+void controller_notify(ControllerEvent event)
+{
+    if (current_shard)
+    {
+        current_shard->pending_events |= event;
+        return;
+    }
+    controller_signal(event);
+}
+
+// Çağıran reactor thread'inin drone görüntüsünü bayat olarak işaretler.
+static void fleet_mark_dirty(void)
+{
+    if (current_shard)
+        current_shard->fleet_dirty = true;
+}
+
 int compare_drone_by_id_ptr(void *a, void *b)
 { // Karşılaştırma için ID'yi alır
     Drone *d1 = (Drone *)a;
@@ -48,11 +255,6 @@ int compare_drone_by_id_ptr(void *a, void *b)
     return d1->id - id_b;
 }
 
-int compare_drone_by_ptr(void *a, void *b)
-{                                            // İki drone pointer'ını karşılaştırır
-    return (Drone *)a == (Drone *)b ? 0 : 1; // Veya ID'lerine göre de olabilir: return ((Drone*)a)->id - ((Drone*)b)->id;
-}
-
 int compare_survivor_by_id_ptr(void *a, void *b)
 {
     Survivor *s1 = (Survivor *)a;
@@ -70,540 +272,2308 @@ void send_json_to_socket(int sock, json_object *jobj)
         fprintf(stderr, "Error: json_object_to_json_string_ext failed.\n");
         return;
     }
+    // Mesaj ve ayırıcı tek bir sendmsg ile gönderilir (eskiden iki ayrı send).
+    struct iovec iov[2] = {{.iov_base = (void *)str, .iov_len = strlen(str)},
+                           {.iov_base = "\n", .iov_len = 1}};
+    struct msghdr msg = {.msg_iov = iov, .msg_iovlen = 2};
     // MSG_NOSIGNAL, yazma işlemi sırasında soket aniden kapanırsa SIGPIPE sinyalini önler.
-    if (send(sock, str, strlen(str), MSG_NOSIGNAL) < 0)
+    if (sendmsg(sock, &msg, MSG_NOSIGNAL) < 0)
+    {
+        // perror("send_json: sendmsg failed"); // Çok fazla log üretebilir
+    }
+}
+
+// Controller'ın verdiği, henüz tamamlanmamış görev. mission_table'da, ASSIGN_MISSION
+// ile gönderilen mission_id metninin özetiyle tutulur; survivor_lock ile korunur.
+// Tamamlama ve iptal, survivor'ı koordinatla aramak yerine buradan kesin olarak bulur.
+typedef struct
+{
+    uint64_t key;
+    int drone_id;
+    int survivor_id;
+    time_t issued;
+} Mission;
+
+void format_mission_id(char *buf, size_t size, int drone_id, int survivor_id, time_t issued)
+{
+    snprintf(buf, size, "M_Ctrl_D%dS%d_T%ld", drone_id, survivor_id, (long)issued);
+}
+
+// Drone'a survivor için yeni bir görev kaydı açar (survivor_lock tutulurken). Bellek yoksa NULL.
+Mission *open_mission(const Drone *drone, const Survivor *s)
+{
+    Mission *m = malloc(sizeof(Mission));
+    if (!m)
+        return NULL;
+    char mission_id[MISSION_ID_LEN];
+    m->drone_id = drone->id;
+    m->survivor_id = s->id;
+    m->issued = time(NULL);
+    format_mission_id(mission_id, sizeof(mission_id), m->drone_id, m->survivor_id, m->issued);
+    m->key = idtable_hash_str(mission_id);
+    free(idtable_remove(&mission_table, m->key)); // Aynı saniyede aynı çift: eskisi geçersiz
+    if (!idtable_put(&mission_table, m->key, m))
+    {
+        free(m);
+        return NULL;
+    }
+    return m;
+}
+
+// Görevi tamamlanmadan kapatır; survivor yeniden atanabilir olur. survivor_lock tutulurken.
+void release_mission_locked(uint64_t mission_key)
+{
+    Mission *m = idtable_remove(&mission_table, mission_key);
+    Survivor *s = m ? idtable_get(&survivor_table, (uint64_t)m->survivor_id) : NULL;
+    if (s && s->is_targeted)
+    {
+        s->is_targeted = false;
+        survgrid_insert(&survivor_grid, s);
+        printf("INFO: Survivor S%d at (%d,%d) is now unassigned due to drone issue.\n",
+               s->id, s->coord.x, s->coord.y);
+        controller_notify(CONTROLLER_TARGET_UNASSIGNED);
+    }
+    free(m);
+}
+
+// Controller'a giden survivor olayları. Üreticiler (survivor üreteci, reactor'ların
+// MISSION_COMPLETE ve bağlantı kopması işleyicileri) survivor_lock'u beklemeden
+// kilitsiz kuyruğa ekler; controller her geçişin başında hepsini tek kilitle uygular.
+typedef enum
+{
+    SURVIVOR_CREATED,  // survivor tabloya ve ızgaraya girer
+    SURVIVOR_RESCUED,  // drone_id'nin mission_key görevi tamamlandı
+    SURVIVOR_RELEASED  // mission_key görevi bitmeden kapandı; survivor yeniden atanabilir
+} SurvivorEventType;
+
+typedef struct
+{
+    SurvivorEventType type;
+    Survivor *survivor;
+    uint64_t mission_key;
+    int drone_id;
+    Coordinate target; // Drone'un tamamladığını bildirdiği hedef
+} SurvivorEvent;
+
+MpscQueue survivor_events;
+unsigned long stat_survivor_events = 0; // Controller'ın uyguladığı olay
+
+// Görevi kapatıp survivor'ı kaldırır. survivor_lock tutulurken.
+static void rescue_survivor_locked(uint64_t mission_key, int drone_id, Coordinate target)
+{
+    Mission *m = mission_key ? idtable_get(&mission_table, mission_key) : NULL;
+    if (m && m->drone_id != drone_id)
+        m = NULL; // Başka bir drone'un görevi
+    Survivor *s = NULL;
+    if (m)
     {
-        // perror("send_json: send string failed"); // Çok fazla log üretebilir
+        idtable_remove(&mission_table, mission_key);
+        s = idtable_remove(&survivor_table, (uint64_t)m->survivor_id);
     }
-    if (send(sock, "\n", 1, MSG_NOSIGNAL) < 0)
+    if (s)
     {
-        // perror("send_json: send newline failed");
+        printf("Survivor S%d at (%d,%d) rescued by drone D%d. Removing from list.\n",
+               s->id, s->coord.x, s->coord.y, drone_id);
+        survgrid_remove(&survivor_grid, s);
+        navmap_forget(&nav_map, s->coord);
+        stat_rescues++;
+        stat_rescue_seconds += difftime(time(NULL), s->creation_time);
+        free_survivor(s);
     }
+    else
+    {
+        printf("Warning: Drone D%d completed mission at target (%d,%d), but no matching survivor found or already removed.\n",
+               drone_id, target.x, target.y);
+    }
+    free(m);
 }
 
-// YENİ: Bir survivor'ın hedefini kaldırmak için yardımcı fonksiyon
-void unassign_survivor_target(Coordinate target_coord)
+static void apply_survivor_event_locked(const SurvivorEvent *event)
 {
-    pthread_mutex_lock(&survivor_list->lock);
-    Node *s_node = survivor_list->head;
-    while (s_node)
+    switch (event->type)
     {
-        Survivor *s = (Survivor *)s_node->data;
-        if (s->coord.x == target_coord.x && s->coord.y == target_coord.y && s->is_targeted)
+    case SURVIVOR_CREATED:
+        if (!idtable_put(&survivor_table, (uint64_t)event->survivor->id, event->survivor))
         {
-            s->is_targeted = false;
-            printf("INFO: Survivor S%d at (%d,%d) is now unassigned due to drone issue.\n",
-                   s->id, s->coord.x, s->coord.y);
-            break; // Genellikle bir hedefe sadece bir survivor atanır
+            navmap_forget(&nav_map, event->survivor->coord);
+            free_survivor(event->survivor);
+            break;
         }
-        s_node = s_node->next;
+        survgrid_insert(&survivor_grid, event->survivor);
+        break;
+    case SURVIVOR_RESCUED:
+        rescue_survivor_locked(event->mission_key, event->drone_id, event->target);
+        break;
+    case SURVIVOR_RELEASED:
+        release_mission_locked(event->mission_key);
+        break;
     }
-    pthread_mutex_unlock(&survivor_list->lock);
 }
 
-void *handle_drone(void *arg)
+// Her thread'den çağrılabilir; kilit beklemez.
+static void post_survivor_event(SurvivorEvent event)
 {
-    int sock = *(int *)arg;
-    free(arg);
-
-    char recv_buffer[RECV_BUFFER_SIZE];
-    char process_buffer[PROCESS_BUFFER_SIZE] = {0};
-    int process_buffer_len = 0;
-    Drone *drone_obj = NULL; // Bu thread'e ait drone nesnesi
-    time_t last_heartbeat_sent_time = time(NULL);
+    SurvivorEvent *copy = malloc(sizeof(SurvivorEvent));
+    if (copy)
+    {
+        *copy = event;
+        if (mpsc_push(&survivor_events, copy))
+            return;
+        free(copy);
+    }
+    // Bellek yok: olayı kaybetmektense kilidi bekleyip hemen uygula
+    pthread_mutex_lock(&survivor_lock);
+    apply_survivor_event_locked(&event);
+    pthread_mutex_unlock(&survivor_lock);
+}
 
-    printf("Drone handler thread started for socket %d\n", sock);
+// Kuyruktaki olayları geliş sırasıyla uygular. survivor_lock tutulurken, tek tüketici
+// olan controller'dan (kapanışta, tüm üreticiler durduktan sonra main'den) çağrılır.
+static void drain_survivor_events_locked(void)
+{
+    SurvivorEvent *event;
+    while ((event = mpsc_pop(&survivor_events)) != NULL)
+    {
+        apply_survivor_event_locked(event);
+        free(event);
+        stat_survivor_events++;
+    }
+}
 
-    // select için zaman aşımı ayarı
-    struct timeval tv;
-    fd_set read_fds;
+void unassign_mission(uint64_t mission_key)
+{
+    post_survivor_event((SurvivorEvent){.type = SURVIVOR_RELEASED, .mission_key = mission_key});
+}
 
-    while (server_running && sock > 0)
+// Tek bir drone bağlantısının reactor tarafındaki durumu.
+// Her bağlantı, onu accept eden shard'ın epoll örneğine aittir.
+typedef struct DroneConn
+{
+    int sock;
+    ReactorShard *shard;
+    // HANDSHAKE'te kaydedilen drone'lar: normal bağlantıda en fazla bir, gateway'de
+    // "drone_ids" ile gelen hepsi. Hepsinin drone->sock'u bu bağlantının soketidir.
+    Drone **drones;
+    int drone_count; // Handshake tamamlanana kadar 0
+    int drone_cap;
+    bool gateway;
+    bool binary;  // HANDSHAKE'te ikili çerçeveleme anlaşıldı (protocol.h)
+    ProtoStream *stream; // Gelen veri halkası + artımlı JSON tokener
+    uint64_t last_message_ms; // Son mesajın zamanı (shard->now_ms); kilitsiz, sadece reactor yazar
+    Timer heartbeat_timer;
+    Timer timeout_timer; // Tembel: sadece DRONE_TIMEOUT_MS'de bir tetiklenir, mesajlar onu taşımaz
+    uint32_t udp_session;  // 0: UDP telemetri yok; aksi halde shard->sessions[udp_slot] bu bağlantı
+    uint32_t udp_slot;
+    uint32_t udp_last_seq; // Kabul edilen son datagram; udp_seen false iken geçersiz
+    bool udp_seen;
+    struct DroneConn *prev; // Shard'ın bağlantı listesi (O(1) çıkarma için çift yönlü)
+    struct DroneConn *next;
+
+    // Giden veri asla doğrudan sokete yazılmaz: kuyruğa eklenir ve reactor turunun
+    // sonunda tek bir sendmsg (writev) ile boşaltılır.
+    OutQueue out;
+    bool flush_queued; // shard->flush_head listesinde
+    bool want_write;   // epoll: soket tamponu dolu, EPOLLOUT bekleniyor
+    bool overflowed;   // OUTBOUND_HARD_LIMIT aşıldı; flush aşamasında kapatılır
+    struct DroneConn *flush_next;
+
+    bool closing;
+    // Sadece IO_BACKEND_URING: kernel'de bekleyen işlemler bitene kadar bağlantı serbest bırakılmaz
+    int inflight; // Tamamlanmamış SQE sayısı (multishot recv + sendmsg)
+    bool sending; // Kernel'de bir sendmsg var; send_iov/send_msg ona ait
+    struct iovec send_iov[OUTQ_MAX_IOV];
+    struct msghdr send_msg;
+} DroneConn;
+
+// io_uring user_data: hizalı pointer'ın alt 3 biti işlem türünü taşır
+#define URING_TAG_ACCEPT 1ULL
+#define URING_TAG_WAKE 2ULL
+#define URING_TAG_RECV 3ULL
+#define URING_TAG_SEND 4ULL
+#define URING_TAG_TELEMETRY 5ULL
+#define URING_TAG_MASK 7ULL
+#define URING_DRAIN_MS 1000 // Kapanışta bekleyen işlemlerin CQE'leri için üst sınır
+
+void close_drone_conn(DroneConn *conn);
+void drone_heartbeat_due(Timer *timer, void *arg);
+void drone_timeout_due(Timer *timer, void *arg);
+void telemetry_session_close(DroneConn *conn);
+
+DroneConn **conn_by_fd = NULL; // Soket numarasına göre bağlantı (her fd tek bir shard'a ait)
+size_t conn_by_fd_size = 0;
+
+// Controller'dan shard'a gönderilen görev ataması. Shard'lar arası tek yol budur:
+// controller soketlere doğrudan yazmaz, sahibi olan reactor'a iletir. Mesaj,
+// bağlantının anlaştığı biçimde (JSON veya ikili) reactor'da kodlanır.
+typedef struct
+{
+    Drone *drone;
+    Coordinate target;
+    int survivor_id;
+    time_t issued;
+    bool queued; // QUEUE_MISSION: mevcut görevden sonra
+    Waypoints path; // Ayağın dönüş noktaları; mesajdan önce (ikilide WAYPOINT çerçeveleri) gider
+} ShardCommand;
+
+DroneConn *create_drone_conn(ReactorShard *shard, int sock)
+{
+    DroneConn *conn = calloc(1, sizeof(DroneConn));
+    if (!conn)
+        return NULL;
+    conn->stream = create_proto_stream(RECV_BUFFER_SIZE);
+    if (!conn->stream)
     {
-        FD_ZERO(&read_fds);
-        FD_SET(sock, &read_fds);
-        tv.tv_sec = 1; // 1 saniye timeout (heartbeat ve server_running kontrolü için)
-        tv.tv_usec = 0;
+        free(conn);
+        return NULL;
+    }
+    conn->sock = sock;
+    conn->shard = shard;
+    outq_init(&conn->out);
+    conn->last_message_ms = shard->now_ms;
+    timer_init(&conn->heartbeat_timer, drone_heartbeat_due, conn);
+    timer_init(&conn->timeout_timer, drone_timeout_due, conn);
+    // Handshake yapmadan sessiz kalan bağlantılar da aynı süre sonunda düşürülür
+    timer_schedule(&shard->timers, &conn->timeout_timer, shard->now_ms + DRONE_TIMEOUT_MS);
+    conn->prev = NULL;
+    conn->next = shard->conn_head;
+    if (shard->conn_head)
+        shard->conn_head->prev = conn;
+    shard->conn_head = conn;
+    if ((size_t)sock < conn_by_fd_size)
+        conn_by_fd[sock] = conn;
+    return conn;
+}
 
-        int activity = select(sock + 1, &read_fds, NULL, NULL, &tv);
+void conn_schedule_flush(DroneConn *conn)
+{
+    if (conn->flush_queued)
+        return;
+    conn->flush_queued = true;
+    conn->flush_next = conn->shard->flush_head;
+    conn->shard->flush_head = conn;
+}
 
-        if (activity < 0 && errno != EINTR)
-        { // EINTR sinyal kesmesidir, hata değil
-            perror("select error in handle_drone");
-            break;
-        }
+// Bağlantının kuyruğuna veri ekler (JSON satırı için append_newline ile '\n').
+// Ağa hiç dokunmaz; gönderim flush_pending_conns'ta olur.
+void conn_send_raw(DroneConn *conn, const char *str, size_t len, bool append_newline)
+{
+    if (conn->closing || conn->overflowed)
+        return;
+    if (conn->out.bytes + len > OUTBOUND_HARD_LIMIT || !outq_append(&conn->out, str, len, append_newline))
+        conn->overflowed = true; // Yavaş tüketici: flush aşamasında bağlantı kesilir
+    conn_schedule_flush(conn);
+}
 
-        if (!server_running)
-            break; // Sunucu kapanıyor
+// Kuyruktaki veriyi gönderir. epoll yolunda soket tamponu dolana kadar sendmsg
+// yapılır ve kalan veri için EPOLLOUT istenir; io_uring yolunda tek bir SENDMSG
+// hazırlanır. Bağlantı kapatıldıysa false döner.
+bool flush_conn(DroneConn *conn)
+{
+    if (conn->closing)
+        return false;
 
-        // Heartbeat gönderme zamanı geldi mi? (Sadece drone_obj oluşturulduktan sonra)
-        if (drone_obj && difftime(time(NULL), last_heartbeat_sent_time) >= HEARTBEAT_INTERVAL)
+    if (io_backend == IO_BACKEND_URING)
+    {
+        if (conn->sending)
+            return true; // Tamamlandığında kalan veri için tekrar çağrılır
+        int iovcnt = outq_fill_iov(&conn->out, conn->send_iov, OUTQ_MAX_IOV);
+        if (iovcnt == 0)
+            return true;
+        struct io_uring_sqe *sqe = uring_get_sqe(&conn->shard->ring);
+        if (!sqe)
         {
-            json_object *hb_jobj = json_object_new_object();
-            json_object_object_add(hb_jobj, "type", json_object_new_string("HEARTBEAT"));
-            // printf("Server: Sending HEARTBEAT to Drone D%d (sock %d)\n", drone_obj->id, sock);
-            send_json_to_socket(sock, hb_jobj);
-            json_object_put(hb_jobj);
-            last_heartbeat_sent_time = time(NULL);
+            conn_schedule_flush(conn); // Bir sonraki turda tekrar denenir
+            return true;
         }
+        memset(&conn->send_msg, 0, sizeof(conn->send_msg));
+        conn->send_msg.msg_iov = conn->send_iov;
+        conn->send_msg.msg_iovlen = iovcnt;
+        uring_prep_sendmsg(sqe, conn->sock, &conn->send_msg, (uint64_t)(uintptr_t)conn | URING_TAG_SEND);
+        conn->sending = true;
+        conn->inflight++;
+        return true;
+    }
 
-        if (FD_ISSET(sock, &read_fds))
-        { // Sokette veri var
-            int len = recv(sock, recv_buffer, sizeof(recv_buffer) - 1, 0);
-            if (len <= 0)
+    bool blocked = false;
+    while (conn->out.bytes > 0)
+    {
+        struct iovec iov[OUTQ_MAX_IOV];
+        struct msghdr msg = {.msg_iov = iov, .msg_iovlen = outq_fill_iov(&conn->out, iov, OUTQ_MAX_IOV)};
+        conn->shard->stat_syscalls++;
+        ssize_t sent = sendmsg(conn->sock, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
             {
-                if (len == 0)
-                    printf("Drone disconnected (socket: %d)\n", sock);
-                else
-                    perror("recv failed for drone socket");
+                blocked = true;
                 break;
             }
-            recv_buffer[len] = '\0';
+            fprintf(stderr, "send failed for drone socket %d: %s\n", conn->sock, strerror(errno));
+            close_drone_conn(conn);
+            return false;
+        }
+        outq_advance(&conn->out, sent);
+    }
 
-            if (process_buffer_len + len < PROCESS_BUFFER_SIZE)
-            {
-                memcpy(process_buffer + process_buffer_len, recv_buffer, len);
-                process_buffer_len += len;
-                process_buffer[process_buffer_len] = '\0';
-            }
-            else
-            {
-                fprintf(stderr, "Process buffer overflow for drone socket %d. Discarding data.\n", sock);
-                process_buffer[0] = '\0';
-                process_buffer_len = 0;
-                continue;
-            }
+    if (blocked != conn->want_write)
+    {
+        struct epoll_event ev = {.events = EPOLLIN | EPOLLRDHUP | (blocked ? EPOLLOUT : 0), .data.ptr = conn};
+        epoll_ctl(conn->shard->epoll_fd, EPOLL_CTL_MOD, conn->sock, &ev);
+        conn->want_write = blocked;
+    }
+    return true;
+}
 
-            char *msg_start = process_buffer;
-            char *msg_end;
+// Reactor turunun sonunda bu turda veri biriken tüm bağlantıları boşaltır.
+// Böylece aynı bağlantıya giden birden fazla mesaj tek sistem çağrısında birleşir.
+void flush_pending_conns(ReactorShard *shard)
+{
+    while (shard->flush_head)
+    {
+        DroneConn *conn = shard->flush_head;
+        shard->flush_head = conn->flush_next;
+        conn->flush_queued = false;
+        if (conn->overflowed)
+        {
+            printf("Drone socket %d exceeded %d bytes of unsent data (slow consumer). Disconnecting.\n",
+                   conn->sock, OUTBOUND_HARD_LIMIT);
+            shard->stat_slow_disconnects++;
+            close_drone_conn(conn);
+            continue;
+        }
+        flush_conn(conn);
+    }
+}
 
-            while ((msg_end = strchr(msg_start, '\n')) != NULL)
-            {
-                *msg_end = '\0';
-                json_object *jobj = json_tokener_parse(msg_start);
-                if (!jobj)
-                {
-                    fprintf(stderr, "Failed to parse JSON from drone socket %d: %s\n", sock, msg_start);
-                    msg_start = msg_end + 1;
-                    continue;
-                }
+void conn_send_json(DroneConn *conn, json_object *jobj)
+{
+    const char *str = json_object_to_json_string_ext(jobj, JSON_C_TO_STRING_PLAIN | JSON_C_TO_STRING_NOSLASHESCAPE);
+    if (str)
+        conn_send_raw(conn, str, strlen(str), true);
+}
 
-                const char *type_str = json_object_get_string(json_object_object_get(jobj, "type"));
-                if (!type_str)
-                {
-                    fprintf(stderr, "Received JSON from drone socket %d without 'type' field.\n", sock);
-                    json_object_put(jobj);
-                    msg_start = msg_end + 1;
-                    continue;
-                }
+void conn_send_frame(DroneConn *conn, const ProtoMessage *msg)
+{
+    uint8_t frame[PROTO_MAX_FRAME];
+    size_t len = proto_encode(msg, frame, sizeof(frame));
+    if (len)
+        conn_send_raw(conn, (const char *)frame, len, false);
+}
 
-                // Drone'dan bir mesaj geldi, son mesaj zamanını güncelle
-                if (drone_obj)
-                {
-                    pthread_mutex_lock(&drone_obj->lock);
-                    drone_obj->last_message_time = time(NULL);
-                    pthread_mutex_unlock(&drone_obj->lock);
-                }
+void send_assign_mission(DroneConn *conn, const ShardCommand *cmd)
+{
+    if (conn->binary)
+    {
+        for (int i = 0; i < cmd->path.count; i++)
+        {
+            ProtoMessage point = {.type = MSG_WAYPOINT, .drone_id = cmd->drone->id,
+                                  .x = cmd->path.points[i].x, .y = cmd->path.points[i].y};
+            conn_send_frame(conn, &point);
+        }
+        ProtoMessage msg = {.type = cmd->queued ? MSG_QUEUE_MISSION : MSG_ASSIGN_MISSION,
+                            .drone_id = cmd->drone->id,
+                            .x = cmd->target.x,
+                            .y = cmd->target.y,
+                            .mission_id = (uint32_t)cmd->survivor_id};
+        conn_send_frame(conn, &msg);
+        return;
+    }
+    json_object *mission_jobj = json_object_new_object();
+    json_object_object_add(mission_jobj, "type", json_object_new_string(cmd->queued ? "QUEUE_MISSION" : "ASSIGN_MISSION"));
+    char drone_id_str[16]; // Gateway bağlantılarında hedef drone'u ayırt etmek için
+    snprintf(drone_id_str, sizeof(drone_id_str), "D%d", cmd->drone->id);
+    json_object_object_add(mission_jobj, "drone_id", json_object_new_string(drone_id_str));
+    char mission_id_str[MISSION_ID_LEN];
+    format_mission_id(mission_id_str, sizeof(mission_id_str), cmd->drone->id, cmd->survivor_id, cmd->issued);
+    json_object_object_add(mission_jobj, "mission_id", json_object_new_string(mission_id_str));
+    json_object *target_loc_jobj = json_object_new_object();
+    json_object_object_add(target_loc_jobj, "x", json_object_new_int(cmd->target.x));
+    json_object_object_add(target_loc_jobj, "y", json_object_new_int(cmd->target.y));
+    json_object_object_add(mission_jobj, "target", target_loc_jobj);
+    if (cmd->path.count > 0)
+    {
+        json_object *waypoints = json_object_new_array();
+        for (int i = 0; i < cmd->path.count; i++)
+        {
+            json_object *point = json_object_new_object();
+            json_object_object_add(point, "x", json_object_new_int(cmd->path.points[i].x));
+            json_object_object_add(point, "y", json_object_new_int(cmd->path.points[i].y));
+            json_object_array_add(waypoints, point);
+        }
+        json_object_object_add(mission_jobj, "waypoints", waypoints);
+    }
+    conn_send_json(conn, mission_jobj);
+    json_object_put(mission_jobj);
+}
 
-                if (strcmp(type_str, "HANDSHAKE") == 0)
-                {
-                    const char *drone_id_json = json_object_get_string(json_object_object_get(jobj, "drone_id"));
-                    if (!drone_id_json)
-                    { /* Hata işleme */
-                        msg_start = msg_end + 1;
-                        json_object_put(jobj);
-                        continue;
-                    }
-
-                    char id_str_buf[20];
-                    strncpy(id_str_buf, drone_id_json, sizeof(id_str_buf) - 1);
-                    id_str_buf[sizeof(id_str_buf) - 1] = '\0';
-                    char *id_ptr = id_str_buf;
-                    if (id_ptr[0] == 'D' || id_ptr[0] == 'd')
-                        id_ptr++;
-                    int id = atoi(id_ptr);
-
-                    bool exists = false;
-                    pthread_mutex_lock(&drone_list->lock);
-                    Node *temp_node = drone_list->head;
-                    while (temp_node)
-                    {
-                        Drone *existing_drone = (Drone *)temp_node->data;
-                        if (existing_drone->id == id)
-                        {
-                            exists = true;
-                            break;
-                        }
-                        temp_node = temp_node->next;
-                    }
-                    pthread_mutex_unlock(&drone_list->lock);
-
-                    if (exists)
-                    {
-                        printf("Drone D%d (socket %d) already connected. Closing new connection.\n", id, sock);
-                        json_object_put(jobj);
-                        // Yinelenen bağlantı için ACK göndermeden kapat
-                        close(sock);
-                        sock = -1; // Bu thread'in sonlanması için
-                        // drone_obj NULL kalacak ve temizlikte sorun olmayacak
-                        msg_start = msg_end + 1; // Sonraki mesaja geç (gerçi bağlantı kapanacak)
-                        // Döngüden çıkmak için break;
-                        goto cleanup_and_exit; // Daha temiz
-                    }
-
-                    drone_obj = create_drone(id, -1, -1);
-                    if (!drone_obj)
-                    { /* Hata işleme */
-                        msg_start = msg_end + 1;
-                        json_object_put(jobj);
-                        continue;
-                    }
-                    drone_obj->sock = sock;
-                    pthread_mutex_lock(&drone_obj->lock); // last_message_time için
-                    drone_obj->last_message_time = time(NULL);
-                    pthread_mutex_unlock(&drone_obj->lock);
-
-                    add_list(drone_list, drone_obj);
-                    printf("Drone D%d (socket %d) connected. Handshake successful.\n", id, sock);
+void send_heartbeat(DroneConn *conn, time_t now)
+{
+    // Kuyruk birikmişse heartbeat'e gerek yok: drone zaten önceki veriyi okumakta geride
+    if (conn->out.bytes > OUTBOUND_SOFT_LIMIT)
+    {
+        conn->shard->stat_heartbeats_dropped++;
+        return;
+    }
+    if (conn->binary)
+    {
+        ProtoMessage msg = {.type = MSG_HEARTBEAT, .drone_id = conn->drones[0]->id, .timestamp = (uint32_t)now};
+        conn_send_frame(conn, &msg);
+        return;
+    }
+    json_object *hb_jobj = json_object_new_object();
+    json_object_object_add(hb_jobj, "type", json_object_new_string("HEARTBEAT"));
+    conn_send_json(conn, hb_jobj);
+    json_object_put(hb_jobj);
+}
 
-                    json_object *ack = json_object_new_object();
-                    json_object_object_add(ack, "type", json_object_new_string("HANDSHAKE_ACK"));
-                    // İsteğe bağlı: sunucu kapasitesi, harita boyutu vb. bilgiler eklenebilir.
-                    send_json_to_socket(sock, ack);
-                    json_object_put(ack);
-                }
-                else if (drone_obj && strcmp(type_str, "STATUS_UPDATE") == 0)
-                {
-                    pthread_mutex_lock(&drone_obj->lock);
-                    json_object *loc_obj = json_object_object_get(jobj, "location");
-                    if (loc_obj)
-                    {
-                        drone_obj->coord.x = json_object_get_int(json_object_object_get(loc_obj, "x"));
-                        drone_obj->coord.y = json_object_get_int(json_object_object_get(loc_obj, "y"));
-                    }
-                    const char *status_str = json_object_get_string(json_object_object_get(jobj, "status"));
-                    if (status_str)
-                    {
-                        drone_obj->status = (strcmp(status_str, "idle") == 0) ? IDLE : ON_MISSION;
-                    }
-                    drone_obj->battery = json_object_get_int(json_object_object_get(jobj, "battery"));
-                    // printf("Drone D%d status: (%d,%d), %s, Bat: %d\n", drone_obj->id, drone_obj->coord.x, drone_obj->coord.y, drone_obj->status == IDLE ? "IDLE" : "ON_MISSION", drone_obj->battery);
-                    pthread_mutex_unlock(&drone_obj->lock);
-                }
-                else if (drone_obj && strcmp(type_str, "MISSION_COMPLETE") == 0)
-                {
-                    Coordinate completed_mission_target = {-1, -1}; // GÜNCELLENDİ: Başlangıç değeri
-                    pthread_mutex_lock(&drone_obj->lock);
-                    drone_obj->status = IDLE;
-                    // Hangi görevin tamamlandığı bilgisi client'tan gelmeli
-                    json_object *completed_target_obj = json_object_object_get(jobj, "completed_target");
-                    if (completed_target_obj)
-                    {
-                        completed_mission_target.x = json_object_get_int(json_object_object_get(completed_target_obj, "x"));
-                        completed_mission_target.y = json_object_get_int(json_object_object_get(completed_target_obj, "y"));
-                        printf("Drone D%d reported MISSION_COMPLETE for its target (%d,%d). Current pos: (%d,%d)\n",
-                               drone_obj->id, completed_mission_target.x, completed_mission_target.y, drone_obj->coord.x, drone_obj->coord.y);
-                    }
-                    else
-                    {
-                        // Eski davranış: drone'un mevcut hedefi
-                        completed_mission_target = drone_obj->target;
-                        printf("Drone D%d reported MISSION_COMPLETE (target from drone state: %d,%d). Current pos: (%d,%d)\n",
-                               drone_obj->id, completed_mission_target.x, completed_mission_target.y, drone_obj->coord.x, drone_obj->coord.y);
-                    }
-                    pthread_mutex_unlock(&drone_obj->lock);
-
-                    if (completed_mission_target.x != -1)
-                    { // Geçerli bir hedef varsa
-                        bool survivor_found_and_removed = false;
-                        pthread_mutex_lock(&survivor_list->lock);
-                        Node *current_s_node = survivor_list->head;
-                        Node *prev_s_node = NULL;
-                        while (current_s_node != NULL)
-                        {
-                            Survivor *s = (Survivor *)current_s_node->data;
-                            if (s->coord.x == completed_mission_target.x && s->coord.y == completed_mission_target.y)
-                            {
-                                printf("Survivor S%d at (%d,%d) rescued by drone D%d. Removing from list.\n",
-                                       s->id, s->coord.x, s->coord.y, drone_obj->id);
-                                if (prev_s_node == NULL)
-                                    survivor_list->head = current_s_node->next;
-                                else
-                                    prev_s_node->next = current_s_node->next;
-
-                                Node *to_free = current_s_node;
-                                current_s_node = current_s_node->next;
-                                free_survivor(to_free->data);
-                                free(to_free);
-                                survivor_list->size--;
-                                survivor_found_and_removed = true;
-                                break;
-                            }
-                            prev_s_node = current_s_node;
-                            current_s_node = current_s_node->next;
-                        }
-                        pthread_mutex_unlock(&survivor_list->lock);
-                        if (!survivor_found_and_removed)
-                        {
-                            printf("Warning: Drone D%d completed mission at target (%d,%d), but no matching survivor found or already removed.\n",
-                                   drone_obj->id, completed_mission_target.x, completed_mission_target.y);
-                        }
-                    }
-                    // Yeni görev atama mantığı controller thread'ine bırakıldı.
-                    // Controller periyodik olarak IDLE drone'ları kontrol edecek.
-                }
-                else if (drone_obj && strcmp(type_str, "BATTERY_DEPLETED") == 0)
-                {
-                    printf("Drone D%d battery depleted. (Socket %d)\n", drone_obj->id, sock);
-                    pthread_mutex_lock(&drone_obj->lock);
-                    if (drone_obj->status == ON_MISSION)
-                    {
-                        unassign_survivor_target(drone_obj->target); // GÜNCELLENDİ
-                    }
-                    drone_obj->status = IDLE; // Artık bir şey yapamaz
-                    // drone_obj->sock = 0; // Bu, drone_obj'nin listeden çıkarılmasına yol açacak
-                    pthread_mutex_unlock(&drone_obj->lock);
-                    json_object_put(jobj);
-                    goto cleanup_and_exit; // Temizle ve çık
-                }
-                else if (drone_obj && strcmp(type_str, "HEARTBEAT_ACK") == 0)
-                { // YENİ
-                  // printf("Drone D%d sent HEARTBEAT_ACK.\n", drone_obj->id);
-                  // last_message_time zaten her mesajda güncelleniyor.
-                }
-                else if (drone_obj)
-                {
-                    printf("Drone D%d (socket %d) sent unknown/unhandled message type: %s\n", drone_obj->id, sock, type_str);
-                }
-                else
-                { // drone_obj NULL ise (Handshake öncesi)
-                    printf("Received message type '%s' from socket %d before handshake completed.\n", type_str, sock);
-                }
+// Görev atamasını shard'ın posta kutusuna ekler ve reactor'ı uyandırır.
+// Ağ üzerinde asla bloklamaz; çağıran drone listesi kilidini tutuyor olabilir.
+bool post_mission_to_shard(ReactorShard *shard, Drone *drone, const Survivor *survivor, const Mission *mission,
+                           bool queued, const Waypoints *path)
+{
+    ShardCommand *cmd = malloc(sizeof(ShardCommand));
+    if (!cmd)
+        return false;
+    cmd->drone = drone;
+    cmd->target = survivor->coord;
+    cmd->survivor_id = survivor->id;
+    cmd->issued = mission->issued; // mission_id metni aynı alanlardan yeniden üretilir
+    cmd->queued = queued;
+    cmd->path = *path;
+
+    if (!add_list(shard->mailbox, cmd))
+    {
+        free(cmd);
+        return false;
+    }
+    uint64_t one = 1;
+    if (write(shard->wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+        perror("write to shard wake_fd failed");
+    return true;
+}
 
-                json_object_put(jobj);
-                msg_start = msg_end + 1;
-            }
+void free_shard_command(void *data)
+{
+    free(data);
+}
 
-            if (msg_start != process_buffer && *msg_start != '\0')
-            {
-                size_t remaining_len = process_buffer_len - (msg_start - process_buffer);
-                memmove(process_buffer, msg_start, remaining_len);
-                process_buffer_len = remaining_len;
-                process_buffer[process_buffer_len] = '\0';
-            }
-            else if (*msg_start == '\0')
-            {
-                process_buffer[0] = '\0';
-                process_buffer_len = 0;
-            }
-        }
-        // select'ten sonra ve veri işlendikten sonra buraya gelinir.
-        // Zaman aşımı kontrolü controller thread'inde yapılacak.
+// Posta kutusundaki komutları sırayla (eklenme sırasına göre) gönderir.
+void drain_shard_mailbox(ReactorShard *shard)
+{
+    uint64_t counter;
+    shard->stat_syscalls++;
+    if (read(shard->wake_fd, &counter, sizeof(counter)) < 0 && errno != EAGAIN)
+        perror("read from shard wake_fd failed");
+
+    pthread_mutex_lock(&shard->mailbox->lock);
+    Node *node = shard->mailbox->head;
+    shard->mailbox->head = NULL;
+    shard->mailbox->size = 0;
+    pthread_mutex_unlock(&shard->mailbox->lock);
+
+    // add_list başa eklediği için zinciri ters çevir
+    Node *ordered = NULL;
+    while (node)
+    {
+        Node *next = node->next;
+        node->next = ordered;
+        ordered = node;
+        node = next;
+    }
+    while (ordered)
+    {
+        Node *next = ordered->next;
+        ShardCommand *cmd = (ShardCommand *)ordered->data;
+        int sock = cmd->drone->sock;
+        if (sock > 0 && (size_t)sock < conn_by_fd_size && conn_by_fd[sock])
+            send_assign_mission(conn_by_fd[sock], cmd);
+        free_shard_command(cmd);
+        fleet_mark_dirty(); // Controller'ın yazdığı status/target görüntüye girsin
+        free_list_node(ordered);
+        ordered = next;
     }
+}
 
-cleanup_and_exit: // GÜNCELLENDİ: Temiz çıkış için goto etiketi
-    printf("Drone handler for socket %d is terminating.\n", sock);
-    if (drone_obj)
+// Kapanan drone'a ait bekleyen komutları atar. Drone'un soketi kilit altında -1
+// yapıldıktan sonra çağrılmalı; controller komutu drone kilidini tutarak ve sadece
+// sock > 0 iken eklediği için bundan sonra yeni komut gelemez.
+void purge_shard_commands(ReactorShard *shard, Drone *drone)
+{
+    pthread_mutex_lock(&shard->mailbox->lock);
+    Node *current = shard->mailbox->head;
+    Node *prev = NULL;
+    while (current)
     {
-        printf("Cleaning up for drone D%d (socket %d).\n", drone_obj->id, sock);
-        pthread_mutex_lock(&drone_obj->lock);
-        if (drone_obj->status == ON_MISSION)
-        { // GÜNCELLENDİ: Bağlantı koparsa görevi iptal et
-            unassign_survivor_target(drone_obj->target);
+        Node *next = current->next;
+        ShardCommand *cmd = (ShardCommand *)current->data;
+        if (cmd->drone == drone)
+        {
+            if (prev)
+                prev->next = next;
+            else
+                shard->mailbox->head = next;
+            shard->mailbox->size--;
+            free_shard_command(cmd);
+            free_list_node(current);
         }
-        pthread_mutex_unlock(&drone_obj->lock); // Kilidi bırak
-
-        pthread_mutex_lock(&drone_list->lock);
-        // remove_list data pointer'ına göre karşılaştırma yapacak şekilde ayarlanmalı
-        // veya ID'ye göre arama yapan bir remove_list_by_id fonksiyonu olmalı.
-        // Mevcut remove_list(list, data, compare_func) için compare_func (void* a, void* b)'yi alır.
-        // drone_obj pointer'ı ile listedeki drone'u bulup çıkarmak için özel bir compare fonksiyonu:
-        remove_list(drone_list, drone_obj, compare_drone_by_ptr);
-        pthread_mutex_unlock(&drone_list->lock);
-
-        // drone_obj->sock zaten bu thread'in `sock` değişkeni.
-        // free_drone içinde mutex_destroy var, kilidi tutarken çağırma.
-        // free_drone'dan önce soketi kapatmak iyi bir pratik.
-        if (drone_obj->sock > 0)
-        { // Soket zaten kapatılmadıysa (örn. yinelenen bağlantı durumu)
-          // close(drone_obj->sock); // close(sock) aşağıda zaten var.
+        else
+        {
+            prev = current;
         }
-        drone_obj->sock = -1; // Artık geçersiz
-        free_drone(drone_obj);
-        drone_obj = NULL;
+        current = next;
     }
+    pthread_mutex_unlock(&shard->mailbox->lock);
+}
 
-    if (sock > 0)
-        close(sock);
-    return NULL;
+// Kapanış yedeği: reactor temizliğine varmadan sonlandıysa map'te kalan drone'un soketini kapatır.
+static void close_drone_socket(void *data, void *ctx)
+{
+    (void)ctx;
+    Drone *d = data;
+    pthread_mutex_lock(&d->lock);
+    if (d->sock > 0)
+    {
+        close(d->sock);
+        d->sock = -1;
+    }
+    pthread_mutex_unlock(&d->lock);
 }
 
-void *controller(void *arg)
+// publish_fleet için iterate_hashmap geri çağrısı; bağlı drone'u görüntüye ekler.
+static void add_fleet_entry(void *data, void *ctx)
 {
-    (void)arg;
-    while (server_running)
+    Drone *d = data;
+    FleetSnapshot *snap = ctx;
+    DroneTelemetry t;
+    drone_load_telemetry(d, &t);
+    pthread_mutex_lock(&d->lock); // Sadece görev alanları için
+    if (d->sock > 0)
+        snap->entries[snap->count++] = (FleetEntry){.drone = d, .id = d->id, .status = t.status,
+                                                    .coord = t.coord, .target = d->target, .battery = t.battery,
+                                                    .route_len = d->route_len, .route_capacity = d->route_capacity};
+    pthread_mutex_unlock(&d->lock);
+}
+
+// Shard'ın drones map'inden yeni bir görüntü oluşturup yayınlar; eskisi epoch
+// üzerinden silinir. Map iterate_hashmap ile parça parça gezilir; ona sadece shard
+// thread'i ekleyip sildiğinden gezinti boyunca eksik ya da fazla drone görülmez.
+// Drone kilidi, controller'ın aynı anda yazdığı görev alanları (target, route) için alınır.
+void publish_fleet(ReactorShard *shard)
+{
+    // Shard'ın drone'larını sadece kendi thread'i ekleyip çıkarır: boyut gezinti boyunca sabit
+    FleetSnapshot *snap = malloc(sizeof(FleetSnapshot) + get_hashmap_size(shard->drones) * sizeof(FleetEntry));
+    if (!snap)
+        return; // fleet_dirty kalır, sonraki turda yeniden denenir
+    snap->count = 0;
+    iterate_hashmap(shard->drones, add_fleet_entry, snap);
+    FleetSnapshot *old = __atomic_exchange_n(&shard->fleet, snap, __ATOMIC_ACQ_REL);
+    epoch_retire(old, free);
+    shard->fleet_dirty = false;
+    shard->fleet_published_ms = shard->now_ms;
+    shard->stat_fleet_publishes++;
+}
+
+// Tur sonu: görüntü bayatsa yayınlar, sonra bekleyen olayları controller'a iletir.
+// Olay yokken konum güncellemeleri FLEET_PUBLISH_MS ile seyreltilir.
+void finish_shard_turn(ReactorShard *shard)
+{
+    if (shard->fleet_dirty &&
+        (shard->pending_events || shard->now_ms - shard->fleet_published_ms >= FLEET_PUBLISH_MS))
+        publish_fleet(shard);
+    if (shard->pending_events)
     {
-        sleep(2); // Kontrol periyodu
+        controller_signal(shard->pending_events);
+        shard->pending_events = 0;
+    }
+    epoch_collect();
+}
+
+void release_drone_conn(DroneConn *conn)
+{
+    ReactorShard *shard = conn->shard;
+    close(conn->sock);
+    if (conn->prev)
+        conn->prev->next = conn->next;
+    else
+        shard->conn_head = conn->next;
+    if (conn->next)
+        conn->next->prev = conn->prev;
+    if (conn->flush_queued)
+    { // Flush listesinde kalan bağlantıyı çıkar
+        DroneConn **link = &shard->flush_head;
+        while (*link != conn)
+            link = &(*link)->flush_next;
+        *link = conn->flush_next;
+    }
+    free_proto_stream(conn->stream);
+    outq_clear(&conn->out);
+    free(conn->drones);
+    free(conn);
+}
 
-        // 1. Zaman aşımına uğrayan drone'ları kontrol et ve çıkar
-        pthread_mutex_lock(&drone_list->lock);
-        Node *d_node_timeout = drone_list->head;
-        Node *d_prev_timeout = NULL;
-        time_t current_time = time(NULL);
+// Bağlantının taşıdığı drone'lardan birini ID'sine göre bulur. Gateway başına
+// drone sayısı onlarla sınırlı olduğundan doğrusal arama yeterli.
+Drone *conn_find_drone(DroneConn *conn, int id)
+{
+    for (int i = 0; i < conn->drone_count; i++)
+    {
+        if (conn->drones[i]->id == id)
+            return conn->drones[i];
+    }
+    return NULL;
+}
 
-        while (d_node_timeout)
+// Drone'u bağlantıdan ve shard listesinden çıkarıp serbest bırakır; bağlantı açık kalır.
+void detach_drone(DroneConn *conn, Drone *drone_obj)
+{
+    ReactorShard *shard = conn->shard;
+    printf("Cleaning up for drone D%d (socket %d).\n", drone_obj->id, conn->sock);
+    pthread_mutex_lock(&drone_obj->lock);
+    uint64_t open_mission_key = drone_obj->mission_key;
+    uint64_t route_keys[ROUTE_MAX_STOPS];
+    int route_len = drone_obj->route_len;
+    memcpy(route_keys, drone_obj->route_keys, sizeof(route_keys));
+    __atomic_store_n(&drone_obj->mission_key, 0, __ATOMIC_RELAXED);
+    drone_obj->route_len = 0;
+    drone_obj->sock = -1; // Controller bu noktadan sonra drone'a görev veremez
+    pthread_mutex_unlock(&drone_obj->lock);
+    if (open_mission_key)
+    { // Bağlantı koparsa görevi iptal et
+        unassign_mission(open_mission_key);
+    }
+    for (int i = 0; i < route_len; i++)
+        unassign_mission(route_keys[i]);
+
+    // Drone'suz görüntü hemen yayınlanır. Eski görüntüyü (ve drone'u) tutan okuyucular
+    // hâlâ olabilir; drone, onlar epoch'tan çıkana kadar epoch_retire ile bekletilir.
+    remove_hashmap(shard->drones, (uint64_t)drone_obj->id);
+    remove_hashmap(drone_table, (uint64_t)drone_obj->id);
+    purge_shard_commands(shard, drone_obj);
+    publish_fleet(shard);
+    controller_notify(CONTROLLER_DRONE_LOST);
+
+    for (int i = 0; i < conn->drone_count; i++)
+    {
+        if (conn->drones[i] == drone_obj)
         {
-            Drone *d = (Drone *)d_node_timeout->data;
-            bool remove_this_drone = false;
+            conn->drones[i] = conn->drones[--conn->drone_count];
+            break;
+        }
+    }
+    epoch_retire(drone_obj, free_drone);
+}
 
-            pthread_mutex_lock(&d->lock);
-            if (difftime(current_time, d->last_message_time) > DRONE_TIMEOUT)
-            {
-                printf("Drone D%d (socket %d) timed out. Last message: %.0f s ago. Removing.\n",
-                       d->id, d->sock, difftime(current_time, d->last_message_time));
-                remove_this_drone = true;
-                if (d->status == ON_MISSION)
-                {
-                    // Hedefi serbest bırakma işlemi drone'un kendi lock'u dışarısında yapılmalı (survivor_list lock'u için)
-                    // Ancak hedef bilgisini burada alalım.
-                    Coordinate timed_out_target = d->target;
-                    pthread_mutex_unlock(&d->lock);             // Drone kilidini bırak
-                    unassign_survivor_target(timed_out_target); // Şimdi survivor hedefini kaldır
-                }
-                else
-                {
-                    pthread_mutex_unlock(&d->lock); // Drone kilidini bırak
-                }
+// Drone'u shard listesinden siler ve bağlantıyı kapatır. epoll yolunda bellek hemen,
+// io_uring yolunda kernel'deki işlemler tamamlandığında serbest bırakılır.
+void close_drone_conn(DroneConn *conn)
+{
+    if (conn->closing)
+        return;
+    conn->closing = true;
+    ReactorShard *shard = conn->shard;
+    timer_cancel(&conn->heartbeat_timer);
+    timer_cancel(&conn->timeout_timer);
+    telemetry_session_close(conn);
+    printf("Drone handler for socket %d is terminating.\n", conn->sock);
+    if ((size_t)conn->sock < conn_by_fd_size)
+        conn_by_fd[conn->sock] = NULL;
+
+    while (conn->drone_count > 0)
+        detach_drone(conn, conn->drones[conn->drone_count - 1]);
+
+    if (io_backend == IO_BACKEND_URING)
+    {
+        // shutdown, multishot recv'in 0 ile sonlanmasını sağlar. Bağlantı, üzerindeki son
+        // işlemin CQE'si işlendiğinde (inflight == 0) serbest bırakılır.
+        shutdown(conn->sock, SHUT_RDWR);
+        return;
+    }
+    epoll_ctl(shard->epoll_fd, EPOLL_CTL_DEL, conn->sock, NULL);
+    release_drone_conn(conn);
+}
 
-                if (d->sock > 0)
-                { // Soketi kapat
-                    close(d->sock);
-                    d->sock = -1; // Gelecekte kullanılmaması için
-                }
-            }
-            else
-            {
-                pthread_mutex_unlock(&d->lock);
-            }
+// Verilen ID'li drone herhangi bir shard'da kayıtlı mı?
+bool drone_id_registered(int id)
+{
+    return get_hashmap(drone_table, (uint64_t)id) != NULL;
+}
+
+// HANDSHAKE'teki jobj[key] dizisi name'i içeriyor mu?
+bool handshake_offers(json_object *jobj, const char *key, const char *name)
+{
+    json_object *arr = json_object_object_get(jobj, key);
+    if (!arr || !json_object_is_type(arr, json_type_array))
+        return false;
+    for (size_t i = 0; i < json_object_array_length(arr); i++)
+    {
+        const char *item = json_object_get_string(json_object_array_get_idx(arr, i));
+        if (item && strcmp(item, name) == 0)
+            return true;
+    }
+    return false;
+}
 
-            if (remove_this_drone)
+// UDP oturumu için slot ve rastgele anahtar ayırır. Slot datagramdan doğrudan
+// indekslenir; anahtar, slotu tahmin eden veya eski oturumdan kalan paketleri ayıklar.
+bool telemetry_session_open(DroneConn *conn)
+{
+    ReactorShard *shard = conn->shard;
+    uint32_t slot;
+    if (shard->free_session_count > 0)
+        slot = shard->free_sessions[--shard->free_session_count];
+    else
+    {
+        if (shard->session_count == shard->session_cap)
+        {
+            uint32_t cap = shard->session_cap ? shard->session_cap * 2 : TELEMETRY_INITIAL_SESSIONS;
+            DroneConn **sessions = realloc(shard->sessions, cap * sizeof(DroneConn *));
+            if (!sessions)
+                return false;
+            shard->sessions = sessions;
+            uint32_t *free_sessions = realloc(shard->free_sessions, cap * sizeof(uint32_t));
+            if (!free_sessions)
+                return false;
+            shard->free_sessions = free_sessions;
+            shard->session_cap = cap;
+        }
+        slot = shard->session_count++;
+    }
+
+    uint32_t session = 0;
+    while (session == 0)
+    {
+        if (getrandom(&session, sizeof(session), 0) != sizeof(session))
+            session = (uint32_t)monotonic_ms() ^ (uint32_t)rand() ^ (uint32_t)(uintptr_t)conn;
+    }
+    shard->sessions[slot] = conn;
+    conn->udp_slot = slot;
+    conn->udp_session = session;
+    conn->udp_seen = false;
+    return true;
+}
+
+void telemetry_session_close(DroneConn *conn)
+{
+    if (conn->udp_session == 0)
+        return;
+    ReactorShard *shard = conn->shard;
+    shard->sessions[conn->udp_slot] = NULL;
+    shard->free_sessions[shard->free_session_count++] = conn->udp_slot;
+    conn->udp_session = 0;
+}
+
+// "D12" veya "12" biçimindeki drone ID'sini çözer; geçersizse -1.
+int parse_drone_id(const char *str)
+{
+    if (!str)
+        return -1;
+    if (str[0] == 'D' || str[0] == 'd')
+        str++;
+    int id = atoi(str);
+    return id > 0 ? id : -1;
+}
+
+// Yeni bir Drone kaydı oluşturup bağlantıya ve shard listesine ekler. ID başka
+// bir bağlantıda kayıtlıysa veya bellek yoksa NULL döner.
+Drone *register_drone(DroneConn *conn, int id)
+{
+    if (conn->drone_count == conn->drone_cap)
+    {
+        int cap = conn->drone_cap ? conn->drone_cap * 2 : 1;
+        Drone **drones = realloc(conn->drones, cap * sizeof(Drone *));
+        if (!drones)
+            return NULL;
+        conn->drones = drones;
+        conn->drone_cap = cap;
+    }
+
+    if (drone_id_registered(id))
+    {
+        printf("Drone D%d (socket %d) already connected. Rejecting.\n", id, conn->sock);
+        return NULL;
+    }
+    Drone *drone_obj = create_drone(id, -1, -1);
+    if (!drone_obj)
+        return NULL;
+    drone_obj->sock = conn->sock;
+    drone_obj->last_message_time = time(NULL);
+    // Kontrol ve kayıt tek işlem: iki shard aynı ID'yi aynı anda kabul edemez
+    void *owner = insert_hashmap(drone_table, (uint64_t)id, drone_obj);
+    if (owner != drone_obj || !put_hashmap(conn->shard->drones, (uint64_t)id, drone_obj))
+    {
+        if (owner == drone_obj)
+            remove_hashmap(drone_table, (uint64_t)id);
+        else if (owner)
+            printf("Drone D%d (socket %d) already connected. Rejecting.\n", id, conn->sock);
+        free_drone(drone_obj);
+        return NULL;
+    }
+    conn->drones[conn->drone_count++] = drone_obj;
+    fleet_mark_dirty();
+    controller_notify(CONTROLLER_DRONE_IDLE); // Yeni drone boşta başlar
+    return drone_obj;
+}
+
+// HANDSHAKE: drone kaydını oluşturur. "drone_ids" dizisi içeren HANDSHAKE bir
+// gateway'dir: tek bağlantı üzerinden birden çok drone kaydeder; ACK kabul edilen
+// ve reddedilen ID'leri listeler. Bağlantı kapatılmalıysa false döner.
+bool handle_drone_handshake(DroneConn *conn, json_object *jobj)
+{
+    json_object *drone_ids = json_object_object_get(jobj, "drone_ids");
+    bool gateway = drone_ids && json_object_is_type(drone_ids, json_type_array);
+    const char *drone_id_json = json_object_get_string(json_object_object_get(jobj, "drone_id"));
+    if (!gateway && !drone_id_json)
+        return true;
+    if (conn->drone_count > 0)
+    {
+        printf("Drone D%d (socket %d) sent a second HANDSHAKE, ignoring.\n", conn->drones[0]->id, conn->sock);
+        return true;
+    }
+
+    json_object *accepted = NULL;
+    json_object *rejected = NULL;
+    if (gateway)
+    {
+        accepted = json_object_new_array();
+        rejected = json_object_new_array();
+        for (size_t i = 0; i < json_object_array_length(drone_ids); i++)
+        {
+            json_object *item = json_object_array_get_idx(drone_ids, i);
+            int id = parse_drone_id(json_object_get_string(item));
+            json_object_array_add(id > 0 && register_drone(conn, id) ? accepted : rejected, json_object_get(item));
+        }
+        if (conn->drone_count == 0)
+        {
+            printf("Gateway on socket %d registered no drones. Closing.\n", conn->sock);
+            json_object_put(accepted);
+            json_object_put(rejected);
+            return false;
+        }
+        conn->gateway = true;
+        printf("Gateway (socket %d) connected to reactor %d with %d drone(s).\n", conn->sock, conn->shard->index,
+               conn->drone_count);
+    }
+    else
+    {
+        int id = parse_drone_id(drone_id_json);
+        if (id < 0)
+            return true;
+        // Yinelenen bağlantı için ACK göndermeden kapat
+        if (!register_drone(conn, id))
+            return false;
+        printf("Drone D%d (socket %d) connected to reactor %d. Handshake successful.\n", id, conn->sock,
+               conn->shard->index);
+    }
+    // QUEUE_MISSION'ı anlamayan eski client'lara sadece ASSIGN_MISSION gider; "queue"
+    // tek durak, "route" ROUTE_MAX_STOPS durak tutabilir
+    int route_capacity = handshake_offers(jobj, "features", PROTO_FEATURE_ROUTE)   ? ROUTE_MAX_STOPS
+                         : handshake_offers(jobj, "features", PROTO_FEATURE_QUEUE) ? 1
+                                                                                   : 0;
+    for (int i = 0; i < conn->drone_count; i++)
+    {
+        pthread_mutex_lock(&conn->drones[i]->lock);
+        conn->drones[i]->route_capacity = route_capacity;
+        pthread_mutex_unlock(&conn->drones[i]->lock);
+    }
+    timer_schedule(&conn->shard->timers, &conn->heartbeat_timer, conn->shard->now_ms + HEARTBEAT_INTERVAL_MS);
+
+    // Drone ikili çerçevelemeyi öneriyorsa ve sunucuda açıksa, ACK'den sonra ona geçilir.
+    bool use_binary = binary_protocol_enabled && handshake_offers(jobj, "protocols", PROTO_NAME_BINARY);
+
+    json_object *ack = json_object_new_object();
+    json_object_object_add(ack, "type", json_object_new_string("HANDSHAKE_ACK"));
+    json_object_object_add(ack, "protocol", json_object_new_string(use_binary ? PROTO_NAME_BINARY : PROTO_NAME_JSON));
+    if (gateway)
+    {
+        json_object_object_add(ack, "drone_ids", accepted);
+        json_object_object_add(ack, "rejected", rejected);
+    }
+    // UDP telemetri ikili çerçeve kullanır; STATUS_UPDATE dışındaki her şey TCP'de kalır
+    if (use_binary && conn->shard->udp_fd >= 0 && handshake_offers(jobj, "transports", PROTO_TRANSPORT_UDP) &&
+        telemetry_session_open(conn))
+    {
+        json_object *telemetry = json_object_new_object();
+        json_object_object_add(telemetry, "port", json_object_new_int(TELEMETRY_PORT + conn->shard->index));
+        json_object_object_add(telemetry, "session", json_object_new_int64(conn->udp_session));
+        json_object_object_add(telemetry, "slot", json_object_new_int64(conn->udp_slot));
+        json_object_object_add(ack, "telemetry", telemetry);
+    }
+    // İsteğe bağlı: sunucu kapasitesi, harita boyutu vb. bilgiler eklenebilir.
+    conn_send_json(conn, ack);
+    json_object_put(ack);
+    conn->binary = use_binary;
+    return true;
+}
+
+// Telemetri drone->lock alınmadan yazılır: lock'u tutan controller'ı (ör. yol ararken) beklemez.
+void handle_status_update(Drone *drone_obj, json_object *jobj)
+{
+    DroneTelemetry t = {.battery = json_object_get_int(json_object_object_get(jobj, "battery"))};
+    unsigned fields = DRONE_TELEMETRY_BATTERY | DRONE_TELEMETRY_REPORT;
+    json_object *loc_obj = json_object_object_get(jobj, "location");
+    if (loc_obj)
+    {
+        t.coord.x = json_object_get_int(json_object_object_get(loc_obj, "x"));
+        t.coord.y = json_object_get_int(json_object_object_get(loc_obj, "y"));
+        fields |= DRONE_TELEMETRY_COORD;
+    }
+    const char *status_str = json_object_get_string(json_object_object_get(jobj, "status"));
+    if (status_str)
+    {
+        t.status = (strcmp(status_str, "idle") == 0) ? IDLE : ON_MISSION;
+        fields |= DRONE_TELEMETRY_STATUS;
+    }
+    bool became_idle = drone_store_telemetry(drone_obj, &t, fields) && t.status == IDLE;
+    fleet_mark_dirty();
+    if (became_idle)
+        controller_notify(CONTROLLER_DRONE_IDLE);
+}
+
+// Rotanın i. durağını çıkarır; sonrakiler bir öne kayar. d->lock tutulurken.
+static void drone_route_pop(Drone *d, int i)
+{
+    d->route_len--;
+    memmove(d->route + i, d->route + i + 1, (size_t)(d->route_len - i) * sizeof(Coordinate));
+    memmove(d->route_keys + i, d->route_keys + i + 1, (size_t)(d->route_len - i) * sizeof(uint64_t));
+}
+
+// Tamamlanan görevin survivor'ını kaldırır. Görev, client mission_id'yi geri
+// gönderdiyse onunla, yoksa drone'un açık göreviyle mission_table'dan bulunur;
+// aynı hücredeki iki survivor karışmaz. reported_target client'ın bildirdiği
+// hedeftir (sadece kayıt için); bildirilmediyse {-1, -1}.
+void complete_mission(Drone *drone_obj, Coordinate reported_target, const char *mission_id)
+{
+    Coordinate completed_mission_target = reported_target;
+    pthread_mutex_lock(&drone_obj->lock);
+    DroneTelemetry t;
+    drone_load_telemetry(drone_obj, &t);
+    uint64_t mission_key = mission_id ? idtable_hash_str(mission_id) : drone_obj->mission_key;
+    bool current = mission_key == drone_obj->mission_key;
+    if (reported_target.x != -1)
+    {
+        printf("Drone D%d reported MISSION_COMPLETE for its target (%d,%d). Current pos: (%d,%d)\n",
+               drone_obj->id, completed_mission_target.x, completed_mission_target.y, t.coord.x, t.coord.y);
+    }
+    else
+    {
+        completed_mission_target = drone_obj->target;
+        printf("Drone D%d reported MISSION_COMPLETE (target from drone state: %d,%d). Current pos: (%d,%d)\n",
+               drone_obj->id, completed_mission_target.x, completed_mission_target.y, t.coord.x, t.coord.y);
+    }
+    int stop = -1; // Rotada tamamlanan durak
+    for (int i = 0; mission_key && !current && i < drone_obj->route_len; i++)
+        if (drone_obj->route_keys[i] == mission_key)
+            stop = i;
+    bool promoted = current && drone_obj->route_len > 0;
+    if (promoted)
+    { // Client rotanın sıradaki durağına kendiliğinden geçti; drone boşa çıkmaz
+        __atomic_store_n(&drone_obj->mission_key, drone_obj->route_keys[0], __ATOMIC_RELAXED);
+        drone_obj->target = drone_obj->route[0];
+        drone_route_pop(drone_obj, 0);
+        drone_store_telemetry(drone_obj, &(DroneTelemetry){.status = ON_MISSION}, DRONE_TELEMETRY_STATUS);
+    }
+    else if (stop >= 0)
+    { // Rotadaki bir durak önce bitti (önceki durakların bildirimi kayboldu)
+        drone_route_pop(drone_obj, stop);
+    }
+    else if (current)
+    {
+        __atomic_store_n(&drone_obj->mission_key, 0, __ATOMIC_RELAXED);
+        // Drone hedefte duruyor; sonraki yol eski telemetri konumundan değil buradan planlanır
+        drone_store_telemetry(drone_obj, &(DroneTelemetry){.coord = completed_mission_target, .status = IDLE},
+                              DRONE_TELEMETRY_COORD | DRONE_TELEMETRY_STATUS);
+    }
+    // Ne mevcut görev ne rotada (bayat/bilinmeyen mission_id): drone asıl görevini uçmaya
+    // devam ediyor, durumuna dokunulmaz; olay sadece kayıt için controller'a gider.
+    int drone_id = drone_obj->id;
+    pthread_mutex_unlock(&drone_obj->lock);
+    fleet_mark_dirty();
+    // Survivor'ın kaldırılması ve yeni görev atama controller thread'ine bırakıldı
+    post_survivor_event((SurvivorEvent){.type = SURVIVOR_RESCUED, .mission_key = mission_key,
+                                        .drone_id = drone_id, .target = completed_mission_target});
+    controller_notify(promoted ? CONTROLLER_QUEUE_OPEN : CONTROLLER_DRONE_IDLE);
+}
+
+void handle_mission_complete(Drone *drone_obj, json_object *jobj)
+{
+    Coordinate reported_target = {-1, -1};
+    json_object *completed_target_obj = json_object_object_get(jobj, "completed_target");
+    if (completed_target_obj)
+    {
+        reported_target.x = json_object_get_int(json_object_object_get(completed_target_obj, "x"));
+        reported_target.y = json_object_get_int(json_object_object_get(completed_target_obj, "y"));
+    }
+    // ASSIGN_MISSION'daki mission_id geri gönderildiyse görev doğrudan ondan bulunur
+    complete_mission(drone_obj, reported_target, json_object_get_string(json_object_object_get(jobj, "mission_id")));
+}
+
+// Pili biten drone kaydından çıkarılır. Normal bağlantıda bu bağlantının sonudur;
+// gateway'de sadece o drone düşer. Bağlantı kapatılmalıysa false döner.
+bool handle_battery_depleted(DroneConn *conn, Drone *drone_obj)
+{
+    printf("Drone D%d battery depleted. (Socket %d)\n", drone_obj->id, conn->sock);
+    detach_drone(conn, drone_obj);
+    return conn->gateway && conn->drone_count > 0;
+}
+
+// Drone'dan bir mesaj geldi: istatistiği ve son mesaj zamanını güncelle.
+// Zaman aşımı zamanlayıcısı burada taşınmaz; tetiklendiğinde bu değere bakar.
+void note_drone_message(DroneConn *conn)
+{
+    conn->shard->stat_messages++;
+    conn->last_message_ms = conn->shard->now_ms;
+}
+
+// STATUS_UPDATE ve TELEMETRY çerçevelerinin ortak kısmı.
+void apply_status_frame(Drone *drone_obj, const ProtoMessage *msg)
+{
+    DroneTelemetry t = {.coord = {msg->x, msg->y}, .status = msg->status == IDLE ? IDLE : ON_MISSION,
+                        .battery = msg->battery};
+    bool became_idle = drone_store_telemetry(drone_obj, &t, DRONE_TELEMETRY_ALL | DRONE_TELEMETRY_REPORT) &&
+                       t.status == IDLE;
+    fleet_mark_dirty();
+    if (became_idle)
+        controller_notify(CONTROLLER_DRONE_IDLE);
+}
+
+// İkili çerçeve JSON handler'larının aynısını, ayrıştırma maliyeti olmadan uygular.
+// Bağlantının kapatılması gerekiyorsa false döner.
+bool dispatch_binary_message(DroneConn *conn, const ProtoMessage *msg)
+{
+    if (!conn->binary || conn->drone_count == 0)
+    {
+        fprintf(stderr, "Binary frame from drone socket %d without negotiated protocol. Closing.\n", conn->sock);
+        return false;
+    }
+    note_drone_message(conn);
+    Drone *drone_obj = conn_find_drone(conn, msg->drone_id);
+    if (!drone_obj)
+    {
+        fprintf(stderr, "Binary frame for unregistered D%d on socket %d ignored.\n", msg->drone_id, conn->sock);
+        return true;
+    }
+
+    switch (msg->type)
+    {
+    case MSG_STATUS_UPDATE:
+        apply_status_frame(drone_obj, msg);
+        break;
+    case MSG_MISSION_COMPLETE:
+        // binary-v1 çerçevesi mission_id taşımaz: görev drone'un açık görevinden bulunur
+        complete_mission(drone_obj, (Coordinate){msg->x, msg->y}, NULL);
+        break;
+    case MSG_BATTERY_DEPLETED:
+        return handle_battery_depleted(conn, drone_obj);
+    case MSG_HEARTBEAT_ACK:
+        break; // last_message_ms zaten güncellendi
+    default:
+        printf("Drone D%d (socket %d) sent unexpected binary message type: %d\n", drone_obj->id, conn->sock, msg->type);
+        break;
+    }
+    return true;
+}
+
+// Tek bir JSON mesajını türüne göre ilgili handler'a yönlendirir.
+// Bağlantının kapatılması gerekiyorsa false döner.
+bool dispatch_drone_message(DroneConn *conn, json_object *jobj)
+{
+    const char *type_str = json_object_get_string(json_object_object_get(jobj, "type"));
+    if (!type_str)
+    {
+        fprintf(stderr, "Received JSON from drone socket %d without 'type' field.\n", conn->sock);
+        return true;
+    }
+
+    // Gateway mesajları drone_id ile hedeflenir; normal bağlantıda tek drone vardır
+    Drone *drone_obj = NULL;
+    if (conn->gateway)
+        drone_obj = conn_find_drone(conn, parse_drone_id(json_object_get_string(json_object_object_get(jobj, "drone_id"))));
+    else if (conn->drone_count > 0)
+        drone_obj = conn->drones[0];
+    note_drone_message(conn);
+
+    if (strcmp(type_str, "HANDSHAKE") == 0)
+    {
+        return handle_drone_handshake(conn, jobj);
+    }
+    else if (drone_obj && strcmp(type_str, "STATUS_UPDATE") == 0)
+    {
+        handle_status_update(drone_obj, jobj);
+    }
+    else if (drone_obj && strcmp(type_str, "MISSION_COMPLETE") == 0)
+    {
+        handle_mission_complete(drone_obj, jobj);
+    }
+    else if (drone_obj && strcmp(type_str, "BATTERY_DEPLETED") == 0)
+    {
+        return handle_battery_depleted(conn, drone_obj);
+    }
+    else if (conn->drone_count > 0 && strcmp(type_str, "HEARTBEAT_ACK") == 0)
+    {
+        // last_message_ms zaten her mesajda güncelleniyor.
+    }
+    else if (drone_obj)
+    {
+        printf("Drone D%d (socket %d) sent unknown/unhandled message type: %s\n", drone_obj->id, conn->sock, type_str);
+    }
+    else if (conn->drone_count > 0)
+    {
+        printf("Gateway (socket %d) sent '%s' for an unregistered drone, ignoring.\n", conn->sock, type_str);
+    }
+    else
+    { // Handshake öncesi
+        printf("Received message type '%s' from socket %d before handshake completed.\n", type_str, conn->sock);
+    }
+    return true;
+}
+
+// Bağlantının halkasındaki tüm tamamlanmış mesajları dispatch eder: PROTO_MAGIC
+// ile başlayan ikili çerçeveler veya artımlı ayrıştırılan JSON mesajları.
+// Bağlantının kapatılması gerekiyorsa false döner.
+bool process_drone_stream(DroneConn *conn)
+{
+    for (;;)
+    {
+        json_object *jobj = NULL;
+        ProtoMessage msg;
+        bool keep_open = true;
+        switch (proto_stream_next(conn->stream, &jobj, &msg))
+        {
+        case PROTO_NEED_MORE:
+            return true;
+        case PROTO_JSON:
+            keep_open = dispatch_drone_message(conn, jobj);
+            json_object_put(jobj);
+            break;
+        case PROTO_FRAME:
+            keep_open = dispatch_binary_message(conn, &msg);
+            break;
+        case PROTO_BAD_JSON:
+            fprintf(stderr, "Failed to parse JSON from drone socket %d: %s\n", conn->sock,
+                    json_tokener_error_desc(conn->stream->error));
+            break;
+        case PROTO_BAD_FRAME:
+            fprintf(stderr, "Malformed binary frame from drone socket %d. Closing.\n", conn->sock);
+            return false;
+        }
+        if (!keep_open)
+            return false;
+    }
+}
+
+// Başka bir tampondan (io_uring sağlanan tamponu) gelen veriyi halkaya yazıp işler.
+bool process_drone_data(DroneConn *conn, const char *data, int len)
+{
+    conn->shard->stat_bytes_in += len;
+    size_t offset = 0;
+    while (offset < (size_t)len)
+    {
+        offset += ringbuf_write(conn->stream->in, data + offset, len - offset);
+        if (!process_drone_stream(conn))
+            return false;
+    }
+    return true;
+}
+
+// Tek bir telemetri datagramı. Oturumu tutmayan veya sıra numarası son kabul
+// edilenden büyük olmayan (yeniden sıralanmış/yinelenmiş) paketler atılır.
+void handle_telemetry_datagram(ReactorShard *shard, const uint8_t *buf, size_t len)
+{
+    ProtoMessage msg;
+    if (proto_decode(buf, len, &msg) != (int)len || msg.type != MSG_TELEMETRY || msg.slot >= shard->session_count)
+    {
+        shard->stat_udp_rejected++;
+        return;
+    }
+    DroneConn *conn = shard->sessions[msg.slot];
+    Drone *drone_obj = conn && conn->udp_session == msg.session ? conn_find_drone(conn, msg.drone_id) : NULL;
+    if (!drone_obj)
+    {
+        shard->stat_udp_rejected++;
+        return;
+    }
+    if (conn->udp_seen && (int32_t)(msg.seq - conn->udp_last_seq) <= 0)
+    {
+        shard->stat_udp_stale++;
+        return;
+    }
+    conn->udp_seen = true;
+    conn->udp_last_seq = msg.seq;
+    shard->stat_udp_datagrams++;
+    note_drone_message(conn);
+    apply_status_frame(drone_obj, &msg);
+}
+
+// Telemetri soketindeki tüm datagramları recvmmsg ile toplu okur.
+void drain_telemetry_socket(ReactorShard *shard)
+{
+    uint8_t bufs[TELEMETRY_BATCH][PROTO_MAX_FRAME];
+    struct iovec iov[TELEMETRY_BATCH];
+    struct mmsghdr msgs[TELEMETRY_BATCH];
+    for (;;)
+    {
+        memset(msgs, 0, sizeof(msgs));
+        for (int i = 0; i < TELEMETRY_BATCH; i++)
+        {
+            iov[i].iov_base = bufs[i];
+            iov[i].iov_len = sizeof(bufs[i]);
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        shard->stat_syscalls++;
+        int n = recvmmsg(shard->udp_fd, msgs, TELEMETRY_BATCH, MSG_DONTWAIT, NULL);
+        if (n <= 0)
+        {
+            if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                perror("recvmmsg on telemetry socket failed");
+            return;
+        }
+        for (int i = 0; i < n; i++)
+        {
+            shard->stat_bytes_in += msgs[i].msg_len;
+            if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC)
+                shard->stat_udp_rejected++;
+            else
+                handle_telemetry_datagram(shard, bufs[i], msgs[i].msg_len);
+        }
+        if (n < TELEMETRY_BATCH)
+            return;
+    }
+}
+
+void drone_heartbeat_due(Timer *timer, void *arg)
+{
+    DroneConn *conn = (DroneConn *)arg;
+    send_heartbeat(conn, time(NULL));
+    timer_schedule(&conn->shard->timers, timer, conn->shard->now_ms + HEARTBEAT_INTERVAL_MS);
+}
+
+// Son mesajdan bu yana DRONE_TIMEOUT_MS geçtiyse bağlantıyı keser; arada mesaj
+// geldiyse zamanlayıcıyı yeni son tarihe kurar. Böylece mesaj başına maliyet sıfırdır.
+void drone_timeout_due(Timer *timer, void *arg)
+{
+    DroneConn *conn = (DroneConn *)arg;
+    ReactorShard *shard = conn->shard;
+    uint64_t deadline = conn->last_message_ms + DRONE_TIMEOUT_MS;
+    if (deadline > shard->now_ms)
+    {
+        timer_schedule(&shard->timers, timer, deadline);
+        return;
+    }
+    if (conn->gateway)
+        printf("Gateway (socket %d, %d drones) timed out. Last message: %llu ms ago. Removing.\n", conn->sock,
+               conn->drone_count, (unsigned long long)(shard->now_ms - conn->last_message_ms));
+    else if (conn->drone_count > 0)
+        printf("Drone D%d (socket %d) timed out. Last message: %llu ms ago. Removing.\n", conn->drones[0]->id,
+               conn->sock, (unsigned long long)(shard->now_ms - conn->last_message_ms));
+    else
+        printf("Socket %d sent no HANDSHAKE within %d ms. Closing.\n", conn->sock, DRONE_TIMEOUT_MS);
+    close_drone_conn(conn);
+}
+
+void accept_drone_connections(ReactorShard *shard)
+{
+    while (server_running)
+    {
+        struct sockaddr_in client_addr;
+        socklen_t addr_len = sizeof(client_addr);
+        shard->stat_syscalls++;
+        int client_sock = accept4(shard->listen_fd, (struct sockaddr *)&client_addr, &addr_len, SOCK_NONBLOCK);
+        if (client_sock < 0)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                perror("accept for drone failed");
+            return;
+        }
+        char client_ip[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
+        printf("Reactor %d accepted new drone connection from %s:%d (socket %d)\n",
+               shard->index, client_ip, ntohs(client_addr.sin_port), client_sock);
+
+        DroneConn *conn = create_drone_conn(shard, client_sock);
+        if (!conn)
+        {
+            perror("malloc for DroneConn failed");
+            close(client_sock);
+            continue;
+        }
+        struct epoll_event ev = {.events = EPOLLIN | EPOLLRDHUP, .data.ptr = conn};
+        if (epoll_ctl(shard->epoll_fd, EPOLL_CTL_ADD, client_sock, &ev) < 0)
+        {
+            perror("epoll_ctl ADD for drone socket failed");
+            close_drone_conn(conn);
+        }
+    }
+}
+
+// 8080 için SO_REUSEPORT ile ayrı bir dinleme soketi açar; çekirdek yeni
+// bağlantıları aynı portu dinleyen shard'lar arasında dağıtır.
+int create_drone_listener()
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        perror("socket for drones failed");
+        return -1;
+    }
+    int opt = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0 ||
+        setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0)
+    {
+        perror("setsockopt(SO_REUSEADDR/SO_REUSEPORT) for drones failed");
+        close(fd);
+        return -1;
+    }
+    struct sockaddr_in server_addr = {0};
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_addr.s_addr = INADDR_ANY;
+    server_addr.sin_port = htons(PORT);
+    if (bind(fd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0)
+    {
+        perror("bind for drones failed");
+        close(fd);
+        return -1;
+    }
+    // Yeniden bağlanma fırtınalarında backlog'un taşmaması için MAX_DRONES yerine SOMAXCONN
+    if (listen(fd, SOMAXCONN) < 0)
+    {
+        perror("listen for drones failed");
+        close(fd);
+        return -1;
+    }
+    // Reactor accept'i EAGAIN alana kadar döngüde çağırır
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    return fd;
+}
+
+// Shard'a özel UDP telemetri soketi. Her shard ayrı port kullanır; böylece bir
+// drone'un datagramları her zaman bağlantısının sahibi olan reactor'a gelir.
+int create_telemetry_socket(int port)
+{
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        perror("socket for telemetry failed");
+        return -1;
+    }
+    int rcvbuf = TELEMETRY_RCVBUF;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = INADDR_ANY;
+    addr.sin_port = htons(port);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        perror("bind for telemetry failed");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool init_reactor_shard(ReactorShard *shard, int index)
+{
+    memset(shard, 0, sizeof(*shard));
+    shard->index = index;
+    shard->listen_fd = create_drone_listener();
+    if (shard->listen_fd < 0)
+        return false;
+    shard->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    shard->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    shard->drones = create_hashmap();
+    shard->mailbox = create_list();
+    shard->now_ms = monotonic_ms();
+    timer_wheel_init(&shard->timers, shard->now_ms);
+    if (shard->epoll_fd < 0 || shard->wake_fd < 0 || !shard->drones || !shard->mailbox)
+    {
+        perror("reactor shard init failed");
+        return false;
+    }
+    shard->udp_fd = -1;
+    if (udp_telemetry_enabled && (shard->udp_fd = create_telemetry_socket(TELEMETRY_PORT + index)) < 0)
+        return false;
+
+    if (io_backend == IO_BACKEND_URING)
+    {
+        if (!uring_init(&shard->ring, URING_ENTRIES) ||
+            !uring_buf_ring_init(&shard->ring, &shard->bufs, URING_BUF_GROUP, URING_BUF_COUNT, RECV_BUFFER_SIZE))
+        {
+            perror("io_uring init for reactor shard failed");
+            return false;
+        }
+        return true;
+    }
+
+    // Dinleme soketi ve eventfd, shard alanlarının adresleriyle ayırt edilir
+    struct epoll_event listen_ev = {.events = EPOLLIN, .data.ptr = &shard->listen_fd};
+    struct epoll_event wake_ev = {.events = EPOLLIN, .data.ptr = &shard->wake_fd};
+    struct epoll_event udp_ev = {.events = EPOLLIN, .data.ptr = &shard->udp_fd};
+    if (epoll_ctl(shard->epoll_fd, EPOLL_CTL_ADD, shard->listen_fd, &listen_ev) < 0 ||
+        epoll_ctl(shard->epoll_fd, EPOLL_CTL_ADD, shard->wake_fd, &wake_ev) < 0 ||
+        (shard->udp_fd >= 0 && epoll_ctl(shard->epoll_fd, EPOLL_CTL_ADD, shard->udp_fd, &udp_ev) < 0))
+    {
+        perror("epoll_ctl ADD for reactor shard failed");
+        return false;
+    }
+    return true;
+}
+
+void print_reactor_stats(ReactorShard *shard)
+{
+    printf("Reactor %d (%s): %lu messages, %lu I/O syscalls (%.2f per message), %.1f bytes per message\n",
+           shard->index, io_backend == IO_BACKEND_URING ? "io_uring" : "epoll",
+           shard->stat_messages, shard->stat_syscalls,
+           shard->stat_messages ? (double)shard->stat_syscalls / shard->stat_messages : 0.0,
+           shard->stat_messages ? (double)shard->stat_bytes_in / shard->stat_messages : 0.0);
+    printf("Reactor %d: %lu heartbeats dropped, %lu slow consumers disconnected\n",
+           shard->index, shard->stat_heartbeats_dropped, shard->stat_slow_disconnects);
+    printf("Reactor %d: %lu fleet snapshots published\n", shard->index, shard->stat_fleet_publishes);
+    if (shard->udp_fd >= 0)
+        printf("Reactor %d: %lu telemetry datagrams, %lu stale, %lu rejected\n",
+               shard->index, shard->stat_udp_datagrams, shard->stat_udp_stale, shard->stat_udp_rejected);
+}
+
+// Bir shard'ın tüm drone soketlerinin sahibi olan epoll döngüsü.
+void *drone_reactor_loop(void *arg)
+{
+    ReactorShard *shard = (ReactorShard *)arg;
+
+    // Her reactor'ı bir çekirdeğe sabitle
+    long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpu_count > 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(shard->index % cpu_count, &cpus);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0)
+            fprintf(stderr, "Reactor %d: could not pin to CPU %ld\n", shard->index, shard->index % cpu_count);
+    }
+    printf("Drone reactor %d listening on port %d\n", shard->index, PORT);
+    current_shard = shard;
+    epoch_register();
+    publish_fleet(shard);
+
+    struct epoll_event events[MAX_EPOLL_EVENTS];
+
+    while (server_running)
+    {
+        flush_pending_conns(shard);
+        // En yakın zamanlayıcıya kadar bekle; en fazla 1 sn (server_running kontrolü için).
+        // Yayınlanmamış drone değişikliği varsa FLEET_PUBLISH_MS'den uzun uyunmaz.
+        int timeout = timer_wheel_next_timeout(&shard->timers, shard->now_ms,
+                                               shard->fleet_dirty ? FLEET_PUBLISH_MS : 1000);
+        shard->stat_syscalls++;
+        int n = epoll_wait(shard->epoll_fd, events, MAX_EPOLL_EVENTS, timeout);
+        if (n < 0 && errno != EINTR)
+        {
+            perror("epoll_wait error in drone_reactor_loop");
+            break;
+        }
+        if (!server_running)
+            break;
+        shard->now_ms = monotonic_ms();
+
+        for (int i = 0; i < n; i++)
+        {
+            void *tag = events[i].data.ptr;
+            if (tag == &shard->listen_fd)
+            {
+                accept_drone_connections(shard);
+                continue;
+            }
+            if (tag == &shard->wake_fd)
+            {
+                drain_shard_mailbox(shard);
+                continue;
+            }
+            if (tag == &shard->udp_fd)
+            {
+                drain_telemetry_socket(shard);
+                continue;
+            }
+
+            DroneConn *conn = (DroneConn *)tag;
+            if ((events[i].events & EPOLLOUT) && !flush_conn(conn))
+                continue;
+            if (!(events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)))
+                continue;
+            // Level-triggered: her olayda tek recv yeterli, kalan veri bir sonraki turda gelir.
+            // recv doğrudan bağlantının halkasına yazar; ara tampon kopyası yok.
+            size_t space;
+            char *dst = ringbuf_write_ptr(conn->stream->in, &space);
+            shard->stat_syscalls++;
+            int len = recv(conn->sock, dst, space, 0);
+            if (len <= 0)
+            {
+                if (len == 0)
+                    printf("Drone disconnected (socket: %d)\n", conn->sock);
+                else if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                    continue;
+                else
+                    perror("recv failed for drone socket");
+                close_drone_conn(conn);
+                continue;
+            }
+            ringbuf_commit(conn->stream->in, len);
+            shard->stat_bytes_in += len;
+            if (!process_drone_stream(conn))
+                close_drone_conn(conn);
+        }
+
+        timer_wheel_advance(&shard->timers, shard->now_ms);
+        finish_shard_turn(shard);
+    }
+
+    // Kapanış: kalan tüm bağlantıları temizle
+    while (shard->conn_head)
+        close_drone_conn(shard->conn_head);
+    finish_shard_turn(shard);
+    epoch_unregister();
+    print_reactor_stats(shard);
+    printf("Drone reactor %d exiting.\n", shard->index);
+    return NULL;
+}
+
+// Multishot recv'i (yeniden) kurar; kernel tamponu shard'ın tampon halkasından seçer.
+void uring_arm_recv(DroneConn *conn)
+{
+    struct io_uring_sqe *sqe = uring_get_sqe(&conn->shard->ring);
+    if (!sqe)
+    {
+        close_drone_conn(conn);
+        return;
+    }
+    uring_prep_recv_multishot(sqe, conn->sock, URING_BUF_GROUP, (uint64_t)(uintptr_t)conn | URING_TAG_RECV);
+    conn->inflight++;
+}
+
+void uring_arm_shard(ReactorShard *shard, bool accept, bool wake, bool telemetry)
+{
+    struct io_uring_sqe *sqe;
+    if (accept && (sqe = uring_get_sqe(&shard->ring)))
+        uring_prep_accept_multishot(sqe, shard->listen_fd, URING_TAG_ACCEPT);
+    if (wake && (sqe = uring_get_sqe(&shard->ring)))
+        uring_prep_poll_multishot(sqe, shard->wake_fd, EPOLLIN, URING_TAG_WAKE);
+    // Datagramlar hazır olunca recvmmsg ile toplu okunur; tampon halkası TCP akışlarına kalır
+    if (telemetry && shard->udp_fd >= 0 && (sqe = uring_get_sqe(&shard->ring)))
+        uring_prep_poll_multishot(sqe, shard->udp_fd, EPOLLIN, URING_TAG_TELEMETRY);
+}
+
+void uring_handle_accept(ReactorShard *shard, int client_sock)
+{
+    if (client_sock < 0)
+    {
+        if (client_sock != -EAGAIN && client_sock != -EINTR)
+            fprintf(stderr, "Reactor %d: accept for drone failed: %s\n", shard->index, strerror(-client_sock));
+        return;
+    }
+    printf("Reactor %d accepted new drone connection (socket %d)\n", shard->index, client_sock);
+    DroneConn *conn = create_drone_conn(shard, client_sock);
+    if (!conn)
+    {
+        perror("malloc for DroneConn failed");
+        close(client_sock);
+        return;
+    }
+    uring_arm_recv(conn);
+    if (conn->closing && conn->inflight == 0)
+        release_drone_conn(conn);
+}
+
+void uring_handle_recv(ReactorShard *shard, DroneConn *conn, struct io_uring_cqe *cqe)
+{
+    bool more = cqe->flags & IORING_CQE_F_MORE;
+    if (!more)
+        conn->inflight--;
+
+    if (cqe->res > 0)
+    {
+        unsigned bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+        bool keep_open = conn->closing || process_drone_data(conn, uring_buf_ring_addr(&shard->bufs, bid), cqe->res);
+        uring_buf_ring_recycle(&shard->bufs, bid);
+        if (!keep_open)
+            close_drone_conn(conn);
+        else if (!more && !conn->closing)
+            uring_arm_recv(conn); // Kernel multishot'ı sonlandırdı (ör. tampon bitti)
+    }
+    else if (cqe->res == -ENOBUFS && !conn->closing)
+    {
+        uring_arm_recv(conn); // Tamponlar geri verildi, tekrar kur
+    }
+    else if (!conn->closing)
+    {
+        if (cqe->res == 0)
+            printf("Drone disconnected (socket: %d)\n", conn->sock);
+        else
+            fprintf(stderr, "recv failed for drone socket %d: %s\n", conn->sock, strerror(-cqe->res));
+        close_drone_conn(conn);
+    }
+
+    if (conn->closing && conn->inflight == 0)
+        release_drone_conn(conn);
+}
+
+void uring_handle_send(DroneConn *conn, int res)
+{
+    conn->inflight--;
+    conn->sending = false;
+    if (res < 0)
+    {
+        if (!conn->closing)
+            fprintf(stderr, "send failed for drone socket %d: %s\n", conn->sock, strerror(-res));
+        close_drone_conn(conn);
+    }
+    else
+    {
+        outq_advance(&conn->out, res);
+        if (conn->out.bytes > 0)
+            conn_schedule_flush(conn); // Kısmi gönderim veya bu arada eklenen veri
+    }
+    if (conn->closing && conn->inflight == 0)
+        release_drone_conn(conn);
+}
+
+// drone_reactor_loop'un io_uring karşılığı. Aynı protokol handler'larını kullanır;
+// accept/recv multishot, gönderimler ise her turda tek io_uring_enter ile toplu yapılır.
+void *drone_reactor_loop_uring(void *arg)
+{
+    ReactorShard *shard = (ReactorShard *)arg;
+
+    long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpu_count > 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(shard->index % cpu_count, &cpus);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0)
+            fprintf(stderr, "Reactor %d: could not pin to CPU %ld\n", shard->index, shard->index % cpu_count);
+    }
+    printf("Drone reactor %d (io_uring) listening on port %d\n", shard->index, PORT);
+    current_shard = shard;
+    epoch_register();
+    publish_fleet(shard);
+
+    uring_arm_shard(shard, true, true, true);
+
+    while (server_running)
+    {
+        flush_pending_conns(shard);
+        int timeout = timer_wheel_next_timeout(&shard->timers, shard->now_ms,
+                                               shard->fleet_dirty ? FLEET_PUBLISH_MS : 1000);
+        if (uring_submit_and_wait(&shard->ring, timeout) < 0)
+        {
+            perror("io_uring_enter error in drone_reactor_loop_uring");
+            break;
+        }
+        if (!server_running)
+            break;
+        shard->now_ms = monotonic_ms();
+
+        struct io_uring_cqe *cqe;
+        while ((cqe = uring_peek_cqe(&shard->ring)) != NULL)
+        {
+            uint64_t tag = cqe->user_data & URING_TAG_MASK;
+            DroneConn *conn = (DroneConn *)(uintptr_t)(cqe->user_data & ~URING_TAG_MASK);
+            switch (tag)
+            {
+            case URING_TAG_ACCEPT:
+                uring_handle_accept(shard, cqe->res);
+                if (!(cqe->flags & IORING_CQE_F_MORE))
+                    uring_arm_shard(shard, true, false, false);
+                break;
+            case URING_TAG_WAKE:
+                drain_shard_mailbox(shard);
+                if (!(cqe->flags & IORING_CQE_F_MORE))
+                    uring_arm_shard(shard, false, true, false);
+                break;
+            case URING_TAG_TELEMETRY:
+                drain_telemetry_socket(shard);
+                if (!(cqe->flags & IORING_CQE_F_MORE))
+                    uring_arm_shard(shard, false, false, true);
+                break;
+            case URING_TAG_RECV:
+                uring_handle_recv(shard, conn, cqe);
+                break;
+            case URING_TAG_SEND:
+                uring_handle_send(conn, cqe->res);
+                break;
+            default:
+                break;
+            }
+            uring_cqe_seen(&shard->ring);
+        }
+
+        timer_wheel_advance(&shard->timers, shard->now_ms);
+        finish_shard_turn(shard);
+    }
+
+    // Kapanış: kernel'deki recv/sendmsg bağlantının msghdr'ını, outq'sunu ve halka
+    // tamponlarını kullanıyor olabilir. Soketler kapatılıp işlemler iptal edilir, CQE'ler
+    // toplanır; her bağlantı son işlemi bittiğinde (inflight == 0) handler'da bırakılır.
+    for (DroneConn *conn = shard->conn_head, *next; conn; conn = next)
+    {
+        next = conn->next;
+        close_drone_conn(conn);
+        struct io_uring_sqe *sqe = uring_get_sqe(&shard->ring);
+        if (sqe)
+            uring_prep_cancel(sqe, (uint64_t)(uintptr_t)conn | URING_TAG_RECV, 0);
+        if (conn->sending && (sqe = uring_get_sqe(&shard->ring)) != NULL)
+            uring_prep_cancel(sqe, (uint64_t)(uintptr_t)conn | URING_TAG_SEND, 0);
+        if (conn->inflight == 0)
+            release_drone_conn(conn);
+    }
+    uint64_t drain_deadline = monotonic_ms() + URING_DRAIN_MS;
+    while (shard->conn_head && monotonic_ms() < drain_deadline)
+    {
+        if (uring_submit_and_wait(&shard->ring, 100) < 0)
+            break;
+        struct io_uring_cqe *cqe;
+        while ((cqe = uring_peek_cqe(&shard->ring)) != NULL)
+        {
+            uint64_t tag = cqe->user_data & URING_TAG_MASK;
+            DroneConn *conn = (DroneConn *)(uintptr_t)(cqe->user_data & ~URING_TAG_MASK);
+            if (tag == URING_TAG_RECV)
+                uring_handle_recv(shard, conn, cqe);
+            else if (tag == URING_TAG_SEND)
+                uring_handle_send(conn, cqe->res);
+            else if (tag == URING_TAG_ACCEPT && cqe->res >= 0)
+                close(cqe->res); // Kapanırken gelen bağlantı kabul edilmez
+            uring_cqe_seen(&shard->ring);
+        }
+    }
+    finish_shard_turn(shard);
+    epoch_unregister();
+    // Süre dolduysa önce halka kapatılır (kernel kalan işlemleri iptal eder), bağlantılar
+    // ve tampon halkası ancak ondan sonra bırakılır.
+    bool drained = !shard->conn_head;
+    if (drained)
+        uring_buf_ring_destroy(&shard->ring, &shard->bufs);
+    uring_destroy(&shard->ring);
+    while (shard->conn_head)
+        release_drone_conn(shard->conn_head);
+    if (!drained)
+        uring_buf_ring_destroy(&shard->ring, &shard->bufs); // Kayıt halkayla birlikte silindi
+    shard->stat_syscalls += shard->ring.enter_calls; // + telemetri recvmmsg çağrıları
+    print_reactor_stats(shard);
+    printf("Drone reactor %d exiting.\n", shard->index);
+    return NULL;
+}
+
+// d->lock tutulurken: drone boşta (açık görevi yok), pili var ve bağlı mı? Görüntü
+// eskimiş olabilir.
+static bool drone_assignable(const Drone *d)
+{
+    DroneTelemetry t;
+    drone_load_telemetry(d, &t);
+    return t.status == IDLE && !d->mission_key && t.battery > 0 && d->sock > 0;
+}
+
+// Survivor'ı drone'a atar: görev kaydı açılır, survivor indeksten çıkar ve komut
+// sahibi shard'a gider. survivor_lock ve d->lock tutulurken, drone'un boşta olduğu
+// doğrulandıktan sonra çağrılır. Survivor'a uçulamıyorsa veya görev kaydı
+// açılamazsa false. *cost planlanan yolun uzunluğuyla doldurulur (kayıt için).
+static bool assign_mission(ReactorShard *shard, Drone *d, Survivor *s, int *cost)
+{
+    DroneTelemetry t;
+    drone_load_telemetry(d, &t);
+    Waypoints path;
+    path.count = navmap_waypoints(&nav_map, t.coord, s->coord, path.points, MISSION_MAX_WAYPOINTS, cost);
+    if (path.count < 0)
+        return false;
+    Mission *m = open_mission(d, s);
+    if (!m)
+        return false;
+    // Açık görevi olmayan drone'da rotada kalmış durak bayattır; ASSIGN_MISSION client'ta
+    // rotayı da siler, survivor'ları geri ver.
+    for (int i = 0; i < d->route_len; i++)
+        release_mission_locked(d->route_keys[i]);
+    d->route_len = 0;
+    d->target = s->coord;
+    // Önce anahtar: bundan sonra gelen "idle" raporu durumu geri çeviremez
+    __atomic_store_n(&d->mission_key, m->key, __ATOMIC_RELAXED);
+    drone_store_telemetry(d, &(DroneTelemetry){.status = ON_MISSION}, DRONE_TELEMETRY_STATUS);
+    s->is_targeted = true;
+    survgrid_remove(&survivor_grid, s);
+    post_mission_to_shard(shard, d, s, m, false, &path); // Soket yazımı sahibi olan reactor'da
+    return true;
+}
+
+// Görevdeki drone'un rotasının sonuna survivor'ı QUEUE_MISSION ile ekler; drone
+// mevcut görevinden (ve önceki duraklardan) sonra ona gider. Kilit kuralları
+// assign_mission ile aynı; rotada yer olduğunu çağıran doğrular.
+static bool queue_mission(ReactorShard *shard, Drone *d, Survivor *s)
+{
+    Coordinate from = d->route_len > 0 ? d->route[d->route_len - 1] : d->target;
+    Waypoints path;
+    path.count = navmap_waypoints(&nav_map, from, s->coord, path.points, MISSION_MAX_WAYPOINTS, NULL);
+    if (path.count < 0)
+        return false;
+    Mission *m = open_mission(d, s);
+    if (!m)
+        return false;
+    d->route[d->route_len] = s->coord;
+    d->route_keys[d->route_len] = m->key;
+    d->route_len++;
+    s->is_targeted = true;
+    survgrid_remove(&survivor_grid, s);
+    post_mission_to_shard(shard, d, s, m, true, &path);
+    return true;
+}
+
+static unsigned long stat_queued_missions = 0; // QUEUE_MISSION ile önceden verilen görev
+static unsigned long stat_routes = 0, stat_route_stops = 0; // Küme rotası ve eklenen durak
+
+// Kümelenmiş survivor'ları drone'un rotasına ekler: son durağın ROUTE_CLUSTER_RADIUS
+// yakınındaki açık survivor'lar en yakın komşu + 2-opt ile sıralanır (bkz. route.h),
+// pilin QUEUE_MIN_BATTERY yedeğine dokunmadan yettiği kadarı QUEUE_MISSION ile
+// gönderilir. Kümedeki her survivor'a ayrı drone gitmez. Eklenen durak sayısını
+// döndürür; kilit kuralları assign_mission ile aynı.
+static int extend_route(ReactorShard *shard, Drone *d)
+{
+    int room = d->route_capacity - d->route_len;
+    DroneTelemetry t;
+    drone_load_telemetry(d, &t);
+    if (t.status != ON_MISSION || room <= 0 || t.battery < QUEUE_MIN_BATTERY)
+        return 0;
+    Coordinate end = d->route_len > 0 ? d->route[d->route_len - 1] : d->target;
+    Survivor *near[ROUTE_MAX_STOPS];
+    int count = survgrid_near(&survivor_grid, end, ROUTE_CLUSTER_RADIUS, near, room);
+    if (count == 0)
+        return 0;
+
+    // Menzil: yedek dışındaki pil, mevcut hedefe ve mevcut duraklara giden yol düşülür
+    int budget = (t.battery - QUEUE_MIN_BATTERY) * DRONE_MOVES_PER_BATTERY;
+    Coordinate at = t.coord, leg = d->target;
+    for (int i = 0; i <= d->route_len; i++)
+    {
+        int cost = navmap_cost(&nav_map, at, leg);
+        budget -= cost > 0 ? cost : 0;
+        at = leg;
+        if (i < d->route_len)
+            leg = d->route[i];
+    }
+    Coordinate stops[ROUTE_MAX_STOPS];
+    int order[ROUTE_MAX_STOPS];
+    for (int i = 0; i < count; i++)
+        stops[i] = near[i]->coord;
+    // Sıra Manhattan ile kurulur; engel varsa gerçek ayak maliyeti daha büyük
+    // olabileceği için menzil her durakta yol maliyetiyle yeniden denetlenir
+    int fitted = route_plan(end, stops, count, budget, order, NULL);
+
+    int added = 0, used = 0;
+    at = end;
+    for (int k = 0; k < fitted; k++)
+    {
+        int cost = navmap_cost(&nav_map, at, stops[order[k]]);
+        if (cost < 0 || used + cost > budget || !queue_mission(shard, d, near[order[k]]))
+            break;
+        used += cost;
+        at = stops[order[k]];
+        added++;
+    }
+    if (added > 0)
+    {
+        stat_queued_missions += added;
+        stat_routes++;
+        stat_route_stops += added;
+        printf("Controller: Routed %d clustered survivor(s) for drone D%d after (%d,%d), %d/%d stops, "
+               "%d cells of range left.\n",
+               added, d->id, end.x, end.y, d->route_len, d->route_capacity, budget - used);
+    }
+    return added;
+}
+
+// Izgara skorlamasının mesafe kancası: engelli haritada gerçek yol maliyeti.
+static int nav_distance(Coordinate from, Coordinate to, void *ctx)
+{
+    return navmap_cost(ctx, from, to);
+}
+
+// Greedy atama: drone'lar görüntü sırasıyla gezilir, her biri kalan en iyi survivor'ı alır.
+static void assign_greedy(void)
+{
+    // Shard görüntüleri kilitsiz okunur; drone kilidi sadece atamanın son kontrolünde
+    // alınır. Atama mesajı shard'ın posta kutusuna gider.
+    epoch_enter();
+    for (int si = 0; si < shard_count; si++)
+    {
+        ReactorShard *shard = &shards[si];
+        const FleetSnapshot *fleet = __atomic_load_n(&shard->fleet, __ATOMIC_ACQUIRE);
+        for (int i = 0; fleet && i < fleet->count; i++)
+        {
+            const FleetEntry *entry = &fleet->entries[i];
+            // Sadece IDLE ve pili olan drone'ları değerlendir (görüntüdekiler bağlı)
+            if (entry->status != IDLE || entry->battery <= 0)
+                continue;
+            Coordinate drone_current_pos = entry->coord;
+            double max_score = -1.0; // En iyi skoru bulmak için
+
+            pthread_mutex_lock(&survivor_lock);
+            time_t now = time(NULL);
+            // Skor: priority*100 + yaş - mesafe*2. Izgara, mesafe sınırı
+            // en iyi skoru geçemeyen hücreleri taramadan eler.
+            Survivor *best_survivor_to_assign = survgrid_best(&survivor_grid, drone_current_pos, now, &max_score);
+
+            if (best_survivor_to_assign)
+            {
+                Drone *d = entry->drone;
+                pthread_mutex_lock(&d->lock); // Drone'a atama yapmak için kilidi al
+                // Son bir kontrol: görüntü eskimiş olabilir; drone hala IDLE, pili var ve bağlı mı?
+                int dist;
+                if (drone_assignable(d) && assign_mission(shard, d, best_survivor_to_assign, &dist))
+                {
+                    printf("Controller: Assigned drone D%d to survivor S%d (Prio:%d, Age:%lds, Dist:%d, Score:%.2f) at (%d,%d).\n",
+                           d->id, best_survivor_to_assign->id, best_survivor_to_assign->priority,
+                           (long)(now - best_survivor_to_assign->creation_time),
+                           dist, max_score,
+                           best_survivor_to_assign->coord.x, best_survivor_to_assign->coord.y);
+                    // Hedefin yanındaki survivor'lar sıradaki boş drone'a değil bu rotaya
+                    extend_route(shard, d);
+                }
+                else
+                {
+                    // Atama sırasında drone durumu değişmiş; survivor indekste kalır
+                }
+                pthread_mutex_unlock(&d->lock);
+            }
+            pthread_mutex_unlock(&survivor_lock);
+        }
+    }
+    epoch_exit();
+}
+
+// Toplu atamada bir satır: drone, sahibi shard ve tur başındaki konumu.
+typedef struct
+{
+    ReactorShard *shard;
+    Drone *drone;
+    Coordinate pos;
+} BatchDrone;
+
+// Controller thread'ine ait, turlar arasında yeniden kullanılan tamponlar.
+static BatchDrone *batch_drones = NULL;
+static Survivor **batch_survivors = NULL;
+static int32_t *batch_benefit = NULL;
+static int *batch_choice = NULL;
+static int *batch_slots = NULL;       // Sütun j'nin skor tablosundaki slotu
+static int32_t *batch_scores = NULL;  // Bir drone için tablo slotlarının skorları
+static size_t batch_drone_cap = 0, batch_survivor_cap = 0, batch_benefit_cap = 0, batch_choice_cap = 0;
+static size_t batch_slot_cap = 0, batch_score_cap = 0;
+static PlanDrone *region_plan_drones = NULL;
+static size_t region_plan_cap = 0;
+static unsigned long stat_plan_passes = 0; // Toplu çözüm veya bölge planı süresi
+static double stat_plan_ms = 0.0, stat_plan_max_ms = 0.0;
+static bool reserve_buffer(void **buf, size_t *cap, size_t need, size_t elem_size)
+{
+    if (need <= *cap)
+        return true;
+    size_t new_cap = *cap ? *cap : 64;
+    while (new_cap < need)
+        new_cap *= 2;
+    void *grown = realloc(*buf, new_cap * elem_size);
+    if (!grown)
+        return false;
+    *buf = grown;
+    *cap = new_cap;
+    return true;
+}
+
+static double elapsed_ms(const struct timespec *start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1000.0 + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// Shard görüntülerindeki boştaki drone'ları batch_drones'a toplar. epoch_enter
+// ile epoch_exit arasında çağrılır; drone işaretçileri epoch_exit'e kadar geçerlidir.
+static size_t collect_idle_drones(void)
+{
+    size_t drone_count = 0;
+    for (int si = 0; si < shard_count; si++)
+    {
+        const FleetSnapshot *fleet = __atomic_load_n(&shards[si].fleet, __ATOMIC_ACQUIRE);
+        for (int i = 0; fleet && i < fleet->count; i++)
+        {
+            const FleetEntry *entry = &fleet->entries[i];
+            if (entry->status != IDLE || entry->battery <= 0 ||
+                !reserve_buffer((void **)&batch_drones, &batch_drone_cap, drone_count + 1, sizeof(BatchDrone)))
+                continue;
+            batch_drones[drone_count++] = (BatchDrone){.shard = &shards[si], .drone = entry->drone, .pos = entry->coord};
+        }
+    }
+    return drone_count;
+}
+
+static void record_plan_time(double ms)
+{
+    stat_plan_passes++;
+    stat_plan_ms += ms;
+    if (ms > stat_plan_max_ms)
+        stat_plan_max_ms = ms;
+}
+
+// Planlanan atamayı uygular (survivor_lock tutulurken). Drone bu arada
+// boşta olmaktan çıktıysa false döner ve survivor'a dokunmaz.
+static bool apply_planned_assignment(const BatchDrone *bd, Survivor *s, time_t now, double score)
+{
+    Drone *d = bd->drone;
+    pthread_mutex_lock(&d->lock);
+    int dist;
+    bool ok = drone_assignable(d) && assign_mission(bd->shard, d, s, &dist);
+    if (ok)
+    {
+        printf("Controller: Assigned drone D%d to survivor S%d (Prio:%d, Age:%lds, Dist:%d, Score:%.2f) at (%d,%d).\n",
+               d->id, s->id, s->priority, (long)(now - s->creation_time), dist, score, s->coord.x, s->coord.y);
+    }
+    pthread_mutex_unlock(&d->lock);
+    return ok;
+}
+
+// Toplu atama: tüm boştaki drone'lar x açık survivor'lar için skor matrisi kurulur
+// ve toplam skoru en büyükleyen eşleştirme açık artırmayla çözülür. Greedy'nin
+// aksine listede önce gelen drone, çok daha yakın başka bir drone varken en iyi
+// survivor'ı kapamaz.
+static void assign_batch(void)
+{
+    epoch_enter();
+    size_t drone_count = collect_idle_drones();
+    pthread_mutex_lock(&survivor_lock);
+    size_t survivor_count = (size_t)survivor_grid.count;
+    if (drone_count > 0 && survivor_count > 0 &&
+        reserve_buffer((void **)&batch_survivors, &batch_survivor_cap, survivor_count, sizeof(Survivor *)) &&
+        reserve_buffer((void **)&batch_benefit, &batch_benefit_cap, drone_count * survivor_count, sizeof(int32_t)) &&
+        reserve_buffer((void **)&batch_choice, &batch_choice_cap, drone_count, sizeof(int)))
+    {
+        struct timespec started;
+        clock_gettime(CLOCK_MONOTONIC, &started);
+        time_t now = time(NULL);
+        const SurvivorTable *table = &survivor_grid.table;
+        if (!survivor_grid.dist_fn &&
+            reserve_buffer((void **)&batch_slots, &batch_slot_cap, survivor_count, sizeof(int)) &&
+            reserve_buffer((void **)&batch_scores, &batch_score_cap, (size_t)table->high, sizeof(int32_t)))
+        { // Engel yok: mesafe Manhattan, satırlar skor tablosundan SIMD ile
+            survtab_slots(table, batch_slots);
+            for (size_t j = 0; j < survivor_count; j++)
+                batch_survivors[j] = table->owner[batch_slots[j]];
+            for (size_t i = 0; i < drone_count; i++)
+            {
+                int32_t *row = batch_benefit + i * survivor_count;
+                survtab_score(table, batch_drones[i].pos, now, batch_scores);
+                for (size_t j = 0; j < survivor_count; j++)
+                    row[j] = batch_scores[batch_slots[j]];
+            }
+        }
+        else
+        {
+            survgrid_collect(&survivor_grid, batch_survivors);
+            for (size_t i = 0; i < drone_count; i++)
+            {
+                int32_t *row = batch_benefit + i * survivor_count;
+                Coordinate pos = batch_drones[i].pos;
+                for (size_t j = 0; j < survivor_count; j++)
+                {
+                    const Survivor *s = batch_survivors[j];
+                    int dist = navmap_cost(&nav_map, pos, s->coord);
+                    row[j] = dist < 0 ? NAV_UNREACHABLE_BENEFIT
+                                      : (int32_t)SURVGRID_SCORE(s->priority, now - s->creation_time, dist);
+                }
+            }
+        }
+
+        AuctionStats solve_stats;
+        if (auction_assign(batch_benefit, (int)drone_count, (int)survivor_count, batch_choice, &solve_stats))
+        {
+            double solve_ms = elapsed_ms(&started);
+            record_plan_time(solve_ms);
+
+            int assigned = 0;
+            for (size_t i = 0; i < drone_count; i++)
+            {
+                if (batch_choice[i] < 0)
+                    continue;
+                Survivor *s = batch_survivors[batch_choice[i]];
+                if (apply_planned_assignment(&batch_drones[i], s, now, batch_benefit[i * survivor_count + batch_choice[i]]))
+                    assigned++;
+            }
+            printf("Controller: batch assigned %d of %zu idle drones over %zu survivors, total score %lld, "
+                   "solved in %.2f ms (%lu bids, %d phases)\n",
+                   assigned, drone_count, survivor_count, (long long)solve_stats.total_benefit,
+                   solve_ms, solve_stats.bids, solve_stats.phases);
+        }
+    }
+    pthread_mutex_unlock(&survivor_lock);
+    epoch_exit();
+}
+
+// Bölgesel atama: boştaki drone'lar bölgelerine göre işçi havuzunda paralel
+// planlanır (bkz. region.h), sonra bu thread'de sırayla uygulanır. Geniş
+// haritalar içindir; küçük haritada neredeyse her drone sınır uzlaştırmasına düşer.
+static void assign_region(void)
+{
+    epoch_enter();
+    size_t drone_count = collect_idle_drones();
+    pthread_mutex_lock(&survivor_lock);
+    if (drone_count > 0 && survivor_grid.count > 0 &&
+        reserve_buffer((void **)&region_plan_drones, &region_plan_cap, drone_count, sizeof(PlanDrone)))
+    {
+        struct timespec started;
+        clock_gettime(CLOCK_MONOTONIC, &started);
+        time_t now = time(NULL);
+        for (size_t i = 0; i < drone_count; i++)
+            region_plan_drones[i].pos = batch_drones[i].pos;
+        region_plan(&region_planner, region_plan_drones, (int)drone_count, now);
+        record_plan_time(elapsed_ms(&started));
+
+        for (size_t i = 0; i < drone_count; i++)
+        {
+            Survivor *s = region_plan_drones[i].pick;
+            if (s && !apply_planned_assignment(&batch_drones[i], s, now, region_plan_drones[i].score))
+                s->is_targeted = false; // Ayrılmıştı ama drone artık boşta değil
+        }
+    }
+    pthread_mutex_unlock(&survivor_lock);
+    epoch_exit();
+}
+
+// Görev boru hattı: boştaki drone'lar atandıktan sonra kalan survivor'lar görevdeki
+// drone'ların rotalarına eklenir. Önce son durağın yakınındaki küme (extend_route);
+// küme yoksa ve rota boşsa, mevcut hedeften skorlanan en iyi survivor tek durak
+// olarak verilir. Drone görevi bitirince yeni atamayı beklemeden sıradakine geçer.
+static void queue_next_missions(void)
+{
+    epoch_enter();
+    for (int si = 0; si < shard_count; si++)
+    {
+        ReactorShard *shard = &shards[si];
+        const FleetSnapshot *fleet = __atomic_load_n(&shard->fleet, __ATOMIC_ACQUIRE);
+        for (int i = 0; fleet && i < fleet->count; i++)
+        {
+            const FleetEntry *entry = &fleet->entries[i];
+            if (entry->status != ON_MISSION || entry->route_len >= entry->route_capacity ||
+                entry->battery < QUEUE_MIN_BATTERY)
+                continue;
+            Drone *d = entry->drone;
+            pthread_mutex_lock(&survivor_lock);
+            pthread_mutex_lock(&d->lock);
+            DroneTelemetry t;
+            drone_load_telemetry(d, &t);
+            bool live = t.status == ON_MISSION && d->mission_key && d->sock > 0;
+            if (live && extend_route(shard, d) == 0 && d->route_len == 0)
             {
-                Node *temp_node_to_free = d_node_timeout;
-                if (d_prev_timeout == NULL)
-                { // Listenin başı
-                    drone_list->head = d_node_timeout->next;
-                    d_node_timeout = drone_list->head;
-                }
-                else
+                time_t now = time(NULL);
+                double score = -1.0;
+                Survivor *s = survgrid_best(&survivor_grid, d->target, now, &score);
+                if (s && queue_mission(shard, d, s))
                 {
-                    d_prev_timeout->next = d_node_timeout->next;
-                    d_node_timeout = d_prev_timeout->next;
+                    stat_queued_missions++;
+                    printf("Controller: Queued survivor S%d (Prio:%d, Score:%.2f) at (%d,%d) for drone D%d after (%d,%d).\n",
+                           s->id, s->priority, score, s->coord.x, s->coord.y, d->id, d->target.x, d->target.y);
                 }
-                drone_list->size--;
-                free_drone(temp_node_to_free->data); // Drone nesnesini serbest bırak
-                free(temp_node_to_free);             // Liste düğümünü serbest bırak
-                // d_node_timeout zaten güncellendi, d_prev_timeout aynı kalır
             }
-            else
+            pthread_mutex_unlock(&d->lock);
+            bool more = survivor_grid.count > 0;
+            pthread_mutex_unlock(&survivor_lock);
+            if (!more)
             {
-                d_prev_timeout = d_node_timeout;
-                d_node_timeout = d_node_timeout->next;
+                epoch_exit();
+                return;
             }
         }
-        pthread_mutex_unlock(&drone_list->lock);
+    }
+    epoch_exit();
+}
+
+// Olay güdümlü zamanlayıcı: survivor eklenmesi, drone'un boşa çıkması, drone kaybı
+// ve hedef iptali controller'ı hemen uyandırır. CONTROLLER_SWEEP_MS'lik periyodik
+// tarama sadece kaçan bir olaya karşı güvenlik ağıdır.
+void *controller(void *arg)
+{
+    (void)arg;
+    unsigned long event_passes = 0, sweeps = 0;
+    double latency_sum_ms = 0.0, latency_max_ms = 0.0;
+    uint64_t next_sweep_ms = monotonic_ms() + CONTROLLER_SWEEP_MS;
+    epoch_register();
 
-        // 2. Boştaki drone'lara görev ata
-        pthread_mutex_lock(&drone_list->lock);
-        Node *d_node_assign = drone_list->head;
-        while (d_node_assign)
+    pthread_mutex_lock(&controller_lock);
+    while (server_running)
+    {
+        uint64_t now_ms = monotonic_ms();
+        if (controller_events == 0 && now_ms < next_sweep_ms)
         {
-            Drone *d = (Drone *)d_node_assign->data;
-            pthread_mutex_lock(&d->lock);
+            struct timespec deadline = {.tv_sec = (time_t)(next_sweep_ms / 1000),
+                                        .tv_nsec = (long)(next_sweep_ms % 1000) * 1000000};
+            pthread_cond_timedwait(&controller_wakeup, &controller_lock, &deadline);
+            continue;
+        }
+        unsigned events = controller_events;
+        uint64_t event_ns = controller_event_ns;
+        controller_events = 0;
+        pthread_mutex_unlock(&controller_lock);
 
-            // Sadece IDLE, pili olan ve hala bağlı olan drone'ları değerlendir
-            if (d->status == IDLE && d->battery > 0 && d->sock > 0)
-            {
-                Coordinate drone_current_pos = d->coord; // Pozisyonu kilit altındayken al
-                pthread_mutex_unlock(&d->lock);          // Survivor ararken drone kilidini serbest bırak
+        // Zaman aşımına uğrayan drone'lar artık drone_reactor_loop tarafından düşürülüyor.
 
-                Survivor *best_survivor_to_assign = NULL;
-                // int min_dist_for_best = -1; // GÜNCELLENDİ: Skorlama kullanılacak
-                double max_score = -1.0; // En iyi skoru bulmak için
+        pthread_mutex_lock(&survivor_lock);
+        drain_survivor_events_locked(); // Yeni, kurtarılan ve bırakılan survivor'lar
+        if (now_ms >= next_sweep_ms)
+        {
+            // Silmelerle gevşeyen skor sınırlarını taramada daralt
+            survgrid_refresh_bounds(&survivor_grid);
+            next_sweep_ms = now_ms + CONTROLLER_SWEEP_MS;
+            sweeps++;
+        }
+        pthread_mutex_unlock(&survivor_lock);
 
-                pthread_mutex_lock(&survivor_list->lock);
-                Node *s_node = survivor_list->head;
-                time_t now = time(NULL);
-                while (s_node)
-                {
-                    Survivor *s = (Survivor *)s_node->data;
-                    if (!s->is_targeted)
-                    {
-                        int dist = abs(drone_current_pos.x - s->coord.x) +
-                                   abs(drone_current_pos.y - s->coord.y);
-                        time_t age = now - s->creation_time; // Yaş (saniye cinsinden)
-
-                        // Basit bir skorlama: Yüksek öncelik, daha yaşlı, daha yakın olan daha iyi.
-                        // Ağırlıkları ayarlayarak stratejiyi değiştirebilirsiniz.
-                        double score = (s->priority * 100.0) + (age * 1.0) - (dist * 2.0);
-                        // Örneğin: priority 3 ise +300, her saniye yaş için +1, her birim mesafe için -2 puan.
-
-                        if (best_survivor_to_assign == NULL || score > max_score)
-                        {
-                            max_score = score;
-                            best_survivor_to_assign = s;
-                        }
-                    }
-                    s_node = s_node->next;
-                }
+        if (assign_mode == ASSIGN_BATCH)
+            assign_batch();
+        else if (assign_mode == ASSIGN_REGION)
+            assign_region();
+        else
+            assign_greedy();
+        queue_next_missions();
 
-                if (best_survivor_to_assign)
-                {
-                    pthread_mutex_lock(&d->lock); // Drone'a atama yapmak için kilidi tekrar al
-                    // Son bir kontrol: Drone hala IDLE, pili var ve bağlı mı?
-                    if (d->status == IDLE && d->battery > 0 && d->sock > 0)
-                    {
-                        d->status = ON_MISSION;
-                        d->target = best_survivor_to_assign->coord;
-                        best_survivor_to_assign->is_targeted = true;
-
-                        json_object *mission_jobj = json_object_new_object();
-                        json_object_object_add(mission_jobj, "type", json_object_new_string("ASSIGN_MISSION"));
-                        char mission_id_str[50]; // Daha uzun mission_id için
-                        snprintf(mission_id_str, sizeof(mission_id_str), "M_Ctrl_D%dS%d_T%ld",
-                                 d->id, best_survivor_to_assign->id, (long)time(NULL));
-                        json_object_object_add(mission_jobj, "mission_id", json_object_new_string(mission_id_str));
-                        json_object *target_loc_jobj = json_object_new_object();
-                        json_object_object_add(target_loc_jobj, "x", json_object_new_int(best_survivor_to_assign->coord.x));
-                        json_object_object_add(target_loc_jobj, "y", json_object_new_int(best_survivor_to_assign->coord.y));
-                        json_object_object_add(mission_jobj, "target", target_loc_jobj);
-                        send_json_to_socket(d->sock, mission_jobj);
-                        json_object_put(mission_jobj);
-
-                        printf("Controller: Assigned drone D%d to survivor S%d (Prio:%d, Age:%lds, Dist:%d, Score:%.2f) at (%d,%d).\n",
-                               d->id, best_survivor_to_assign->id, best_survivor_to_assign->priority,
-                               (long)(now - best_survivor_to_assign->creation_time),
-                               abs(drone_current_pos.x - best_survivor_to_assign->coord.x) + abs(drone_current_pos.y - best_survivor_to_assign->coord.y),
-                               max_score,
-                               best_survivor_to_assign->coord.x, best_survivor_to_assign->coord.y);
-                    }
-                    else
-                    {
-                        // Atama sırasında drone durumu değişmiş, survivor'ı serbest bırak
-                        if (best_survivor_to_assign)
-                            best_survivor_to_assign->is_targeted = false;
-                    }
-                    pthread_mutex_unlock(&d->lock);
-                }
-                pthread_mutex_unlock(&survivor_list->lock);
-            }
-            else
-            { // Drone ON_MISSION, pili bitik veya soket kapalı
-                pthread_mutex_unlock(&d->lock);
-            }
-            d_node_assign = d_node_assign->next;
+        if (events)
+        {
+            double latency_ms = (monotonic_ns() - event_ns) / 1e6;
+            latency_sum_ms += latency_ms;
+            if (latency_ms > latency_max_ms)
+                latency_max_ms = latency_ms;
+            event_passes++;
         }
-        pthread_mutex_unlock(&drone_list->lock);
+        pthread_mutex_lock(&controller_lock);
     }
+    pthread_mutex_unlock(&controller_lock);
+
+    printf("Controller: %lu event passes, %lu sweeps, event-to-assignment latency mean %.3f ms, max %.3f ms\n",
+           event_passes, sweeps, event_passes ? latency_sum_ms / event_passes : 0.0, latency_max_ms);
+
+    pthread_mutex_lock(&survivor_lock);
+    printf("Controller (%s): %lu rescues, mean time-to-rescue %.1f s\n",
+           assign_mode_name(), stat_rescues,
+           stat_rescues ? stat_rescue_seconds / stat_rescues : 0.0);
+    printf("Controller: %lu survivor events drained from the intake queue\n", stat_survivor_events);
+    pthread_mutex_unlock(&survivor_lock);
+    printf("Controller: %lu missions queued ahead of completion\n", stat_queued_missions);
+    if (stat_routes)
+        printf("Controller: %lu cluster routes, %.2f stops per route\n", stat_routes,
+               (double)stat_route_stops / stat_routes);
+    if (stat_plan_passes)
+        printf("Controller: %lu %s passes, mean %.2f ms, max %.2f ms\n", stat_plan_passes, assign_mode_name(),
+               stat_plan_ms / stat_plan_passes, stat_plan_max_ms);
+    if (assign_mode == ASSIGN_REGION)
+        printf("Controller: %d workers, %d regions, %lu drones reconciled at borders, %lu steals\n",
+               controller_pool->workers, region_planner.region_cols * region_planner.region_rows,
+               region_planner.stat_reconciled, controller_pool->stat_steals);
+    free(batch_drones);
+    free(batch_survivors);
+    free(batch_benefit);
+    free(batch_choice);
+    free(batch_slots);
+    free(batch_scores);
+    free(region_plan_drones);
+    epoch_unregister();
     printf("Controller thread exiting.\n");
     return NULL;
 }
@@ -622,26 +2592,28 @@ void *survivor_generator(void *arg)
         if (!server_running)
             break;
 
-        int x = rand() % 40;
-        int y = rand() % 60;
+        int x, y;
+        do
+        { // Uçuşa yasak bölgede survivor'a ulaşılamaz
+            x = rand() % MAP_X_LIMIT;
+            y = rand() % MAP_Y_LIMIT;
+        } while (navmap_blocked(&nav_map, (Coordinate){x, y}));
         int priority = (rand() % 3) + 1; // 1, 2, veya 3
 
         Survivor *s = create_survivor(survivor_id_counter++, x, y, priority);
         if (s)
         {
-            add_list(survivor_list, s);
+            navmap_track(&nav_map, s->coord); // Uzaklık alanı; kurtarılınca navmap_forget
             printf("Generated survivor S%d (Prio:%d) at (%d,%d).\n", s->id, s->priority, x, y);
+            // Controller'ın atama geçişini beklemeden kuyruğa; tabloya bir sonraki geçişte girer
+            post_survivor_event((SurvivorEvent){.type = SURVIVOR_CREATED, .survivor = s});
+            controller_notify(CONTROLLER_SURVIVOR_ADDED);
         }
     }
     printf("Survivor generator thread exiting.\n");
     return NULL;
 }
 
-int compare_view_socket_ptr(void *a, void *b)
-{
-    return (*(int *)a == *(int *)b) ? 0 : 1; // Değerleri karşılaştır
-}
-
 void *handle_view_client(void *arg)
 {
     int *sock_ptr_in_list = (int *)arg; // GÜNCELLENDİ: Argüman artık listedeki int*'ın kendisi
@@ -716,12 +2688,7 @@ void *handle_view_client(void *arg)
         // Listeden çıkarma view_broadcast'e veya ana kapatmaya bırakılacak
         // ya da burada da yapılabilir. Şimdilik soketi kapat.
         close(sock);
-        // `sock_ptr_in_list` view_broadcast'te veya destroy_list'te free edilecek.
-        // Eğer burada çıkarılacaksa:
-        // pthread_mutex_lock(&view_sockets->lock);
-        // remove_list(view_sockets, sock_ptr_in_list, compare_exact_pointer_address); // Pointer adresine göre
-        // pthread_mutex_unlock(&view_sockets->lock);
-        // free(sock_ptr_in_list); // Eğer remove_list bunu free etmiyorsa
+        // `sock_ptr_in_list` view_broadcast'te veya destroy_hashmap'te free edilecek.
         return NULL;
     }
 
@@ -774,49 +2741,256 @@ void *handle_view_client(void *arg)
     // En iyisi view_broadcast'in send hatasında ele alması.
     // Ama bu thread bittiğinde soket hala listedeyse ve view_broadcast onu kullanmaya çalışırsa?
     // Bu yüzden, bu thread çıkarken listeden çıkarmak daha güvenli olabilir.
-    pthread_mutex_lock(&view_sockets->lock);
-    // `compare_view_socket_ptr` listedeki `int*`'ların *değerlerini* karşılaştırır.
-    // Biz ise `sock_ptr_in_list` adresinin kendisini listeden çıkarmak istiyoruz.
-    // Bu yüzden `compare_exact_pointer` gibi bir fonksiyona ihtiyaç var.
-    // Veya `remove_list` içinde `data == node->data` şeklinde basit bir karşılaştırma yapılır.
-    // Şimdilik, `view_broadcast`teki send hatasıyla çıkarmaya güvenelim.
-    // Ya da `sock_ptr_in_list`'in değerini -1 yaparak `view_broadcast`'in onu atlamasını sağlayabiliriz.
+    // Soketi -1 ile işaretle: view_broadcast atlar ve bir sonraki turda map'ten çıkarıp bırakır.
+    pthread_mutex_lock(&view_send_lock);
     if (*sock_ptr_in_list > 0)
     {
         close(*sock_ptr_in_list);
         *sock_ptr_in_list = -1; // view_broadcast'in bu soketi atlaması için işaretle
     }
-    pthread_mutex_unlock(&view_sockets->lock);
+    pthread_mutex_unlock(&view_send_lock);
+
+    return NULL;
+}
+
+// Unix soketinden bağlanan yerel view: HANDSHAKE'e, paylaşımlı bellek bölgesinin
+// salt okunur tanıtıcısını taşıyan ACK ile yanıt verir. Sonrasında soket sadece
+// bağlantının canlılığını izler; durum view_broadcast'in yayınladığı bölgeden okunur.
+void *handle_local_view_client(void *arg)
+{
+    int sock = *(int *)arg;
+    free(arg);
+    printf("Local view client handler started for socket %d\n", sock);
+
+    fd_set read_fds;
+    struct timeval tv = {.tv_sec = 5, .tv_usec = 0}; // Handshake timeout
+    FD_ZERO(&read_fds);
+    FD_SET(sock, &read_fds);
+    bool handshake_done = false;
+    char buffer[1024];
+    if (select(sock + 1, &read_fds, NULL, NULL, &tv) > 0)
+    {
+        int len = recv(sock, buffer, sizeof(buffer) - 1, 0);
+        if (len > 0)
+        {
+            buffer[len] = '\0';
+            json_object *jobj = json_tokener_parse(buffer);
+            const char *type = jobj ? json_object_get_string(json_object_object_get(jobj, "type")) : NULL;
+            if (type && strcmp(type, "VIEW_HANDSHAKE") == 0)
+            {
+                json_object *ack = json_object_new_object();
+                json_object_object_add(ack, "type", json_object_new_string("VIEW_HANDSHAKE_ACK"));
+                json_object_object_add(ack, "transport", json_object_new_string("shm"));
+                json_object_object_add(ack, "size", json_object_new_int64(sizeof(SnapshotRegion)));
+                const char *str = json_object_to_json_string(ack);
+
+                // ACK ve tanıtıcı tek sendmsg ile: alıcı recvmsg ile ikisini birlikte alır
+                struct iovec iov = {.iov_base = (void *)str, .iov_len = strlen(str)};
+                char control[CMSG_SPACE(sizeof(int))];
+                memset(control, 0, sizeof(control));
+                struct msghdr msg = {.msg_iov = &iov, .msg_iovlen = 1, .msg_control = control,
+                                     .msg_controllen = sizeof(control)};
+                struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+                cmsg->cmsg_level = SOL_SOCKET;
+                cmsg->cmsg_type = SCM_RIGHTS;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+                memcpy(CMSG_DATA(cmsg), &snapshot_ro_fd, sizeof(int));
+                handshake_done = sendmsg(sock, &msg, MSG_NOSIGNAL) == (ssize_t)iov.iov_len;
+                json_object_put(ack);
+            }
+            if (jobj)
+                json_object_put(jobj);
+        }
+    }
+    if (!handshake_done)
+    {
+        printf("Local view client (socket %d) handshake failed. Closing.\n", sock);
+        close(sock);
+        return NULL;
+    }
+    printf("Local view client (socket %d) mapped shared snapshot.\n", sock);
 
+    while (server_running)
+    {
+        FD_ZERO(&read_fds);
+        FD_SET(sock, &read_fds);
+        tv.tv_sec = 1; // Periyodik server_running kontrolü
+        tv.tv_usec = 0;
+        int activity = select(sock + 1, &read_fds, NULL, NULL, &tv);
+        if (activity < 0 && errno != EINTR)
+            break;
+        if (activity > 0 && recv(sock, buffer, sizeof(buffer), MSG_DONTWAIT) <= 0)
+        {
+            printf("Local view client (socket %d) disconnected.\n", sock);
+            break;
+        }
+    }
+    close(sock);
     return NULL;
 }
 
+// Drone görüntülerini ve survivor listesini paylaşımlı bölgenin boştaki çerçevesine
+// yazıp yayınlar. Drone'lar, JSON yayını gibi, shard görüntülerinden kilitsiz okunur.
+void publish_snapshot()
+{
+    SnapshotFrame *frame = snapshot_begin_write(snapshot_region);
+    frame->timestamp = time(NULL);
+    frame->drone_count = 0;
+    frame->drones_dropped = 0;
+    epoch_enter();
+    for (int si = 0; si < shard_count; si++)
+    {
+        const FleetSnapshot *fleet = __atomic_load_n(&shards[si].fleet, __ATOMIC_ACQUIRE);
+        for (int i = 0; fleet && i < fleet->count; i++)
+        {
+            const FleetEntry *d = &fleet->entries[i];
+            if (frame->drone_count == SNAPSHOT_MAX_DRONES)
+            {
+                frame->drones_dropped++;
+                continue;
+            }
+            SnapshotDrone *out = &frame->drones[frame->drone_count++];
+            out->id = d->id;
+            out->x = d->coord.x;
+            out->y = d->coord.y;
+            out->target_x = d->target.x;
+            out->target_y = d->target.y;
+            out->battery = d->battery;
+            out->status = (uint8_t)d->status;
+        }
+    }
+    epoch_exit();
+
+    frame->survivor_count = 0;
+    frame->survivors_dropped = 0;
+    pthread_mutex_lock(&survivor_lock);
+    size_t pos = 0;
+    Survivor *sv;
+    while ((sv = idtable_next(&survivor_table, &pos)) != NULL)
+    {
+        if (frame->survivor_count == SNAPSHOT_MAX_SURVIVORS)
+        {
+            frame->survivors_dropped++;
+            continue;
+        }
+        SnapshotSurvivor *out = &frame->survivors[frame->survivor_count++];
+        out->id = sv->id;
+        out->x = sv->coord.x;
+        out->y = sv->coord.y;
+        out->priority = sv->priority;
+        out->is_targeted = sv->is_targeted;
+    }
+    pthread_mutex_unlock(&survivor_lock);
+    snapshot_publish(snapshot_region, frame);
+}
+
+// view_broadcast'in tur başında topladığı soket işaretçileri (sadece o thread kullanır).
+static int **view_batch = NULL;
+static size_t view_batch_count = 0, view_batch_cap = 0;
+
+static void collect_view(void *data, void *ctx)
+{
+    (void)ctx;
+    if (reserve_buffer((void **)&view_batch, &view_batch_cap, view_batch_count + 1, sizeof(int *)))
+        view_batch[view_batch_count++] = data;
+}
+
+static void close_view_socket(void *data, void *ctx)
+{
+    (void)ctx;
+    int *sock_ptr = data;
+    if (*sock_ptr > 0)
+    {
+        close(*sock_ptr);
+        *sock_ptr = -1;
+    }
+}
+
+// Yayın yükünü view_batch'teki soketlere gönderir; başarısız olan soketleri kapatıp -1 ile işaretler.
+// io_uring modunda tüm gönderimler tek io_uring_enter ile kernel'e verilir.
+// view_send_lock tutularak çağrılır.
+void send_to_views(Uring *ring, const char *line, size_t len)
+{
+    int submitted = 0;
+    for (size_t i = 0; i < view_batch_count; i++)
+    {
+        int *sock_ptr = view_batch[i];
+        if (*sock_ptr <= 0)
+            continue;
+        struct io_uring_sqe *sqe = ring ? uring_get_sqe(ring) : NULL;
+        if (sqe)
+        {
+            uring_prep_send(sqe, *sock_ptr, line, len, (uint64_t)(uintptr_t)sock_ptr);
+            submitted++;
+        }
+        else if (send(*sock_ptr, line, len, MSG_NOSIGNAL) < (ssize_t)len)
+        {
+            printf("View client (socket %d) send error/disconnected, removing from broadcast list.\n", *sock_ptr);
+            close(*sock_ptr);
+            *sock_ptr = -1;
+        }
+    }
+
+    while (submitted > 0)
+    {
+        if (uring_submit_and_wait(ring, 1000) < 0)
+            break;
+        struct io_uring_cqe *cqe;
+        while ((cqe = uring_peek_cqe(ring)) != NULL)
+        {
+            int *sock_ptr = (int *)(uintptr_t)cqe->user_data;
+            if (cqe->res < (int)len && *sock_ptr > 0)
+            {
+                printf("View client (socket %d) send error/disconnected, removing from broadcast list.\n", *sock_ptr);
+                close(*sock_ptr);
+                *sock_ptr = -1;
+            }
+            uring_cqe_seen(ring);
+            submitted--;
+        }
+        if (!server_running)
+            break;
+    }
+}
+
 void *view_broadcast(void *arg)
 {
     (void)arg;
+    Uring view_ring;
+    bool use_ring = io_backend == IO_BACKEND_URING && uring_init(&view_ring, MAX_VIEWS);
+    char *line = NULL;
+    size_t line_cap = 0;
+    unsigned tick = 0;
+    epoch_register();
     while (server_running)
     {
-        // Güncelleme sıklığı (server_running kontrolü için daha kısa sleep)
-        for (int i = 0; i < 1 && server_running; ++i)
-        { // 1 saniye bekle
-            sleep(1);
-        }
+        struct timespec ts = {.tv_sec = 0, .tv_nsec = VIEW_TICK_MS * 1000000L};
+        nanosleep(&ts, NULL);
         if (!server_running)
             break;
 
+        // Yerel view'lar her turda, serileştirme olmadan güncellenir
+        if (snapshot_region)
+            publish_snapshot();
+        if (++tick % VIEW_JSON_TICKS != 0)
+            continue;
+        // TCP view yoksa JSON hiç üretilmez
+        if (get_hashmap_size(view_sockets) == 0)
+            continue;
+
         json_object *state_jobj = json_object_new_object();
         json_object_object_add(state_jobj, "type", json_object_new_string("STATE_UPDATE"));
         json_object_object_add(state_jobj, "timestamp", json_object_new_int64(time(NULL)));
 
         json_object *drones_arr = json_object_new_array();
-        pthread_mutex_lock(&drone_list->lock);
-        Node *d_node = drone_list->head;
-        while (d_node)
+        epoch_enter();
+        for (int si = 0; si < shard_count; si++)
         {
-            Drone *d = (Drone *)d_node->data;
-            pthread_mutex_lock(&d->lock);
-            if (d->sock > 0)
-            { // Sadece aktif soketi olan ve listeden çıkarılmamış dronelar
+            // Görüntüde sadece aktif soketi olan ve listeden çıkarılmamış drone'lar var
+            const FleetSnapshot *fleet = __atomic_load_n(&shards[si].fleet, __ATOMIC_ACQUIRE);
+            for (int i = 0; fleet && i < fleet->count; i++)
+            {
+                const FleetEntry *d = &fleet->entries[i];
                 json_object *d_obj = json_object_new_object();
                 json_object_object_add(d_obj, "id", json_object_new_int(d->id));
                 json_object *loc = json_object_new_object();
@@ -831,18 +3005,16 @@ void *view_broadcast(void *arg)
                 json_object_object_add(d_obj, "battery", json_object_new_int(d->battery));
                 json_object_array_add(drones_arr, d_obj);
             }
-            pthread_mutex_unlock(&d->lock);
-            d_node = d_node->next;
         }
-        pthread_mutex_unlock(&drone_list->lock);
+        epoch_exit();
         json_object_object_add(state_jobj, "drones", drones_arr);
 
         json_object *survivors_arr = json_object_new_array();
-        pthread_mutex_lock(&survivor_list->lock);
-        Node *s_node = survivor_list->head;
-        while (s_node)
+        pthread_mutex_lock(&survivor_lock);
+        size_t pos = 0;
+        Survivor *s;
+        while ((s = idtable_next(&survivor_table, &pos)) != NULL)
         {
-            Survivor *s = (Survivor *)s_node->data;
             json_object *s_obj = json_object_new_object();
             json_object_object_add(s_obj, "id", json_object_new_int(s->id));
             json_object *loc = json_object_new_object();
@@ -852,9 +3024,8 @@ void *view_broadcast(void *arg)
             json_object_object_add(s_obj, "priority", json_object_new_int(s->priority));
             json_object_object_add(s_obj, "is_targeted", json_object_new_boolean(s->is_targeted)); // GUI için
             json_object_array_add(survivors_arr, s_obj);
-            s_node = s_node->next;
         }
-        pthread_mutex_unlock(&survivor_list->lock);
+        pthread_mutex_unlock(&survivor_lock);
         json_object_object_add(state_jobj, "survivors", survivors_arr);
 
         const char *json_str_payload = json_object_to_json_string_ext(state_jobj, JSON_C_TO_STRING_PLAIN | JSON_C_TO_STRING_NOSLASHESCAPE);
@@ -865,139 +3036,78 @@ void *view_broadcast(void *arg)
             continue;
         }
 
-        pthread_mutex_lock(&view_sockets->lock);
-        Node *v_node = view_sockets->head;
-        Node *v_prev = NULL;
-        while (v_node)
+        // Yük ve satır sonu tek tamponda: view başına tek send
+        size_t payload_len = strlen(json_str_payload);
+        if (payload_len + 1 > line_cap)
         {
-            int *sock_ptr = (int *)v_node->data;
-            bool remove_current_view_socket = false;
-
-            if (sock_ptr && *sock_ptr > 0)
-            { // Geçerli bir soket mi?
-                if (send(*sock_ptr, json_str_payload, strlen(json_str_payload), MSG_NOSIGNAL) < 0 ||
-                    send(*sock_ptr, "\n", 1, MSG_NOSIGNAL) < 0)
-                {
-                    // perror("send to view client failed"); // Çok fazla log üretebilir
-                    printf("View client (socket %d) send error/disconnected, removing from broadcast list.\n", *sock_ptr);
-                    close(*sock_ptr);
-                    *sock_ptr = -1; // Artık geçersiz olarak işaretle (handle_view_client da bunu yapabilir)
-                    remove_current_view_socket = true;
-                }
-            }
-            else if (sock_ptr && *sock_ptr == -1)
-            { // handle_view_client tarafından kapatılmış
-                printf("View client (socket marked -1) found in list, removing.\n");
-                remove_current_view_socket = true;
-            }
-
-            if (remove_current_view_socket)
+            char *grown = realloc(line, payload_len + 1);
+            if (!grown)
             {
-                Node *to_remove = v_node;
-                if (v_prev)
-                {
-                    v_prev->next = v_node->next;
-                    v_node = v_node->next; // v_node'u ilerlet, v_prev aynı kalsın
-                }
-                else
-                { // Listenin başı
-                    view_sockets->head = v_node->next;
-                    v_node = view_sockets->head; // v_node'u ilerlet, v_prev NULL olacak
-                }
-                if (sock_ptr)
-                    free(sock_ptr); // Malloc ile alınan int* 'ı serbest bırak
-                free(to_remove);    // Liste node'unu serbest bırak
-                view_sockets->size--;
-                // v_node zaten güncellendi, döngüye devam et
+                json_object_put(state_jobj);
+                continue;
             }
-            else
-            {
-                v_prev = v_node;
-                v_node = v_node->next;
+            line = grown;
+            line_cap = payload_len + 1;
+        }
+        memcpy(line, json_str_payload, payload_len);
+        line[payload_len] = '\n';
+
+        pthread_mutex_lock(&view_send_lock);
+        view_batch_count = 0;
+        iterate_hashmap(view_sockets, collect_view, NULL);
+        send_to_views(use_ring ? &view_ring : NULL, line, payload_len + 1);
+        for (size_t i = 0; i < view_batch_count; i++)
+        {
+            int *sock_ptr = view_batch[i];
+            if (*sock_ptr == -1)
+            { // Gönderim hatası ya da handle_view_client kapattı
+                printf("View client (socket marked -1) found in list, removing.\n");
+                remove_hashmap(view_sockets, hashmap_ptr_key(sock_ptr));
+                free(sock_ptr);
             }
         }
-        pthread_mutex_unlock(&view_sockets->lock);
+        pthread_mutex_unlock(&view_send_lock);
         json_object_put(state_jobj); // Ana JSON nesnesini serbest bırak
     }
+    free(line);
+    free(view_batch);
+    view_batch = NULL;
+    view_batch_count = view_batch_cap = 0;
+    if (use_ring)
+        uring_destroy(&view_ring);
+    epoch_unregister();
     printf("View broadcast thread exiting.\n");
     return NULL;
 }
 
-void *drone_accept_loop(void *arg)
+// Yerel view'lar için paylaşımlı bölge ve Unix kontrol soketi. Başarısız olursa
+// sunucu sadece TCP view'larla devam eder.
+void create_local_view_transport()
 {
-    int server_fd = *(int *)arg; // server_fd değerini al, arg (p_server_fd) main'de free edilecek
-    printf("Drone acceptor listening on port %d\n", PORT);
-
-    // server_fd'yi non-blocking yapmak yerine select/poll ile accept edebiliriz
-    // ya da shutdown sırasında server_fd'yi kapatarak accept'i sonlandırabiliriz.
-    // Şimdilik server_running ile devam edelim.
-    // accept'in timeout'lu olması için setsockopt ile SO_RCVTIMEO ayarlanabilir.
-
-    struct timeval tv_accept;
-    fd_set accept_fds;
-
-    while (server_running)
+    snapshot_region = snapshot_create(&snapshot_fd);
+    if (!snapshot_region || (snapshot_ro_fd = snapshot_open_readonly(snapshot_fd)) < 0)
     {
-        FD_ZERO(&accept_fds);
-        FD_SET(server_fd, &accept_fds);
-        tv_accept.tv_sec = 1; // 1 saniye timeout ile accept beklemesi
-        tv_accept.tv_usec = 0;
-
-        int activity = select(server_fd + 1, &accept_fds, NULL, NULL, &tv_accept);
-
-        if (activity < 0 && errno != EINTR)
-        {
-            if (!server_running)
-                break; // Kapanış sırasında select hatası olabilir
-            perror("select error in drone_accept_loop");
-            continue;
-        }
-
-        if (!server_running)
-            break;
-
-        if (activity > 0 && FD_ISSET(server_fd, &accept_fds))
-        {
-            struct sockaddr_in client_addr;
-            socklen_t addr_len = sizeof(client_addr);
-            int *client_sock_ptr = malloc(sizeof(int));
-            if (!client_sock_ptr)
-            {
-                perror("malloc for client_sock_ptr failed in drone_accept");
-                continue; // Veya sunucuyu kapat
-            }
-
-            *client_sock_ptr = accept(server_fd, (struct sockaddr *)&client_addr, &addr_len);
-            if (*client_sock_ptr < 0)
-            {
-                if (!server_running && (errno == EBADF || errno == EINVAL))
-                { // Sunucu soketi kapatılmış olabilir
-                    free(client_sock_ptr);
-                    break;
-                }
-                perror("accept for drone failed");
-                free(client_sock_ptr);
-                continue;
-            }
-            char client_ip[INET_ADDRSTRLEN];
-            inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
-            printf("Accepted new drone connection from %s:%d (socket %d)\n", client_ip, ntohs(client_addr.sin_port), *client_sock_ptr);
+        perror("shared snapshot for local views failed");
+        snapshot_destroy(snapshot_region, snapshot_fd);
+        snapshot_region = NULL;
+        snapshot_fd = -1;
+        return;
+    }
 
-            pthread_t drone_thread;
-            if (pthread_create(&drone_thread, NULL, handle_drone, client_sock_ptr) != 0)
-            {
-                perror("pthread_create for handle_drone failed");
-                close(*client_sock_ptr);
-                free(client_sock_ptr);
-            }
-            else
-            {
-                pthread_detach(drone_thread);
-            }
-        }
+    view_unix_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    strncpy(addr.sun_path, VIEW_UNIX_PATH, sizeof(addr.sun_path) - 1);
+    unlink(VIEW_UNIX_PATH); // Önceki çalışmadan kalan soket dosyası
+    if (view_unix_fd < 0 || bind(view_unix_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(view_unix_fd, MAX_VIEWS) < 0)
+    {
+        perror("unix socket for local views failed");
+        if (view_unix_fd >= 0)
+            close(view_unix_fd);
+        view_unix_fd = -1;
+        return;
     }
-    printf("Drone accept loop exiting.\n");
-    return NULL;
+    printf("Local view transport on %s (%zu byte shared snapshot)\n", VIEW_UNIX_PATH, sizeof(SnapshotRegion));
 }
 
 void *view_accept_loop(void *arg)
@@ -1012,10 +3122,17 @@ void *view_accept_loop(void *arg)
     {
         FD_ZERO(&accept_fds_view);
         FD_SET(view_server_fd, &accept_fds_view);
+        int max_fd = view_server_fd;
+        if (view_unix_fd >= 0)
+        {
+            FD_SET(view_unix_fd, &accept_fds_view);
+            if (view_unix_fd > max_fd)
+                max_fd = view_unix_fd;
+        }
         tv_accept_view.tv_sec = 1;
         tv_accept_view.tv_usec = 0;
 
-        int activity = select(view_server_fd + 1, &accept_fds_view, NULL, NULL, &tv_accept_view);
+        int activity = select(max_fd + 1, &accept_fds_view, NULL, NULL, &tv_accept_view);
 
         if (activity < 0 && errno != EINTR)
         {
@@ -1027,6 +3144,28 @@ void *view_accept_loop(void *arg)
         if (!server_running)
             break;
 
+        if (activity > 0 && view_unix_fd >= 0 && FD_ISSET(view_unix_fd, &accept_fds_view))
+        {
+            int *local_sock = malloc(sizeof(int));
+            if (local_sock && (*local_sock = accept4(view_unix_fd, NULL, NULL, SOCK_CLOEXEC)) >= 0)
+            {
+                pthread_t local_thread;
+                if (pthread_create(&local_thread, NULL, handle_local_view_client, local_sock) == 0)
+                    pthread_detach(local_thread);
+                else
+                {
+                    perror("pthread_create for handle_local_view_client failed");
+                    close(*local_sock);
+                    free(local_sock);
+                }
+            }
+            else
+            {
+                perror("accept for local view client failed");
+                free(local_sock);
+            }
+        }
+
         if (activity > 0 && FD_ISSET(view_server_fd, &accept_fds_view))
         {
             struct sockaddr_in client_addr;
@@ -1060,22 +3199,25 @@ void *view_accept_loop(void *arg)
             // Daha basit: handle_view_client'a `view_client_sock_ptr`'ı ver, o listeye eklesin/çıkarsın.
             // Ya da burada listeye ekle, handle_view_client sadece işaretlesin/kapatsın, broadcast çıkarsın.
 
-            // `view_client_sock_ptr`'ı listeye ekle, `handle_view_client` bu pointer'ı argüman olarak alacak.
-            add_list(view_sockets, view_client_sock_ptr);
+            // `view_client_sock_ptr`'ı map'e ekle, `handle_view_client` bu pointer'ı argüman olarak alacak.
+            if (!put_hashmap(view_sockets, hashmap_ptr_key(view_client_sock_ptr), view_client_sock_ptr))
+            {
+                close(*view_client_sock_ptr);
+                free(view_client_sock_ptr);
+                continue;
+            }
 
             pthread_t view_thread;
             // handle_view_client'a view_client_sock_ptr'ı (int** değil, int* yani malloc'lanmış adres) doğrudan geç.
             if (pthread_create(&view_thread, NULL, handle_view_client, view_client_sock_ptr) != 0)
             {
                 perror("pthread_create for handle_view_client failed");
+                // view_broadcast bu soketi o an kullanıyor olabilir: gönderim kilidiyle çıkar
+                pthread_mutex_lock(&view_send_lock);
                 close(*view_client_sock_ptr);
-                // Listeden çıkarmak gerekebilir, eğer eklendiyse. `compare_view_socket_ptr` ile değeri arar.
-                // Veya pointer adresiyle: `remove_list(view_sockets, view_client_sock_ptr, compare_exact_pointer_address);`
-                // Şimdilik, view_broadcast'in temizlemesine güven.
-                pthread_mutex_lock(&view_sockets->lock);
-                remove_list(view_sockets, view_client_sock_ptr, compare_view_socket_ptr); // Değere göre arayıp çıkar
-                pthread_mutex_unlock(&view_sockets->lock);
-                free(view_client_sock_ptr); // `remove_list` datayı free etmiyorsa
+                remove_hashmap(view_sockets, hashmap_ptr_key(view_client_sock_ptr));
+                pthread_mutex_unlock(&view_send_lock);
+                free(view_client_sock_ptr);
             }
             else
             {
@@ -1087,7 +3229,19 @@ void *view_accept_loop(void *arg)
     return NULL;
 }
 
-int main()
+// Binlerce eşzamanlı drone bağlantısı için açık dosya limitini hard limite çeker.
+void raise_fd_limit()
+{
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max)
+    {
+        rl.rlim_cur = rl.rlim_max;
+        if (setrlimit(RLIMIT_NOFILE, &rl) < 0)
+            perror("setrlimit(RLIMIT_NOFILE) failed");
+    }
+}
+
+int main(int argc, char *argv[])
 {
     srand(time(NULL));
 
@@ -1098,94 +3252,165 @@ int main()
     // Bunun yerine send hatalarını kontrol etmek daha iyi. MSG_NOSIGNAL kullanılır.
     // signal(SIGPIPE, SIG_IGN);
 
-    drone_list = create_list();
-    survivor_list = create_list();
-    view_sockets = create_list();
+    raise_fd_limit();
+
+    pthread_condattr_t controller_cond_attr;
+    pthread_condattr_init(&controller_cond_attr);
+    pthread_condattr_setclock(&controller_cond_attr, CLOCK_MONOTONIC); // Saat ayarından etkilenmesin
+    pthread_cond_init(&controller_wakeup, &controller_cond_attr);
+    pthread_condattr_destroy(&controller_cond_attr);
+    mpsc_init(&survivor_events);
+    if (!survgrid_init(&survivor_grid, MAP_X_LIMIT, MAP_Y_LIMIT, SURVIVOR_GRID_CELL) ||
+        !idtable_init(&survivor_table, 256) || !idtable_init(&mission_table, 256) ||
+        !(drone_table = create_hashmap()) || !(view_sockets = create_hashmap()) ||
+        !navmap_init(&nav_map, MAP_X_LIMIT, MAP_Y_LIMIT))
+    {
+        perror("Survivor grid / lookup table / nav map init failed");
+        exit(EXIT_FAILURE);
+    }
 
-    int server_fd = socket(AF_INET, SOCK_STREAM, 0);
-    // ... (socket, setsockopt, bind, listen for server_fd) ...
-    if (server_fd < 0)
+    // Reactor sayısı: varsayılan olarak çevrimiçi çekirdek sayısı
+    shard_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    for (int i = 1; i < argc; i++)
     {
-        perror("socket for drones failed");
-        return 1;
+        if (strcmp(argv[i], "--reactors") == 0 && i + 1 < argc)
+            shard_count = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--io") == 0 && i + 1 < argc)
+            io_backend = strcmp(argv[++i], "uring") == 0 ? IO_BACKEND_URING : IO_BACKEND_EPOLL;
+        else if (strcmp(argv[i], "--json-only") == 0)
+            binary_protocol_enabled = false;
+        else if (strcmp(argv[i], "--udp") == 0)
+            udp_telemetry_enabled = true;
+        else if (strcmp(argv[i], "--assign") == 0 && i + 1 < argc)
+        {
+            const char *mode = argv[++i];
+            assign_mode = strcmp(mode, "batch") == 0    ? ASSIGN_BATCH
+                          : strcmp(mode, "region") == 0 ? ASSIGN_REGION
+                                                        : ASSIGN_GREEDY;
+        }
+        else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc)
+            controller_workers = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--no-fly") == 0 && i + 1 < argc)
+        {
+            int x0, y0, x1, y1;
+            if (sscanf(argv[++i], "%d,%d,%d,%d", &x0, &y0, &x1, &y1) != 4)
+            {
+                fprintf(stderr, "--no-fly expects x0,y0,x1,y1\n");
+                return 1;
+            }
+            navmap_block(&nav_map, x0, y0, x1, y1);
+        }
     }
-    struct sockaddr_in server_addr = {0};
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_addr.s_addr = INADDR_ANY;
-    server_addr.sin_port = htons(PORT);
-    int opt = 1;
-    if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0)
+    if (nav_map.blocked_count == MAP_X_LIMIT * MAP_Y_LIMIT)
     {
-        perror("setsockopt(SO_REUSEADDR) for drones failed");
-        close(server_fd);
+        fprintf(stderr, "--no-fly zones cover the whole map\n");
         return 1;
     }
-    if (bind(server_fd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0)
+    if (nav_map.blocked_count > 0)
+    { // Engel yoksa yol maliyeti Manhattan'dır; skorlama kancası gereksiz
+        survgrid_set_distance(&survivor_grid, nav_distance, &nav_map);
+        printf("No-fly zones: %d of %d cells blocked, assignment scores by A* path cost\n", nav_map.blocked_count,
+               MAP_X_LIMIT * MAP_Y_LIMIT);
+    }
+    if (shard_count < 1)
+        shard_count = 1;
+    if (shard_count > MAX_REACTORS)
+        shard_count = MAX_REACTORS;
+
+    if (assign_mode == ASSIGN_REGION)
     {
-        perror("bind for drones failed");
-        close(server_fd);
+        if (controller_workers < 1)
+            controller_workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+        controller_pool = workpool_create(controller_workers);
+        if (!controller_pool || !region_planner_init(&region_planner, &survivor_grid, controller_pool, CONTROLLER_REGION_CELLS))
+        {
+            perror("Controller worker pool setup failed");
+            return 1;
+        }
+        printf("Controller: region assignment with %d worker(s)\n", controller_pool->workers);
+    }
+
+    if (io_backend == IO_BACKEND_URING)
+    {
+        // Kernel io_uring desteklemiyorsa (veya seccomp ile kapalıysa) epoll'a geri dön
+        Uring probe;
+        if (!uring_init(&probe, 8))
+        {
+            fprintf(stderr, "io_uring unavailable (%s), falling back to epoll\n", strerror(errno));
+            io_backend = IO_BACKEND_EPOLL;
+        }
+        else
+            uring_destroy(&probe);
+    }
+
+    struct rlimit fd_limit;
+    conn_by_fd_size = getrlimit(RLIMIT_NOFILE, &fd_limit) == 0 && fd_limit.rlim_cur != RLIM_INFINITY
+                          ? (size_t)fd_limit.rlim_cur
+                          : 65536;
+    conn_by_fd = calloc(conn_by_fd_size, sizeof(DroneConn *));
+    if (!conn_by_fd)
+    {
+        perror("calloc for connection table failed");
         return 1;
     }
-    if (listen(server_fd, MAX_DRONES) < 0)
+
+    shards = calloc(shard_count, sizeof(ReactorShard));
+    if (!shards)
     {
-        perror("listen for drones failed");
-        close(server_fd);
+        perror("calloc for reactor shards failed");
         return 1;
     }
-    printf("Drone server listening on port %d\n", PORT);
+    for (int i = 0; i < shard_count; i++)
+    {
+        if (!init_reactor_shard(&shards[i], i))
+            return 1;
+    }
+    printf("Drone server listening on port %d with %d reactor(s) (%s)\n", PORT, shard_count,
+           io_backend == IO_BACKEND_URING ? "io_uring" : "epoll");
+    if (udp_telemetry_enabled)
+        printf("UDP telemetry on ports %d-%d\n", TELEMETRY_PORT, TELEMETRY_PORT + shard_count - 1);
 
     int view_server_fd = socket(AF_INET, SOCK_STREAM, 0);
     // ... (socket, setsockopt, bind, listen for view_server_fd) ...
     if (view_server_fd < 0)
     {
         perror("socket for views failed");
-        close(server_fd);
         return 1;
     }
     struct sockaddr_in view_addr = {0};
+    int opt = 1;
     view_addr.sin_family = AF_INET;
     view_addr.sin_addr.s_addr = INADDR_ANY;
     view_addr.sin_port = htons(VIEW_PORT);
     if (setsockopt(view_server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0)
     {
         perror("setsockopt(SO_REUSEADDR) for views failed");
-        close(server_fd);
         close(view_server_fd);
         return 1;
     }
     if (bind(view_server_fd, (struct sockaddr *)&view_addr, sizeof(view_addr)) < 0)
     {
         perror("bind for views failed");
-        close(server_fd);
         close(view_server_fd);
         return 1;
     }
     if (listen(view_server_fd, MAX_VIEWS) < 0)
     {
         perror("listen for views failed");
-        close(server_fd);
         close(view_server_fd);
         return 1;
     }
     printf("View server listening on port %d\n", VIEW_PORT);
+    create_local_view_transport();
 
     pthread_t survivor_gen_thread, controller_thread, view_bcast_thread;
-    pthread_t drone_accept_tid, view_accept_tid;
-
-    // Thread'lere geçmek için server_fd ve view_server_fd'nin kopyalarını heap'te oluştur
-    int *p_server_fd = malloc(sizeof(int));
-    if (!p_server_fd)
-    {
-        perror("malloc p_server_fd failed"); /* cleanup and exit */
-        return 1;
-    }
-    *p_server_fd = server_fd;
+    pthread_t view_accept_tid;
 
+    // Thread'e geçmek için view_server_fd'nin kopyasını heap'te oluştur
     int *p_view_server_fd = malloc(sizeof(int));
     if (!p_view_server_fd)
     {
         perror("malloc p_view_server_fd failed");
-        free(p_server_fd); /* cleanup */
         return 1;
     }
     *p_view_server_fd = view_server_fd;
@@ -1193,7 +3418,9 @@ int main()
     pthread_create(&survivor_gen_thread, NULL, survivor_generator, NULL);
     pthread_create(&controller_thread, NULL, controller, NULL);
     pthread_create(&view_bcast_thread, NULL, view_broadcast, NULL);
-    pthread_create(&drone_accept_tid, NULL, drone_accept_loop, p_server_fd);
+    for (int i = 0; i < shard_count; i++)
+        pthread_create(&shards[i].tid, NULL,
+                       io_backend == IO_BACKEND_URING ? drone_reactor_loop_uring : drone_reactor_loop, &shards[i]);
     pthread_create(&view_accept_tid, NULL, view_accept_loop, p_view_server_fd);
 
     printf("Server running. Press Ctrl+C to exit.\n");
@@ -1209,18 +3436,17 @@ int main()
 
     // 1. Yeni bağlantıları kabul etmeyi durdur (accept loop'lar server_running'i kontrol ediyor)
     //    ve ana dinleme soketlerini kapatarak accept'lerin sonlanmasını hızlandır.
-    if (server_fd > 0)
-        close(server_fd);
+    //    Drone dinleme soketleri reactor'lar join edildikten sonra kapatılır.
     if (view_server_fd > 0)
         close(view_server_fd);
-    server_fd = -1; // Tekrar kapatılmasını önle
-    view_server_fd = -1;
+    view_server_fd = -1; // Tekrar kapatılmasını önle
 
     // 2. Worker thread'lerin sonlanmasını bekle (join)
     //    Detach edilmemişlerse join edilebilir. Detach edilmişlerse,
     //    server_running flag'ini kontrol ederek kendiliğinden çıkmaları beklenir.
-    //    handle_drone ve handle_view_client thread'leri detach edildiği için,
+    //    handle_view_client thread'leri detach edildiği için,
     //    onların soketlerinin kapatılması (veya timeout) çıkmalarını sağlar.
+    //    Drone bağlantılarını ise drone_reactor_loop çıkarken kendisi kapatır.
 
     printf("Waiting for survivor generator thread to exit...\n");
     pthread_join(survivor_gen_thread, NULL);
@@ -1228,56 +3454,96 @@ int main()
     pthread_join(controller_thread, NULL);
     printf("Waiting for view broadcast thread to exit...\n");
     pthread_join(view_bcast_thread, NULL);
-    printf("Waiting for drone accept loop to exit...\n");
-    pthread_join(drone_accept_tid, NULL);
+    printf("Waiting for drone reactors to exit...\n");
+    for (int i = 0; i < shard_count; i++)
+        pthread_join(shards[i].tid, NULL);
     printf("Waiting for view accept loop to exit...\n");
     pthread_join(view_accept_tid, NULL);
 
-    // drone_accept_loop ve view_accept_loop'a geçilen p_server_fd ve p_view_server_fd'yi free et
-    free(p_server_fd);
+    // view_accept_loop'a geçilen p_view_server_fd'yi free et
     free(p_view_server_fd);
 
-    // handle_drone thread'leri detach edilmişti.
-    // Onların kullandığı drone_obj'ler ve soketler,
-    // drone_list temizlenirken veya handle_drone çıkarken temizlenmeli.
-    // Zaman aşımı veya bağlantı kopması durumunda handle_drone zaten temizlik yapıyor.
-    // Kapanışta, drone_list'teki tüm drone'ların soketleri kapatılabilir
-    // (eğer hala açıksa) ve sonra liste temizlenir.
+    // Reactor çıkarken kendi bağlantılarını temizledi; yine de listede
+    // kalan bir drone varsa soketini kapatıp listeyi temizle.
     printf("Cleaning up remaining drone connections...\n");
-    pthread_mutex_lock(&drone_list->lock);
-    Node *current_d_node = drone_list->head;
-    while (current_d_node)
+    for (int i = 0; i < shard_count; i++)
     {
-        Drone *d = (Drone *)current_d_node->data;
-        pthread_mutex_lock(&d->lock);
-        if (d->sock > 0)
-        {
-            close(d->sock);
-            d->sock = -1;
-        }
-        pthread_mutex_unlock(&d->lock);
-        current_d_node = current_d_node->next;
+        ReactorShard *shard = &shards[i];
+        iterate_hashmap(shard->drones, close_drone_socket, NULL);
+        destroy_hashmap(shard->drones, free_drone); // free_drone, Drone* alır
+        free(shard->fleet);
+        destroy_list(shard->mailbox, free_shard_command);
+        close(shard->listen_fd);
+        close(shard->epoll_fd);
+        close(shard->wake_fd);
+        if (shard->udp_fd >= 0)
+            close(shard->udp_fd);
+        free(shard->sessions);
+        free(shard->free_sessions);
+    }
+    free(shards);
+    free(conn_by_fd);
+    // Tüm okuyucular durdu: bekletilen görüntü ve drone'lar artık serbest bırakılabilir
+    epoch_drain();
+    EpochStats epoch_stats;
+    epoch_get_stats(&epoch_stats);
+    printf("Epoch reclamation: %lu objects retired, %lu reclaimed, %lu epoch advances\n",
+           epoch_stats.retired, epoch_stats.reclaimed, epoch_stats.advances);
+    if (nav_map.blocked_count > 0)
+    {
+        NavStats nav_stats;
+        navmap_get_stats(&nav_map, &nav_stats);
+        printf("Path planner: %lu lookups, %lu from distance fields (%lu cells labelled, peak %.1f KB), "
+               "%lu from cached paths, %lu A* searches (%.1f cells expanded each), %lu unreachable\n",
+               nav_stats.lookups, nav_stats.field_queries, nav_stats.field_expanded,
+               nav_stats.field_peak_bytes / 1024.0, nav_stats.hits, nav_stats.searches,
+               nav_stats.searches ? (double)nav_stats.expanded / nav_stats.searches : 0.0, nav_stats.unreachable);
     }
-    pthread_mutex_unlock(&drone_list->lock);
-    destroy_list(drone_list, free_drone); // free_drone, Drone* alır
 
     printf("Cleaning up remaining view connections...\n");
-    pthread_mutex_lock(&view_sockets->lock);
-    Node *current_v_node = view_sockets->head;
-    while (current_v_node)
+    pthread_mutex_lock(&view_send_lock);
+    iterate_hashmap(view_sockets, close_view_socket, NULL);
+    pthread_mutex_unlock(&view_send_lock);
+    destroy_hashmap(view_sockets, free); // view_sockets int* tutar, bu yüzden free yeterli
+
+    if (view_unix_fd >= 0)
     {
-        int *sock_val_ptr = (int *)current_v_node->data;
-        if (sock_val_ptr && *sock_val_ptr > 0)
-        {
-            close(*sock_val_ptr);
-            *sock_val_ptr = -1;
-        }
-        current_v_node = current_v_node->next;
+        close(view_unix_fd);
+        unlink(VIEW_UNIX_PATH);
     }
-    pthread_mutex_unlock(&view_sockets->lock);
-    destroy_list(view_sockets, free); // view_sockets int* tutar, bu yüzden free yeterli
+    if (snapshot_ro_fd >= 0)
+        close(snapshot_ro_fd);
+    snapshot_destroy(snapshot_region, snapshot_fd);
 
-    destroy_list(survivor_list, free_survivor);
+    if (controller_pool)
+    {
+        region_planner_destroy(&region_planner);
+        workpool_destroy(controller_pool);
+    }
+    // Controller'dan sonra gelen olaylar (kapanışta bırakılan görevler) tabloya işlenir
+    pthread_mutex_lock(&survivor_lock);
+    drain_survivor_events_locked();
+    pthread_mutex_unlock(&survivor_lock);
+    survgrid_destroy(&survivor_grid);
+    size_t pos = 0;
+    void *item;
+    while ((item = idtable_next(&survivor_table, &pos)) != NULL)
+        free_survivor(item);
+    pos = 0;
+    while ((item = idtable_next(&mission_table, &pos)) != NULL)
+        free(item);
+    idtable_destroy(&survivor_table);
+    idtable_destroy(&mission_table);
+    destroy_hashmap(drone_table, NULL); // Drone'lar shard map'leriyle bırakıldı
+    navmap_destroy(&nav_map);
+    slab_thread_flush(); // Diğer thread'ler çıkarken önbelleklerini zaten boşalttı; her şey serbest
+    SlabStats slab_stats[SLAB_MAX_POOLS];
+    int slab_pools = slab_get_stats(slab_stats, SLAB_MAX_POOLS);
+    for (int i = 0; i < slab_pools; i++)
+        printf("Allocator: %s pool, %lu allocs, %lu frees, %lu slabs (%.0f KB, %zu-byte objects), "
+               "%lu refills and %lu flushes under the pool lock\n",
+               slab_stats[i].name, slab_stats[i].allocs, slab_stats[i].frees, slab_stats[i].slabs,
+               slab_stats[i].bytes / 1024.0, slab_stats[i].object_size, slab_stats[i].refills, slab_stats[i].flushes);
 
     printf("Server shut down complete.\n");
     return 0;
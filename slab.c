@@ -0,0 +1,222 @@
+#include "slab.h"
+#include <stdalign.h>
+#include <stdlib.h>
+
+typedef struct
+{
+    void *objects[SLAB_CACHE_OBJS];
+    int count;
+    unsigned long allocs; // Havuz istatistiğine henüz eklenmemiş sayaçlar
+    unsigned long frees;
+} SlabCache;
+
+typedef struct
+{
+    SlabCache caches[SLAB_MAX_POOLS];
+} SlabThread;
+
+static SlabPool *pools[SLAB_MAX_POOLS];
+static int pool_count = 0;
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t thread_key; // Sadece thread çıkışında önbellekleri boşaltmak için
+static pthread_once_t key_once = PTHREAD_ONCE_INIT;
+static _Thread_local SlabThread *current = NULL;
+
+static size_t round_up(size_t size, size_t align)
+{
+    return (size + align - 1) / align * align;
+}
+
+// İlk kullanımda havuzu kaydeder ve önbellek indeksini döndürür. Kayıt dolduysa
+// SLAB_MAX_POOLS döner; o havuz önbelleksiz, her işlemde kilitle çalışır.
+static int pool_index(SlabPool *pool)
+{
+    int index = __atomic_load_n(&pool->index, __ATOMIC_ACQUIRE);
+    if (index >= 0)
+        return index;
+    pthread_mutex_lock(&registry_lock);
+    index = pool->index;
+    if (index < 0)
+    {
+        size_t size = pool->size < sizeof(void *) ? sizeof(void *) : pool->size;
+        pool->size = round_up(size, alignof(max_align_t));
+        pool->stats.name = pool->name;
+        pool->stats.object_size = pool->size;
+        index = pool_count < SLAB_MAX_POOLS ? pool_count : SLAB_MAX_POOLS;
+        if (index < SLAB_MAX_POOLS)
+        {
+            pools[index] = pool;
+            __atomic_store_n(&pool_count, index + 1, __ATOMIC_RELEASE);
+        }
+        __atomic_store_n(&pool->index, index, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&registry_lock);
+    return index;
+}
+
+// Havuz kilidi tutulurken: yeni bir slab'ı nesnelere bölüp ortak listeye ekler.
+static bool grow(SlabPool *pool)
+{
+    size_t header = round_up(sizeof(void *), alignof(max_align_t));
+    size_t bytes = SLAB_BYTES;
+    if (bytes < header + 8 * pool->size)
+        bytes = header + 8 * pool->size;
+    char *slab = malloc(bytes);
+    if (!slab)
+        return false;
+    *(void **)slab = pool->slab_list;
+    pool->slab_list = slab;
+    for (char *object = slab + header; object + pool->size <= slab + bytes; object += pool->size)
+    {
+        *(void **)object = pool->free_list;
+        pool->free_list = object;
+    }
+    pool->stats.slabs++;
+    pool->stats.bytes += bytes;
+    return true;
+}
+
+static void *pop_free_locked(SlabPool *pool)
+{
+    if (!pool->free_list && !grow(pool))
+        return NULL;
+    void *object = pool->free_list;
+    pool->free_list = *(void **)object;
+    return object;
+}
+
+// Önbellekte keep nesne kalana kadar fazlasını ortak listeye verir, sayaçları ekler.
+static void flush_cache(SlabPool *pool, SlabCache *cache, int keep)
+{
+    pthread_mutex_lock(&pool->lock);
+    if (cache->count > keep)
+        pool->stats.flushes++;
+    while (cache->count > keep)
+    {
+        void *object = cache->objects[--cache->count];
+        *(void **)object = pool->free_list;
+        pool->free_list = object;
+    }
+    pool->stats.allocs += cache->allocs;
+    pool->stats.frees += cache->frees;
+    cache->allocs = cache->frees = 0;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Boş önbelleği kapasitesinin yarısına kadar ortak listeden doldurur.
+static bool refill(SlabPool *pool, SlabCache *cache)
+{
+    pthread_mutex_lock(&pool->lock);
+    pool->stats.refills++;
+    pool->stats.allocs += cache->allocs;
+    pool->stats.frees += cache->frees;
+    cache->allocs = cache->frees = 0;
+    while (cache->count < SLAB_CACHE_OBJS / 2)
+    {
+        if (!pool->free_list && cache->count > 0)
+            break; // Yeni slab sadece önbellek hâlâ boşsa
+        void *object = pop_free_locked(pool);
+        if (!object)
+            break;
+        cache->objects[cache->count++] = object;
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return cache->count > 0;
+}
+
+static void flush_thread(SlabThread *thread)
+{
+    int count = __atomic_load_n(&pool_count, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < count; i++)
+        flush_cache(pools[i], &thread->caches[i], 0);
+}
+
+static void thread_exit(void *ptr)
+{
+    flush_thread(ptr);
+    free(ptr);
+    current = NULL;
+}
+
+static void create_key(void)
+{
+    pthread_key_create(&thread_key, thread_exit);
+}
+
+static SlabThread *get_thread(void)
+{
+    if (current)
+        return current;
+    pthread_once(&key_once, create_key);
+    SlabThread *thread = calloc(1, sizeof(SlabThread));
+    if (!thread)
+        return NULL;
+    if (pthread_setspecific(thread_key, thread) != 0)
+    {
+        free(thread);
+        return NULL;
+    }
+    current = thread;
+    return thread;
+}
+
+void *slab_alloc(SlabPool *pool)
+{
+    int index = pool_index(pool);
+    SlabThread *thread = index < SLAB_MAX_POOLS ? get_thread() : NULL;
+    if (!thread)
+    { // Önbellek yok: doğrudan ortak listeden
+        pthread_mutex_lock(&pool->lock);
+        void *object = pop_free_locked(pool);
+        pool->stats.allocs += object != NULL;
+        pthread_mutex_unlock(&pool->lock);
+        return object;
+    }
+    SlabCache *cache = &thread->caches[index];
+    if (cache->count == 0 && !refill(pool, cache))
+        return NULL;
+    cache->allocs++;
+    return cache->objects[--cache->count];
+}
+
+void slab_free(SlabPool *pool, void *object)
+{
+    if (!object)
+        return;
+    int index = pool_index(pool);
+    SlabThread *thread = index < SLAB_MAX_POOLS ? get_thread() : NULL;
+    if (!thread)
+    {
+        pthread_mutex_lock(&pool->lock);
+        *(void **)object = pool->free_list;
+        pool->free_list = object;
+        pool->stats.frees++;
+        pthread_mutex_unlock(&pool->lock);
+        return;
+    }
+    SlabCache *cache = &thread->caches[index];
+    if (cache->count == SLAB_CACHE_OBJS)
+        flush_cache(pool, cache, SLAB_CACHE_OBJS / 2);
+    cache->objects[cache->count++] = object;
+    cache->frees++;
+}
+
+void slab_thread_flush(void)
+{
+    if (current)
+        flush_thread(current);
+}
+
+int slab_get_stats(SlabStats *out, int max)
+{
+    int count = __atomic_load_n(&pool_count, __ATOMIC_ACQUIRE);
+    if (count > max)
+        count = max;
+    for (int i = 0; i < count; i++)
+    {
+        pthread_mutex_lock(&pools[i]->lock);
+        out[i] = pools[i]->stats;
+        pthread_mutex_unlock(&pools[i]->lock);
+    }
+    return count;
+}
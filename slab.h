@@ -0,0 +1,56 @@
+#ifndef SLAB_H
+#define SLAB_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Tek tip nesneler için slab havuzu. Nesneler büyük bloklardan (slab) kesilir ve
+// serbest bırakılınca işletim sistemine değil havuza döner; sık oluşturulup silinen
+// Node, Drone ve Survivor için malloc sıcak yoldan ve yığın parçalanmasından çıkar.
+//
+// Her thread'in havuz başına küçük bir önbelleği vardır: ayırma ve bırakma çoğunlukla
+// kilitsiz bu önbellekten yapılır. Önbellek boşalınca veya dolunca yarısı ortak
+// serbest listeyle tek kilitle değiş tokuş edilir; thread çıkarken önbelleği havuza
+// döner. Bir thread'in ayırdığını başka thread bırakabilir. Slab'lar süreç boyunca
+// tutulur (havuzlar statiktir), bellek sadece havuz içinde yeniden kullanılır.
+#define SLAB_BYTES (64 * 1024) // Bir slab'ın hedef boyutu (en az 8 nesne)
+#define SLAB_CACHE_OBJS 64     // Thread önbelleğinin kapasitesi
+#define SLAB_MAX_POOLS 8
+
+typedef struct
+{
+    const char *name;
+    size_t object_size;
+    unsigned long allocs;
+    unsigned long frees;
+    unsigned long refills; // Ortak listeden önbelleğe aktarım (kilit alınan ayırma)
+    unsigned long flushes; // Önbellekten ortak listeye aktarım (kilit alınan bırakma)
+    unsigned long slabs;
+    size_t bytes;          // Slab'lara ayrılan toplam bellek
+} SlabStats;
+
+typedef struct
+{
+    const char *name;
+    size_t size;           // Hizalamaya yuvarlanmış nesne boyutu
+    pthread_mutex_t lock;
+    void *free_list;       // Ortak serbest liste (nesnenin ilk kelimesi sonraki)
+    void *slab_list;       // Ayrılan slab'lar
+    int index;             // Thread önbelleklerindeki yeri; -1: henüz kaydedilmedi
+    SlabStats stats;       // lock ile korunur; thread sayaçları aktarımda eklenir
+} SlabPool;
+
+#define SLAB_POOL_INIT(pool_name, type) \
+    {.name = (pool_name), .size = sizeof(type), .lock = PTHREAD_MUTEX_INITIALIZER, .index = -1}
+
+// Bellek yoksa NULL.
+void *slab_alloc(SlabPool *pool);
+void slab_free(SlabPool *pool, void *object);
+// Çağıran thread'in önbelleklerini havuzlarına boşaltır (ör. istatistik okumadan önce).
+void slab_thread_flush(void);
+// Kayıtlı havuzların istatistiklerini out'a yazar; havuz sayısını döndürür. Diğer
+// thread'lerin önbelleklerindeki son işlemler, önbellek aktarılana kadar görünmez.
+int slab_get_stats(SlabStats *out, int max);
+
+#endif
@@ -0,0 +1,103 @@
+#define _GNU_SOURCE // memfd_create
+#include "snapshot.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+SnapshotRegion *snapshot_create(int *fd)
+{
+    *fd = memfd_create("drone_snapshot", MFD_CLOEXEC);
+    if (*fd < 0)
+        return NULL;
+    if (ftruncate(*fd, sizeof(SnapshotRegion)) < 0)
+    {
+        close(*fd);
+        return NULL;
+    }
+    SnapshotRegion *region = mmap(NULL, sizeof(SnapshotRegion), PROT_READ | PROT_WRITE, MAP_SHARED, *fd, 0);
+    if (region == MAP_FAILED)
+    {
+        close(*fd);
+        return NULL;
+    }
+    // ftruncate sıfırlanmış sayfa verir; sadece başlık doldurulur
+    region->magic = SNAPSHOT_MAGIC;
+    region->version = SNAPSHOT_VERSION;
+    region->size = sizeof(SnapshotRegion);
+    return region;
+}
+
+void snapshot_destroy(SnapshotRegion *region, int fd)
+{
+    if (region)
+        munmap(region, sizeof(SnapshotRegion));
+    if (fd >= 0)
+        close(fd);
+}
+
+// memfd'yi /proc üzerinden O_RDONLY açmak, alıcının PROT_WRITE ile eşlemesini engeller.
+int snapshot_open_readonly(int fd)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+    return open(path, O_RDONLY | O_CLOEXEC);
+}
+
+SnapshotFrame *snapshot_begin_write(SnapshotRegion *region)
+{
+    uint32_t published = __atomic_load_n(&region->published, __ATOMIC_RELAXED);
+    SnapshotFrame *frame = &region->frames[published ^ 1];
+    __atomic_store_n(&frame->seq, frame->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE); // Tek sayaç verilerden önce görünsün
+    return frame;
+}
+
+void snapshot_publish(SnapshotRegion *region, SnapshotFrame *frame)
+{
+    __atomic_store_n(&frame->seq, frame->seq + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&region->published, (uint32_t)(frame - region->frames), __ATOMIC_RELEASE);
+    __atomic_store_n(&region->generation, region->generation + 1, __ATOMIC_RELEASE);
+}
+
+const SnapshotRegion *snapshot_map_readonly(int fd)
+{
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(SnapshotRegion))
+        return NULL;
+    const SnapshotRegion *region = mmap(NULL, sizeof(SnapshotRegion), PROT_READ, MAP_SHARED, fd, 0);
+    if (region == MAP_FAILED)
+        return NULL;
+    if (region->magic != SNAPSHOT_MAGIC || region->version != SNAPSHOT_VERSION || region->size != sizeof(SnapshotRegion))
+    {
+        munmap((void *)region, sizeof(SnapshotRegion));
+        return NULL;
+    }
+    return region;
+}
+
+void snapshot_unmap(const SnapshotRegion *region)
+{
+    if (region)
+        munmap((void *)region, sizeof(SnapshotRegion));
+}
+
+const SnapshotFrame *snapshot_read_begin(const SnapshotRegion *region, uint64_t *seq)
+{
+    const SnapshotFrame *frame = &region->frames[__atomic_load_n(&region->published, __ATOMIC_ACQUIRE) & 1];
+    *seq = __atomic_load_n(&frame->seq, __ATOMIC_ACQUIRE);
+    return frame;
+}
+
+bool snapshot_read_valid(const SnapshotFrame *frame, uint64_t seq)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE); // Veri okumaları sayaçtan önce tamamlansın
+    return (seq & 1) == 0 && seq != 0 && __atomic_load_n(&frame->seq, __ATOMIC_RELAXED) == seq;
+}
+
+uint64_t snapshot_generation(const SnapshotRegion *region)
+{
+    return __atomic_load_n(&region->generation, __ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,81 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Aynı makinedeki view'lar için paylaşımlı bellek durum görüntüsü. Sunucu iki
+// çerçeveden boşta olana yazar ve yayınlar; view bölgeyi salt okunur eşler ve
+// yayınlanan çerçeveyi yerinde okur (JSON yok, kopya yok). Her çerçevenin kendi
+// sıra sayacı vardır: yazım sırasında tek, bitince çift. Okuyucu okumadan önce
+// ve sonra sayacı karşılaştırarak yırtık okumayı fark eder.
+#define SNAPSHOT_MAGIC 0x534E4150u // "SNAP"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_MAX_DRONES 4096
+#define SNAPSHOT_MAX_SURVIVORS 16384
+
+typedef struct
+{
+    int32_t id;
+    int32_t x;
+    int32_t y;
+    int32_t target_x;
+    int32_t target_y;
+    int32_t battery;
+    uint8_t status; // DroneStatus
+    uint8_t pad[3];
+} SnapshotDrone;
+
+typedef struct
+{
+    int32_t id;
+    int32_t x;
+    int32_t y;
+    int32_t priority;
+    uint8_t is_targeted;
+    uint8_t pad[3];
+} SnapshotSurvivor;
+
+typedef struct
+{
+    uint64_t seq; // Tek: yazılıyor
+    int64_t timestamp;
+    uint32_t drone_count;
+    uint32_t survivor_count;
+    uint32_t drones_dropped; // Kapasite aşıldığı için yazılamayanlar
+    uint32_t survivors_dropped;
+    SnapshotDrone drones[SNAPSHOT_MAX_DRONES];
+    SnapshotSurvivor survivors[SNAPSHOT_MAX_SURVIVORS];
+} SnapshotFrame;
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;      // sizeof(SnapshotRegion); okuyucu düzeni doğrular
+    uint32_t published; // Son yayınlanan çerçevenin indeksi (0/1)
+    uint64_t generation; // Her yayında artar; view yeni veri olup olmadığını buradan anlar
+    SnapshotFrame frames[2];
+} SnapshotRegion;
+
+// Yazıcı (sunucu): memfd üzerinde bölge oluşturur; *fd, view'lara salt okunur
+// kopyası verilecek tanıtıcıdır.
+SnapshotRegion *snapshot_create(int *fd);
+void snapshot_destroy(SnapshotRegion *region, int fd);
+// fd'nin salt okunur yeni bir kopyasını açar (SCM_RIGHTS ile gönderilmek üzere).
+int snapshot_open_readonly(int fd);
+// Boştaki çerçeveyi yazıma açar; doldurulduktan sonra snapshot_publish çağrılır.
+SnapshotFrame *snapshot_begin_write(SnapshotRegion *region);
+void snapshot_publish(SnapshotRegion *region, SnapshotFrame *frame);
+
+// Okuyucu (view): salt okunur eşler; düzen uyuşmazsa NULL.
+const SnapshotRegion *snapshot_map_readonly(int fd);
+void snapshot_unmap(const SnapshotRegion *region);
+// Yayınlanan çerçeveyi ve okuma başındaki sayacını döndürür; çerçeve yerinde okunur.
+const SnapshotFrame *snapshot_read_begin(const SnapshotRegion *region, uint64_t *seq);
+// Okuma süresince çerçeve yeniden yazılmadıysa true.
+bool snapshot_read_valid(const SnapshotFrame *frame, uint64_t seq);
+uint64_t snapshot_generation(const SnapshotRegion *region);
+
+#endif
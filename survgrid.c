@@ -0,0 +1,270 @@
+#include "survgrid.h"
+#include <limits.h>
+#include <stdlib.h>
+
+static int clamp_index(int v, int n)
+{
+    if (v < 0)
+        return 0;
+    if (v >= n)
+        return n - 1;
+    return v;
+}
+
+static int cell_of(const SurvivorGrid *grid, Coordinate c)
+{
+    int cx = clamp_index(c.x / grid->cell_size, grid->cols);
+    int cy = clamp_index(c.y / grid->cell_size, grid->rows);
+    return cy * grid->cols + cx;
+}
+
+bool survgrid_init(SurvivorGrid *grid, int width, int height, int cell_size)
+{
+    grid->cell_size = cell_size > 0 ? cell_size : 1;
+    grid->cols = (width + grid->cell_size - 1) / grid->cell_size;
+    grid->rows = (height + grid->cell_size - 1) / grid->cell_size;
+    if (grid->cols < 1)
+        grid->cols = 1;
+    if (grid->rows < 1)
+        grid->rows = 1;
+    grid->cells = calloc((size_t)grid->cols * grid->rows, sizeof(SurvivorCell));
+    if (grid->cells && !survtab_init(&grid->table, 64))
+    {
+        free(grid->cells);
+        grid->cells = NULL;
+    }
+    grid->count = 0;
+    grid->max_priority = 0;
+    grid->oldest = 0;
+    grid->dist_fn = NULL;
+    grid->dist_ctx = NULL;
+    return grid->cells != NULL;
+}
+
+void survgrid_set_distance(SurvivorGrid *grid, GridDistFn fn, void *ctx)
+{
+    grid->dist_fn = fn;
+    grid->dist_ctx = ctx;
+}
+
+void survgrid_destroy(SurvivorGrid *grid)
+{
+    if (!grid->cells)
+        return;
+    for (int i = 0; i < grid->cols * grid->rows; i++)
+        free(grid->cells[i].items);
+    free(grid->cells);
+    survtab_destroy(&grid->table);
+    grid->cells = NULL;
+    grid->count = 0;
+}
+
+static void widen_bounds(int *max_priority, time_t *oldest, bool was_empty, const Survivor *s)
+{
+    if (was_empty || s->priority > *max_priority)
+        *max_priority = s->priority;
+    if (was_empty || s->creation_time < *oldest)
+        *oldest = s->creation_time;
+}
+
+bool survgrid_insert(SurvivorGrid *grid, Survivor *s)
+{
+    if (s->grid_cell >= 0)
+        return true;
+    SurvivorCell *cell = &grid->cells[cell_of(grid, s->coord)];
+    if (cell->count == cell->cap)
+    {
+        int cap = cell->cap ? cell->cap * 2 : 4;
+        Survivor **items = realloc(cell->items, (size_t)cap * sizeof(Survivor *));
+        if (!items)
+            return false;
+        cell->items = items;
+        cell->cap = cap;
+    }
+    if (!survtab_insert(&grid->table, s))
+        return false;
+    widen_bounds(&cell->max_priority, &cell->oldest, cell->count == 0, s);
+    widen_bounds(&grid->max_priority, &grid->oldest, grid->count == 0, s);
+    s->grid_cell = (int)(cell - grid->cells);
+    s->grid_slot = cell->count;
+    cell->items[cell->count++] = s;
+    grid->count++;
+    return true;
+}
+
+// Son elemanı boşluğa taşıyarak O(1) siler.
+void survgrid_remove(SurvivorGrid *grid, Survivor *s)
+{
+    if (s->grid_cell < 0)
+        return;
+    SurvivorCell *cell = &grid->cells[s->grid_cell];
+    Survivor *last = cell->items[--cell->count];
+    cell->items[s->grid_slot] = last;
+    last->grid_slot = s->grid_slot;
+    survtab_remove(&grid->table, s);
+    s->grid_cell = -1;
+    s->grid_slot = -1;
+    grid->count--;
+}
+
+void survgrid_refresh_bounds(SurvivorGrid *grid)
+{
+    bool grid_empty = true;
+    for (int i = 0; i < grid->cols * grid->rows; i++)
+    {
+        SurvivorCell *cell = &grid->cells[i];
+        for (int j = 0; j < cell->count; j++)
+        {
+            widen_bounds(&cell->max_priority, &cell->oldest, j == 0, cell->items[j]);
+            widen_bounds(&grid->max_priority, &grid->oldest, grid_empty, cell->items[j]);
+            grid_empty = false;
+        }
+    }
+}
+
+int survgrid_collect(const SurvivorGrid *grid, Survivor **out)
+{
+    int n = 0;
+    for (int i = 0; i < grid->cols * grid->rows; i++)
+    {
+        const SurvivorCell *cell = &grid->cells[i];
+        for (int j = 0; j < cell->count; j++)
+            out[n++] = cell->items[j];
+    }
+    return n;
+}
+
+// pos'tan hücre dikdörtgenine en kısa Manhattan mesafesi. Kenar hücreler
+// haritanın dışına taşan koordinatları da tuttuğu için dışa doğru sınırsızdır.
+static int cell_min_dist(const SurvivorGrid *grid, int cx, int cy, Coordinate pos)
+{
+    int lo_x = cx == 0 ? INT_MIN : cx * grid->cell_size;
+    int hi_x = cx == grid->cols - 1 ? INT_MAX : (cx + 1) * grid->cell_size - 1;
+    int lo_y = cy == 0 ? INT_MIN : cy * grid->cell_size;
+    int hi_y = cy == grid->rows - 1 ? INT_MAX : (cy + 1) * grid->cell_size - 1;
+    int dx = pos.x < lo_x ? lo_x - pos.x : (pos.x > hi_x ? pos.x - hi_x : 0);
+    int dy = pos.y < lo_y ? lo_y - pos.y : (pos.y > hi_y ? pos.y - hi_y : 0);
+    return dx + dy;
+}
+
+static void scan_cell(const SurvivorGrid *grid, int cx, int cy, Coordinate pos, time_t now,
+                      Survivor **best, double *best_score)
+{
+    const SurvivorCell *cell = &grid->cells[cy * grid->cols + cx];
+    if (cell->count == 0)
+        return;
+    // Hücredeki hiçbir survivor mevcut en iyiyi geçemiyorsa atla
+    double bound = SURVGRID_SCORE(cell->max_priority, now - cell->oldest, cell_min_dist(grid, cx, cy, pos));
+    if (*best && bound <= *best_score)
+        return;
+    for (int i = 0; i < cell->count; i++)
+    {
+        Survivor *s = cell->items[i];
+        if (s->is_targeted)
+            continue; // Paralel geçişte bölge işçisinin ayırdığı survivor
+        int dist = abs(pos.x - s->coord.x) + abs(pos.y - s->coord.y);
+        double score = SURVGRID_SCORE(s->priority, now - s->creation_time, dist);
+        if (grid->dist_fn && (*best == NULL || score > *best_score))
+        { // Yol maliyeti Manhattan'dan küçük olamaz: sadece geçebilecek adaylar için sorulur
+            dist = grid->dist_fn(pos, s->coord, grid->dist_ctx);
+            if (dist < 0)
+                continue;
+            score = SURVGRID_SCORE(s->priority, now - s->creation_time, dist);
+        }
+        if (*best == NULL || score > *best_score)
+        {
+            *best_score = score;
+            *best = s;
+        }
+    }
+}
+
+void survgrid_cell_coords(const SurvivorGrid *grid, Coordinate pos, int *cx, int *cy)
+{
+    int cell = cell_of(grid, pos);
+    *cx = cell % grid->cols;
+    *cy = cell / grid->cols;
+}
+
+int survgrid_near(const SurvivorGrid *grid, Coordinate pos, int radius, Survivor **out, int max)
+{
+    if (grid->count == 0 || max <= 0)
+        return 0;
+    int x0, y0, x1, y1;
+    survgrid_cell_coords(grid, (Coordinate){pos.x - radius, pos.y - radius}, &x0, &y0);
+    survgrid_cell_coords(grid, (Coordinate){pos.x + radius, pos.y + radius}, &x1, &y1);
+    int n = 0;
+    for (int cy = y0; cy <= y1; cy++)
+        for (int cx = x0; cx <= x1; cx++)
+        {
+            const SurvivorCell *cell = &grid->cells[cy * grid->cols + cx];
+            for (int i = 0; i < cell->count; i++)
+            {
+                Survivor *s = cell->items[i];
+                int dist = abs(pos.x - s->coord.x) + abs(pos.y - s->coord.y);
+                if (s->is_targeted || dist > radius)
+                    continue;
+                // Mesafeye göre sıralı ekleme; max küçük (rota durağı sayısı)
+                int j = n < max ? n++ : max;
+                while (j > 0 && abs(pos.x - out[j - 1]->coord.x) + abs(pos.y - out[j - 1]->coord.y) > dist)
+                {
+                    if (j < max)
+                        out[j] = out[j - 1];
+                    j--;
+                }
+                if (j < max)
+                    out[j] = s;
+            }
+        }
+    return n;
+}
+
+Survivor *survgrid_best(const SurvivorGrid *grid, Coordinate pos, time_t now, double *score)
+{
+    GridRect all = {0, 0, grid->cols - 1, grid->rows - 1};
+    return survgrid_best_in(grid, &all, pos, now, score);
+}
+
+Survivor *survgrid_best_in(const SurvivorGrid *grid, const GridRect *rect, Coordinate pos, time_t now, double *score)
+{
+    Survivor *best = NULL;
+    double best_score = 0.0;
+    if (grid->count == 0)
+        return NULL;
+
+    int hx, hy;
+    survgrid_cell_coords(grid, pos, &hx, &hy);
+    hx = hx < rect->x0 ? rect->x0 : (hx > rect->x1 ? rect->x1 : hx);
+    hy = hy < rect->y0 ? rect->y0 : (hy > rect->y1 ? rect->y1 : hy);
+    int max_ring = 0;
+    int reach[4] = {hx - rect->x0, rect->x1 - hx, hy - rect->y0, rect->y1 - hy};
+    for (int k = 0; k < 4; k++)
+        if (reach[k] > max_ring)
+            max_ring = reach[k];
+    for (int r = 0; r <= max_ring; r++)
+    {
+        // r. halkadaki her hücre, merkez hücreden bir eksende r hücre uzaktadır;
+        // bu yüzden mesafe en az (r-1)*cell_size olur.
+        if (best && r > 0)
+        {
+            double ring_bound = SURVGRID_SCORE(grid->max_priority, now - grid->oldest, (r - 1) * grid->cell_size);
+            if (ring_bound <= best_score)
+                break;
+        }
+        for (int cy = hy - r; cy <= hy + r; cy++)
+        {
+            if (cy < rect->y0 || cy > rect->y1)
+                continue;
+            bool edge_row = cy == hy - r || cy == hy + r;
+            for (int cx = hx - r; cx <= hx + r; cx += (edge_row || r == 0) ? 1 : 2 * r)
+            {
+                if (cx < rect->x0 || cx > rect->x1)
+                    continue;
+                scan_cell(grid, cx, cy, pos, now, &best, &best_score);
+            }
+        }
+    }
+    if (best && score)
+        *score = best_score;
+    return best;
+}
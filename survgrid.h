@@ -0,0 +1,80 @@
+#ifndef SURVGRID_H
+#define SURVGRID_H
+
+#include "survivor.h"
+#include "survtab.h"
+#include <stdbool.h>
+#include <time.h>
+
+// Atanmamış survivor'lar için düzgün ızgara indeksi. Harita cell_size kenarlı
+// hücrelere bölünür; her hücre kendi survivor dizisini ve skor üst sınırı için
+// en yüksek önceliği ve en eski oluşturulma zamanını tutar. Sınırlar silmede
+// güncellenmez (sadece büyür), survgrid_refresh_bounds ile daraltılır; bu yüzden
+// her zaman gerçek değerin üstündedir ve budama güvenlidir.
+// Izgara kendi kilidini tutmaz; survivor_lock altında kullanılır.
+typedef struct
+{
+    Survivor **items;
+    int count;
+    int cap;
+    int max_priority;
+    time_t oldest;
+} SurvivorCell;
+
+// Gerçek yol maliyeti (ör. engelli haritada A*); ulaşılamıyorsa -1. Manhattan
+// mesafesinden küçük olmamalıdır: budama sınırları Manhattan ile hesaplanır.
+typedef int (*GridDistFn)(Coordinate from, Coordinate to, void *ctx);
+
+typedef struct
+{
+    SurvivorCell *cells;
+    int cols; // x ekseni
+    int rows; // y ekseni
+    int cell_size;
+    int count;
+    int max_priority;
+    time_t oldest;
+    GridDistFn dist_fn; // NULL: Manhattan
+    void *dist_ctx;
+    // Aynı survivor'ların sütun kopyası; ekleme/silmeyle birlikte güncellenir.
+    // Toplu skorlama (tüm drone'lar x tüm survivor'lar) hücreleri gezmek yerine
+    // bunu SIMD ile tarar. Bölge işçilerinin geçici is_targeted ayırmaları
+    // tabloya yansımaz; ızgaradaki her survivor atanmamış sayılır.
+    SurvivorTable table;
+} SurvivorGrid;
+
+// Hücre indeksleriyle kapalı dikdörtgen [x0, x1] x [y0, y1].
+typedef struct
+{
+    int x0, y0;
+    int x1, y1;
+} GridRect;
+
+// Skor: priority*100 + yaş - mesafe*2. Mesafe dist_fn ile (yoksa Manhattan)
+// ölçülür; controller ile aynı formül.
+#define SURVGRID_SCORE(priority, age, dist) ((priority) * 100.0 + (age) * 1.0 - (dist) * 2.0)
+
+bool survgrid_init(SurvivorGrid *grid, int width, int height, int cell_size);
+void survgrid_destroy(SurvivorGrid *grid);
+// survgrid_best/_in skorlamasında kullanılacak mesafe; fn NULL ise Manhattan.
+void survgrid_set_distance(SurvivorGrid *grid, GridDistFn fn, void *ctx);
+bool survgrid_insert(SurvivorGrid *grid, Survivor *s);
+void survgrid_remove(SurvivorGrid *grid, Survivor *s);
+// Hücre ve ızgara sınırlarını mevcut survivor'lardan yeniden hesaplar.
+void survgrid_refresh_bounds(SurvivorGrid *grid);
+// İndeksteki tüm survivor'ları out'a yazar (out en az grid->count eleman tutmalı).
+int survgrid_collect(const SurvivorGrid *grid, Survivor **out);
+// pos için en yüksek skorlu survivor'ı döndürür (yoksa NULL); *score doldurulur.
+// Halkalar merkez hücreden dışa taranır, sınır en iyiyi geçemediğinde durulur.
+Survivor *survgrid_best(const SurvivorGrid *grid, Coordinate pos, time_t now, double *score);
+// survgrid_best'in rect hücreleriyle sınırlı hali; pos'un hücresi rect içinde
+// olmalıdır. is_targeted survivor'lar atlanır, böylece farklı bölgelerin
+// işçileri ızgarayı değiştirmeden aynı anda sorgulayıp survivor ayırabilir.
+Survivor *survgrid_best_in(const SurvivorGrid *grid, const GridRect *rect, Coordinate pos, time_t now, double *score);
+// pos'a Manhattan mesafesi en fazla radius olan, hedeflenmemiş survivor'lardan en
+// yakın max tanesini yakından uzağa out'a yazar; yazılan sayıyı döndürür.
+int survgrid_near(const SurvivorGrid *grid, Coordinate pos, int radius, Survivor **out, int max);
+// pos'un (ızgaraya sıkıştırılmış) hücre indeksleri.
+void survgrid_cell_coords(const SurvivorGrid *grid, Coordinate pos, int *cx, int *cy);
+
+#endif
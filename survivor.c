@@ -1,11 +1,14 @@
 // survivor.c
 #include "survivor.h"
+#include "slab.h"
 #include <stdlib.h>
 #include <time.h> // YENİ: time() için
 
+static SlabPool survivor_pool = SLAB_POOL_INIT("survivor", Survivor);
+
 Survivor *create_survivor(int id, int x, int y, int priority)
 {
-    Survivor *survivor = malloc(sizeof(Survivor));
+    Survivor *survivor = slab_alloc(&survivor_pool);
     if (!survivor)
         return NULL;
     survivor->id = id;
@@ -14,10 +17,13 @@ Survivor *create_survivor(int id, int x, int y, int priority)
     survivor->priority = priority;
     survivor->is_targeted = false;
     survivor->creation_time = time(NULL); // YENİ: Oluşturulma zamanını kaydet
+    survivor->grid_cell = -1;
+    survivor->grid_slot = -1;
+    survivor->table_slot = -1;
     return survivor;
 }
 
 void free_survivor(void *survivor)
 {
-    free(survivor);
+    slab_free(&survivor_pool, survivor);
 }
\ No newline at end of file
@@ -13,6 +13,9 @@ typedef struct
     int priority;
     bool is_targeted;
     time_t creation_time; // YENİ: Survivor'ın oluşturulma zamanı
+    int grid_cell;        // Uzamsal indeksteki hücre (-1: indekste değil / hedeflenmiş)
+    int grid_slot;        // Hücre dizisindeki konum (O(1) silme için)
+    int table_slot;       // Skor tablosundaki (survtab) sütun indeksi, -1: tabloda değil
 } Survivor;
 
 Survivor *create_survivor(int id, int x, int y, int priority);
@@ -0,0 +1,395 @@
+#include "survtab.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SURVTAB_X86 1
+#endif
+
+static int selected = -1; // SurvtabKernel; -1: henüz seçilmedi
+
+static bool kernel_supported(SurvtabKernel kernel)
+{
+#ifdef SURVTAB_X86
+    __builtin_cpu_init();
+    if (kernel == SURVTAB_AVX2)
+        return __builtin_cpu_supports("avx2");
+    if (kernel == SURVTAB_SSE4)
+        return __builtin_cpu_supports("sse4.1");
+#endif
+    return kernel == SURVTAB_SCALAR;
+}
+
+SurvtabKernel survtab_best_kernel(void)
+{
+    if (kernel_supported(SURVTAB_AVX2))
+        return SURVTAB_AVX2;
+    if (kernel_supported(SURVTAB_SSE4))
+        return SURVTAB_SSE4;
+    return SURVTAB_SCALAR;
+}
+
+SurvtabKernel survtab_use_kernel(SurvtabKernel kernel)
+{
+    while (kernel != SURVTAB_SCALAR && !kernel_supported(kernel))
+        kernel = kernel == SURVTAB_AVX2 ? SURVTAB_SSE4 : SURVTAB_SCALAR;
+    __atomic_store_n(&selected, (int)kernel, __ATOMIC_RELAXED);
+    return kernel;
+}
+
+static SurvtabKernel current_kernel(void)
+{
+    int kernel = __atomic_load_n(&selected, __ATOMIC_RELAXED);
+    if (kernel < 0)
+        return survtab_use_kernel(survtab_best_kernel());
+    return (SurvtabKernel)kernel;
+}
+
+const char *survtab_kernel_name(SurvtabKernel kernel)
+{
+    switch (kernel)
+    {
+    case SURVTAB_AVX2:
+        return "avx2";
+    case SURVTAB_SSE4:
+        return "sse4.1";
+    default:
+        return "scalar";
+    }
+}
+
+static bool is_excluded(const SurvivorTable *table, int slot)
+{
+    return (table->targeted[slot >> 6] >> (slot & 63)) & 1;
+}
+
+static void set_excluded(SurvivorTable *table, int slot, bool excluded)
+{
+    uint64_t bit = (uint64_t)1 << (slot & 63);
+    if (excluded)
+        table->targeted[slot >> 6] |= bit;
+    else
+        table->targeted[slot >> 6] &= ~bit;
+}
+
+// Kapasiteyi büyütür; yeni slotlar boş (bitmap'te dışlanmış) başlar.
+static bool grow(SurvivorTable *table, int cap)
+{
+    cap = (cap + 63) & ~63;
+    int32_t *x = realloc(table->x, cap * sizeof(int32_t));
+    if (x)
+        table->x = x;
+    int32_t *y = realloc(table->y, cap * sizeof(int32_t));
+    if (y)
+        table->y = y;
+    int32_t *priority = realloc(table->priority, cap * sizeof(int32_t));
+    if (priority)
+        table->priority = priority;
+    int32_t *created = realloc(table->created, cap * sizeof(int32_t));
+    if (created)
+        table->created = created;
+    uint64_t *targeted = realloc(table->targeted, cap / 64 * sizeof(uint64_t));
+    if (targeted)
+        table->targeted = targeted;
+    Survivor **owner = realloc(table->owner, cap * sizeof(Survivor *));
+    if (owner)
+        table->owner = owner;
+    int *free_slots = realloc(table->free_slots, cap * sizeof(int));
+    if (free_slots)
+        table->free_slots = free_slots;
+    if (!x || !y || !priority || !created || !targeted || !owner || !free_slots)
+        return false; // Büyüyen diziler geçerli kalır, kapasite değişmez
+    memset(table->targeted + table->cap / 64, 0xFF, (cap - table->cap) / 64 * sizeof(uint64_t));
+    memset(table->owner + table->cap, 0, (cap - table->cap) * sizeof(Survivor *));
+    table->cap = cap;
+    return true;
+}
+
+bool survtab_init(SurvivorTable *table, int initial_cap)
+{
+    memset(table, 0, sizeof(*table));
+    table->base = time(NULL);
+    if (initial_cap < 64)
+        initial_cap = 64;
+    if (!grow(table, initial_cap))
+    {
+        survtab_destroy(table);
+        return false;
+    }
+    return true;
+}
+
+void survtab_destroy(SurvivorTable *table)
+{
+    free(table->x);
+    free(table->y);
+    free(table->priority);
+    free(table->created);
+    free(table->targeted);
+    free(table->owner);
+    free(table->free_slots);
+    memset(table, 0, sizeof(*table));
+}
+
+bool survtab_insert(SurvivorTable *table, Survivor *s)
+{
+    int slot;
+    if (table->free_count > 0)
+        slot = table->free_slots[--table->free_count];
+    else
+    {
+        if (table->high == table->cap && !grow(table, table->cap * 2))
+            return false;
+        slot = table->high++;
+    }
+    table->x[slot] = s->coord.x;
+    table->y[slot] = s->coord.y;
+    table->priority[slot] = s->priority;
+    table->created[slot] = (int32_t)difftime(s->creation_time, table->base);
+    table->owner[slot] = s;
+    set_excluded(table, slot, s->is_targeted);
+    s->table_slot = slot;
+    table->count++;
+    return true;
+}
+
+void survtab_remove(SurvivorTable *table, Survivor *s)
+{
+    int slot = s->table_slot;
+    if (slot < 0 || slot >= table->high || table->owner[slot] != s)
+        return;
+    table->owner[slot] = NULL;
+    set_excluded(table, slot, true);
+    s->table_slot = -1;
+    table->count--;
+    if (slot == table->high - 1)
+    { // Sondaki boş slotları geri al ki taramalar kısalsın
+        table->high--;
+        while (table->high > 0 && !table->owner[table->high - 1])
+            table->high--;
+        int kept = 0; // high'ın ötesinde kalan boş slotlar listeden çıkar
+        for (int i = 0; i < table->free_count; i++)
+            if (table->free_slots[i] < table->high)
+                table->free_slots[kept++] = table->free_slots[i];
+        table->free_count = kept;
+    }
+    else
+        table->free_slots[table->free_count++] = slot;
+}
+
+int survtab_slots(const SurvivorTable *table, int *slots)
+{
+    int n = 0;
+    for (int i = 0; i < table->high; i++)
+        if (table->owner[i])
+            slots[n++] = i;
+    return n;
+}
+
+// Skor: priority*100 + (age0 - created) - 2*(|x-px| + |y-py|), age0 = now - base.
+static inline int32_t score_one(const SurvivorTable *table, int i, int32_t px, int32_t py, int32_t age0)
+{
+    return table->priority[i] * 100 + (age0 - table->created[i]) -
+           2 * (abs(table->x[i] - px) + abs(table->y[i] - py));
+}
+
+static void score_scalar(const SurvivorTable *table, int from, int32_t px, int32_t py, int32_t age0,
+                         int32_t *out)
+{
+    for (int i = from; i < table->high; i++)
+        out[i] = is_excluded(table, i) ? INT32_MIN : score_one(table, i, px, py, age0);
+}
+
+static int best_scalar(const SurvivorTable *table, int from, int32_t px, int32_t py, int32_t age0,
+                       int32_t *score)
+{
+    int best = -1;
+    int32_t best_score = INT32_MIN;
+    for (int i = from; i < table->high; i++)
+    {
+        if (is_excluded(table, i))
+            continue;
+        int32_t s = score_one(table, i, px, py, age0);
+        if (best < 0 || s > best_score)
+        {
+            best = i;
+            best_score = s;
+        }
+    }
+    *score = best_score;
+    return best;
+}
+
+#ifdef SURVTAB_X86
+// 8 slotluk bloğun dışlanma bitleri (blok 8'e hizalı, 64 bitlik kelimeyi aşmaz).
+static inline unsigned block_bits(const SurvivorTable *table, int i)
+{
+    return (unsigned)(table->targeted[i >> 6] >> (i & 63)) & 0xFF;
+}
+
+__attribute__((target("avx2"))) static inline __m256i score8(const SurvivorTable *table, int i,
+                                                             __m256i px, __m256i py, __m256i age0)
+{
+    const __m256i lane_bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    __m256i x = _mm256_loadu_si256((const __m256i *)(table->x + i));
+    __m256i y = _mm256_loadu_si256((const __m256i *)(table->y + i));
+    __m256i p = _mm256_loadu_si256((const __m256i *)(table->priority + i));
+    __m256i c = _mm256_loadu_si256((const __m256i *)(table->created + i));
+    __m256i dist = _mm256_add_epi32(_mm256_abs_epi32(_mm256_sub_epi32(x, px)),
+                                    _mm256_abs_epi32(_mm256_sub_epi32(y, py)));
+    __m256i s = _mm256_mullo_epi32(p, _mm256_set1_epi32(100));
+    s = _mm256_add_epi32(s, _mm256_sub_epi32(age0, c));
+    s = _mm256_sub_epi32(s, _mm256_add_epi32(dist, dist));
+    __m256i bits = _mm256_and_si256(_mm256_set1_epi32((int)block_bits(table, i)), lane_bits);
+    __m256i excluded = _mm256_cmpeq_epi32(bits, lane_bits);
+    return _mm256_blendv_epi8(s, _mm256_set1_epi32(INT32_MIN), excluded);
+}
+
+__attribute__((target("avx2"))) static void score_avx2(const SurvivorTable *table, int32_t px, int32_t py,
+                                                       int32_t age0, int32_t *out)
+{
+    __m256i vpx = _mm256_set1_epi32(px), vpy = _mm256_set1_epi32(py), vage = _mm256_set1_epi32(age0);
+    int i = 0;
+    for (; i + 8 <= table->high; i += 8)
+        _mm256_storeu_si256((__m256i *)(out + i), score8(table, i, vpx, vpy, vage));
+    score_scalar(table, i, px, py, age0, out);
+}
+
+__attribute__((target("avx2"))) static int best_avx2(const SurvivorTable *table, int32_t px, int32_t py,
+                                                     int32_t age0, int32_t *score)
+{
+    __m256i vpx = _mm256_set1_epi32(px), vpy = _mm256_set1_epi32(py), vage = _mm256_set1_epi32(age0);
+    __m256i best = _mm256_set1_epi32(INT32_MIN);
+    __m256i best_index = _mm256_set1_epi32(-1);
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i step = _mm256_set1_epi32(8);
+    int i = 0;
+    for (; i + 8 <= table->high; i += 8)
+    {
+        __m256i s = score8(table, i, vpx, vpy, vage);
+        __m256i better = _mm256_cmpgt_epi32(s, best); // Katı büyük: şeritte ilk slot kalır
+        best = _mm256_blendv_epi8(best, s, better);
+        best_index = _mm256_blendv_epi8(best_index, index, better);
+        index = _mm256_add_epi32(index, step);
+    }
+    int32_t lanes[8], lane_index[8];
+    _mm256_storeu_si256((__m256i *)lanes, best);
+    _mm256_storeu_si256((__m256i *)lane_index, best_index);
+    int32_t tail_score;
+    int result = best_scalar(table, i, px, py, age0, &tail_score);
+    int32_t result_score = tail_score;
+    for (int lane = 0; lane < 8; lane++)
+    {
+        if (lane_index[lane] < 0)
+            continue;
+        if (result < 0 || lanes[lane] > result_score ||
+            (lanes[lane] == result_score && lane_index[lane] < result))
+        {
+            result = lane_index[lane];
+            result_score = lanes[lane];
+        }
+    }
+    *score = result_score;
+    return result;
+}
+
+__attribute__((target("sse4.1"))) static inline __m128i score4(const SurvivorTable *table, int i,
+                                                               __m128i px, __m128i py, __m128i age0)
+{
+    const __m128i lane_bits = _mm_setr_epi32(1, 2, 4, 8);
+    __m128i x = _mm_loadu_si128((const __m128i *)(table->x + i));
+    __m128i y = _mm_loadu_si128((const __m128i *)(table->y + i));
+    __m128i p = _mm_loadu_si128((const __m128i *)(table->priority + i));
+    __m128i c = _mm_loadu_si128((const __m128i *)(table->created + i));
+    __m128i dist = _mm_add_epi32(_mm_abs_epi32(_mm_sub_epi32(x, px)), _mm_abs_epi32(_mm_sub_epi32(y, py)));
+    __m128i s = _mm_mullo_epi32(p, _mm_set1_epi32(100));
+    s = _mm_add_epi32(s, _mm_sub_epi32(age0, c));
+    s = _mm_sub_epi32(s, _mm_add_epi32(dist, dist));
+    unsigned nibble = (unsigned)(table->targeted[i >> 6] >> (i & 63)) & 0xF;
+    __m128i bits = _mm_and_si128(_mm_set1_epi32((int)nibble), lane_bits);
+    __m128i excluded = _mm_cmpeq_epi32(bits, lane_bits);
+    return _mm_blendv_epi8(s, _mm_set1_epi32(INT32_MIN), excluded);
+}
+
+__attribute__((target("sse4.1"))) static void score_sse4(const SurvivorTable *table, int32_t px, int32_t py,
+                                                         int32_t age0, int32_t *out)
+{
+    __m128i vpx = _mm_set1_epi32(px), vpy = _mm_set1_epi32(py), vage = _mm_set1_epi32(age0);
+    int i = 0;
+    for (; i + 4 <= table->high; i += 4)
+        _mm_storeu_si128((__m128i *)(out + i), score4(table, i, vpx, vpy, vage));
+    score_scalar(table, i, px, py, age0, out);
+}
+
+__attribute__((target("sse4.1"))) static int best_sse4(const SurvivorTable *table, int32_t px, int32_t py,
+                                                       int32_t age0, int32_t *score)
+{
+    __m128i vpx = _mm_set1_epi32(px), vpy = _mm_set1_epi32(py), vage = _mm_set1_epi32(age0);
+    __m128i best = _mm_set1_epi32(INT32_MIN);
+    __m128i best_index = _mm_set1_epi32(-1);
+    __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i step = _mm_set1_epi32(4);
+    int i = 0;
+    for (; i + 4 <= table->high; i += 4)
+    {
+        __m128i s = score4(table, i, vpx, vpy, vage);
+        __m128i better = _mm_cmpgt_epi32(s, best);
+        best = _mm_blendv_epi8(best, s, better);
+        best_index = _mm_blendv_epi8(best_index, index, better);
+        index = _mm_add_epi32(index, step);
+    }
+    int32_t lanes[4], lane_index[4];
+    _mm_storeu_si128((__m128i *)lanes, best);
+    _mm_storeu_si128((__m128i *)lane_index, best_index);
+    int32_t result_score;
+    int result = best_scalar(table, i, px, py, age0, &result_score);
+    for (int lane = 0; lane < 4; lane++)
+    {
+        if (lane_index[lane] < 0)
+            continue;
+        if (result < 0 || lanes[lane] > result_score ||
+            (lanes[lane] == result_score && lane_index[lane] < result))
+        {
+            result = lane_index[lane];
+            result_score = lanes[lane];
+        }
+    }
+    *score = result_score;
+    return result;
+}
+#endif
+
+void survtab_score(const SurvivorTable *table, Coordinate pos, time_t now, int32_t *out)
+{
+    int32_t age0 = (int32_t)difftime(now, table->base);
+    switch (current_kernel())
+    {
+#ifdef SURVTAB_X86
+    case SURVTAB_AVX2:
+        score_avx2(table, pos.x, pos.y, age0, out);
+        return;
+    case SURVTAB_SSE4:
+        score_sse4(table, pos.x, pos.y, age0, out);
+        return;
+#endif
+    default:
+        score_scalar(table, 0, pos.x, pos.y, age0, out);
+    }
+}
+
+int survtab_best(const SurvivorTable *table, Coordinate pos, time_t now, int32_t *score)
+{
+    int32_t age0 = (int32_t)difftime(now, table->base);
+    switch (current_kernel())
+    {
+#ifdef SURVTAB_X86
+    case SURVTAB_AVX2:
+        return best_avx2(table, pos.x, pos.y, age0, score);
+    case SURVTAB_SSE4:
+        return best_sse4(table, pos.x, pos.y, age0, score);
+#endif
+    default:
+        return best_scalar(table, 0, pos.x, pos.y, age0, score);
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef SURVTAB_H
+#define SURVTAB_H
+
+#include "survivor.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+// Survivor'ların skorlama için yoğun sütun (SoA) kopyası. Her survivor kalıcı bir
+// slot alır (Survivor.table_slot); silinen slot boşaltılır ve sonraki eklemede
+// yeniden kullanılır, diğer slotlar yer değiştirmez. Sütunlar 32 bit olduğundan
+// AVX2 çekirdeği bir komutta 8 survivor skorlar; SSE4.1'de 4, diğer
+// işlemcilerde skaler döngü. Skor SURVGRID_SCORE ile aynıdır, tamsayı olarak.
+// Tablo kendi kilidini tutmaz; sahibi olan ızgarayla aynı kilit altında kullanılır.
+typedef enum
+{
+    SURVTAB_SCALAR,
+    SURVTAB_SSE4,
+    SURVTAB_AVX2
+} SurvtabKernel;
+
+typedef struct
+{
+    int32_t *x;
+    int32_t *y;
+    int32_t *priority;
+    int32_t *created;   // creation_time - base (saniye)
+    uint64_t *targeted; // Bit başına slot: hedeflenmiş ya da boş, skorlamaya girmez
+    Survivor **owner;   // Slot -> Survivor (boşsa NULL)
+    int *free_slots;    // Yeniden kullanılacak boş slotlar (yığın)
+    int free_count;
+    int high;           // Kullanılmış en yüksek slot + 1; taramalar [0, high)
+    int cap;            // 64'ün katı
+    int count;
+    time_t base;
+} SurvivorTable;
+
+bool survtab_init(SurvivorTable *table, int initial_cap);
+void survtab_destroy(SurvivorTable *table);
+// Survivor'a slot verir (s->table_slot). Bellek yoksa false.
+bool survtab_insert(SurvivorTable *table, Survivor *s);
+void survtab_remove(SurvivorTable *table, Survivor *s);
+// Slotlar [0, high) için pos'tan skorları out'a yazar; hedeflenmiş/boş slotlar INT32_MIN.
+void survtab_score(const SurvivorTable *table, Coordinate pos, time_t now, int32_t *out);
+// En yüksek skorlu hedeflenmemiş slot (eşitlikte küçük slot) ya da -1; *score doldurulur.
+int survtab_best(const SurvivorTable *table, Coordinate pos, time_t now, int32_t *score);
+// Dolu slotları artan sırayla slots'a yazar (en az table->count eleman); sayıyı döndürür.
+int survtab_slots(const SurvivorTable *table, int *slots);
+// Seçili çekirdek: başlangıçta işlemciye göre belirlenir. İşlemcinin desteklemediği
+// bir çekirdek istenirse desteklenen en iyisine düşer; seçileni döndürür.
+SurvtabKernel survtab_use_kernel(SurvtabKernel kernel);
+SurvtabKernel survtab_best_kernel(void);
+const char *survtab_kernel_name(SurvtabKernel kernel);
+
+#endif
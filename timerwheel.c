@@ -0,0 +1,157 @@
+#define _POSIX_C_SOURCE 199309L // clock_gettime
+#include "timerwheel.h"
+#include <stddef.h>
+#include <time.h>
+
+#define TW_LEVEL0_MASK (TW_LEVEL0_SIZE - 1)
+#define TW_LEVEL_MASK (TW_LEVEL_SIZE - 1)
+#define TW_MAX_DELTA ((1ULL << (TW_LEVEL0_BITS + (TW_LEVELS - 1) * TW_LEVEL_BITS)) - 1)
+
+uint64_t monotonic_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+void timer_wheel_init(TimerWheel *wheel, uint64_t now_ms)
+{
+    wheel->current = now_ms;
+    for (int i = 0; i < TW_LEVEL0_SIZE; i++)
+        wheel->level0[i] = NULL;
+    for (int level = 0; level < TW_LEVELS - 1; level++)
+        for (int i = 0; i < TW_LEVEL_SIZE; i++)
+            wheel->levels[level][i] = NULL;
+}
+
+void timer_init(Timer *timer, TimerCallback callback, void *arg)
+{
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->expires = 0;
+    timer->callback = callback;
+    timer->arg = arg;
+}
+
+bool timer_pending(const Timer *timer)
+{
+    return timer->pprev != NULL;
+}
+
+static void list_push(Timer **head, Timer *timer)
+{
+    timer->next = *head;
+    if (*head)
+        (*head)->pprev = &timer->next;
+    *head = timer;
+    timer->pprev = head;
+}
+
+void timer_cancel(Timer *timer)
+{
+    if (!timer->pprev)
+        return;
+    *timer->pprev = timer->next;
+    if (timer->next)
+        timer->next->pprev = timer->pprev;
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+// Zamanlayıcıyı, current'a olan uzaklığına göre uygun seviyenin yuvasına koyar.
+static void wheel_insert(TimerWheel *wheel, Timer *timer)
+{
+    uint64_t expires = timer->expires;
+    if (expires < wheel->current)
+        expires = wheel->current; // Geçmişte kalan: bir sonraki tikte çalışır
+    uint64_t delta = expires - wheel->current;
+    if (delta > TW_MAX_DELTA)
+    {
+        expires = wheel->current + TW_MAX_DELTA;
+        delta = TW_MAX_DELTA;
+    }
+
+    if (delta < TW_LEVEL0_SIZE)
+    {
+        list_push(&wheel->level0[expires & TW_LEVEL0_MASK], timer);
+        return;
+    }
+    for (int level = 0; level < TW_LEVELS - 1; level++)
+    {
+        int shift = TW_LEVEL0_BITS + level * TW_LEVEL_BITS;
+        if (delta < (1ULL << (shift + TW_LEVEL_BITS)) || level == TW_LEVELS - 2)
+        {
+            list_push(&wheel->levels[level][(expires >> shift) & TW_LEVEL_MASK], timer);
+            return;
+        }
+    }
+}
+
+void timer_schedule(TimerWheel *wheel, Timer *timer, uint64_t expires_ms)
+{
+    timer_cancel(timer);
+    timer->expires = expires_ms;
+    wheel_insert(wheel, timer);
+}
+
+// Üst seviyedeki bir yuvanın zamanlayıcılarını yeniden dağıtır; index'i döndürür.
+static int cascade(TimerWheel *wheel, int level)
+{
+    int shift = TW_LEVEL0_BITS + level * TW_LEVEL_BITS;
+    int index = (int)((wheel->current >> shift) & TW_LEVEL_MASK);
+    Timer *list = wheel->levels[level][index];
+    wheel->levels[level][index] = NULL;
+    while (list)
+    {
+        Timer *timer = list;
+        list = timer->next;
+        timer->next = NULL;
+        timer->pprev = NULL;
+        wheel_insert(wheel, timer);
+    }
+    return index;
+}
+
+void timer_wheel_advance(TimerWheel *wheel, uint64_t now_ms)
+{
+    while (wheel->current <= now_ms)
+    {
+        int index = (int)(wheel->current & TW_LEVEL0_MASK);
+        if (index == 0)
+        {
+            // Seviye 0 tur tamamladı: bir üst seviyenin sıradaki yuvasını aşağı indir
+            for (int level = 0; level < TW_LEVELS - 1 && cascade(wheel, level) == 0; level++)
+                ;
+        }
+
+        // Yuvayı yerel listeye taşı; current ilerletildiği için callback'lerin
+        // kurduğu zamanlayıcılar bu listeye değil çarka düşer.
+        Timer *expired = wheel->level0[index];
+        wheel->level0[index] = NULL;
+        if (expired)
+            expired->pprev = &expired;
+        wheel->current++;
+
+        while (expired)
+        {
+            Timer *timer = expired;
+            timer_cancel(timer);
+            timer->callback(timer, timer->arg);
+        }
+    }
+}
+
+int timer_wheel_next_timeout(const TimerWheel *wheel, uint64_t now_ms, int max_ms)
+{
+    if (wheel->current <= now_ms)
+        return 0;
+    int waited = (int)(wheel->current - now_ms);
+    // Seviye 0'ı bir sonraki tur başına kadar tara; tur başında kaskad gerekir
+    for (int i = 0; i < TW_LEVEL0_SIZE && waited + i < max_ms; i++)
+    {
+        uint64_t tick = wheel->current + i;
+        if ((tick & TW_LEVEL0_MASK) == 0 || wheel->level0[tick & TW_LEVEL0_MASK])
+            return waited + i;
+    }
+    return max_ms;
+}
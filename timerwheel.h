@@ -0,0 +1,51 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Milisaniye çözünürlüklü hiyerarşik zamanlayıcı çarkı. Seviye 0'da 256 adet
+// 1 ms'lik yuva, üst seviyelerde 64'er yuva bulunur (toplam ~18.6 saat aralık).
+// Ekleme ve iptal O(1); uzak zamanlayıcılar yaklaştıkça alt seviyelere iner.
+// Tek thread'den kullanılır (her reactor shard'ın kendi çarkı vardır).
+#define TW_LEVEL0_BITS 8
+#define TW_LEVEL_BITS 6
+#define TW_LEVELS 4
+#define TW_LEVEL0_SIZE (1 << TW_LEVEL0_BITS)
+#define TW_LEVEL_SIZE (1 << TW_LEVEL_BITS)
+
+struct Timer;
+typedef void (*TimerCallback)(struct Timer *timer, void *arg);
+
+// Zamanlayıcı, sahibi olan yapının içine gömülür; ayrı bellek ayrılmaz.
+typedef struct Timer
+{
+    struct Timer *next;
+    struct Timer **pprev; // Listede değilse NULL
+    uint64_t expires;     // Mutlak zaman (ms)
+    TimerCallback callback;
+    void *arg;
+} Timer;
+
+typedef struct
+{
+    uint64_t current; // İşlenecek bir sonraki tik (ms)
+    Timer *level0[TW_LEVEL0_SIZE];
+    Timer *levels[TW_LEVELS - 1][TW_LEVEL_SIZE];
+} TimerWheel;
+
+uint64_t monotonic_ms(void);
+
+void timer_wheel_init(TimerWheel *wheel, uint64_t now_ms);
+void timer_init(Timer *timer, TimerCallback callback, void *arg);
+bool timer_pending(const Timer *timer);
+// Zamanlayıcıyı expires_ms'de çalışacak şekilde kurar; zaten kuruluysa taşır.
+void timer_schedule(TimerWheel *wheel, Timer *timer, uint64_t expires_ms);
+void timer_cancel(Timer *timer);
+// now_ms'ye kadar süresi dolan zamanlayıcıları çalıştırır. Callback'ler
+// zamanlayıcıları kurabilir veya iptal edebilir (kendi zamanlayıcısı dahil).
+void timer_wheel_advance(TimerWheel *wheel, uint64_t now_ms);
+// Bir sonraki olası tetiklemeye kalan süre (en fazla max_ms); epoll_wait için.
+int timer_wheel_next_timeout(const TimerWheel *wheel, uint64_t now_ms, int max_ms);
+
+#endif
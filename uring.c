@@ -0,0 +1,281 @@
+#define _GNU_SOURCE // syscall, MAP_POPULATE
+#include "uring.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+static int sys_io_uring_setup(unsigned entries, struct io_uring_params *p)
+{
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags, void *arg, size_t argsz)
+{
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, argsz);
+}
+
+static int sys_io_uring_register(int fd, unsigned opcode, void *arg, unsigned nr_args)
+{
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+bool uring_init(Uring *ring, unsigned entries)
+{
+    memset(ring, 0, sizeof(*ring));
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_SUBMIT_ALL;
+    ring->ring_fd = sys_io_uring_setup(entries, &params);
+    if (ring->ring_fd < 0)
+        return false;
+    // Multishot recv + tampon halkası + EXT_ARG zaman aşımı 5.19 ve sonrası gerektirir
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_EXT_ARG))
+    {
+        close(ring->ring_fd);
+        errno = ENOSYS;
+        return false;
+    }
+
+    ring->sq_len = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_len = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (ring->cq_len > ring->sq_len)
+        ring->sq_len = ring->cq_len;
+    ring->cq_len = ring->sq_len; // SINGLE_MMAP: SQ ve CQ aynı eşlemede
+
+    ring->sq_ptr = mmap(NULL, ring->sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ring->ring_fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ptr == MAP_FAILED)
+    {
+        close(ring->ring_fd);
+        return false;
+    }
+    ring->cq_ptr = ring->sq_ptr;
+
+    ring->sqes_len = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring->ring_fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED)
+    {
+        munmap(ring->sq_ptr, ring->sq_len);
+        close(ring->ring_fd);
+        return false;
+    }
+
+    char *sq = (char *)ring->sq_ptr;
+    ring->sq_head = (unsigned *)(sq + params.sq_off.head);
+    ring->sq_tail = (unsigned *)(sq + params.sq_off.tail);
+    ring->sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned *)(sq + params.sq_off.array);
+    ring->sq_entries = params.sq_entries;
+    ring->sqe_tail = *ring->sq_tail;
+    // SQE indeksleri bire bir eşlenir; dizi bir kez doldurulur
+    for (unsigned i = 0; i < params.sq_entries; i++)
+        ring->sq_array[i] = i;
+
+    char *cq = (char *)ring->cq_ptr;
+    ring->cq_head = (unsigned *)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned *)(cq + params.cq_off.tail);
+    ring->cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+    return true;
+}
+
+void uring_destroy(Uring *ring)
+{
+    if (ring->ring_fd <= 0)
+        return;
+    munmap(ring->sqes, ring->sqes_len);
+    munmap(ring->sq_ptr, ring->sq_len);
+    close(ring->ring_fd);
+    ring->ring_fd = -1;
+}
+
+// Boş bir SQE döndürür. Kuyruk doluysa önce bekleyenleri gönderir.
+struct io_uring_sqe *uring_get_sqe(Uring *ring)
+{
+    unsigned head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    if (ring->sqe_tail - head >= ring->sq_entries)
+    {
+        uring_submit(ring);
+        head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+        if (ring->sqe_tail - head >= ring->sq_entries)
+            return NULL;
+    }
+    struct io_uring_sqe *sqe = &ring->sqes[ring->sqe_tail & *ring->sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    ring->sqe_tail++;
+    return sqe;
+}
+
+static unsigned uring_flush_sq(Uring *ring)
+{
+    unsigned tail = *ring->sq_tail;
+    unsigned to_submit = ring->sqe_tail - tail;
+    if (to_submit)
+        __atomic_store_n(ring->sq_tail, ring->sqe_tail, __ATOMIC_RELEASE);
+    return to_submit;
+}
+
+int uring_submit(Uring *ring)
+{
+    unsigned to_submit = uring_flush_sq(ring);
+    if (!to_submit)
+        return 0;
+    ring->enter_calls++;
+    return sys_io_uring_enter(ring->ring_fd, to_submit, 0, 0, NULL, 0);
+}
+
+// Bekleyen tüm SQE'leri tek bir sistem çağrısıyla gönderir ve en az bir CQE
+// gelene veya timeout_ms dolana kadar bekler.
+int uring_submit_and_wait(Uring *ring, int timeout_ms)
+{
+    unsigned to_submit = uring_flush_sq(ring);
+    struct __kernel_timespec ts = {.tv_sec = timeout_ms / 1000, .tv_nsec = (long long)(timeout_ms % 1000) * 1000000};
+    struct io_uring_getevents_arg arg;
+    memset(&arg, 0, sizeof(arg));
+    arg.ts = (uint64_t)(uintptr_t)&ts;
+    ring->enter_calls++;
+    int ret = sys_io_uring_enter(ring->ring_fd, to_submit, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                                 &arg, sizeof(arg));
+    if (ret < 0 && (errno == ETIME || errno == EINTR))
+        return 0;
+    return ret;
+}
+
+struct io_uring_cqe *uring_peek_cqe(Uring *ring)
+{
+    unsigned head = *ring->cq_head;
+    if (head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE))
+        return NULL;
+    return &ring->cqes[head & *ring->cq_mask];
+}
+
+void uring_cqe_seen(Uring *ring)
+{
+    __atomic_store_n(ring->cq_head, *ring->cq_head + 1, __ATOMIC_RELEASE);
+}
+
+bool uring_buf_ring_init(Uring *ring, UringBufRing *bufs, unsigned short bgid, unsigned entries, unsigned buf_size)
+{
+    memset(bufs, 0, sizeof(*bufs));
+    bufs->entries = entries;
+    bufs->buf_size = buf_size;
+    bufs->bgid = bgid;
+    bufs->br_len = entries * sizeof(struct io_uring_buf);
+    bufs->br = mmap(NULL, bufs->br_len, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (bufs->br == MAP_FAILED)
+        return false;
+    bufs->base = malloc((size_t)entries * buf_size);
+    if (!bufs->base)
+    {
+        munmap(bufs->br, bufs->br_len);
+        return false;
+    }
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)bufs->br;
+    reg.ring_entries = entries;
+    reg.bgid = bgid;
+    if (sys_io_uring_register(ring->ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+    {
+        free(bufs->base);
+        munmap(bufs->br, bufs->br_len);
+        return false;
+    }
+
+    bufs->br->tail = 0;
+    for (unsigned bid = 0; bid < entries; bid++)
+        uring_buf_ring_recycle(bufs, bid);
+    return true;
+}
+
+void uring_buf_ring_destroy(Uring *ring, UringBufRing *bufs)
+{
+    if (!bufs->br)
+        return;
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.bgid = bufs->bgid;
+    sys_io_uring_register(ring->ring_fd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+    free(bufs->base);
+    munmap(bufs->br, bufs->br_len);
+    bufs->br = NULL;
+}
+
+char *uring_buf_ring_addr(UringBufRing *bufs, unsigned bid)
+{
+    return bufs->base + (size_t)bid * bufs->buf_size;
+}
+
+// İşlenen tamponu kernel'in tekrar seçebilmesi için halkaya geri verir.
+void uring_buf_ring_recycle(UringBufRing *bufs, unsigned bid)
+{
+    unsigned short tail = bufs->br->tail;
+    struct io_uring_buf *buf = &bufs->br->bufs[tail & (bufs->entries - 1)];
+    buf->addr = (uint64_t)(uintptr_t)uring_buf_ring_addr(bufs, bid);
+    buf->len = bufs->buf_size;
+    buf->bid = (unsigned short)bid;
+    __atomic_store_n(&bufs->br->tail, (unsigned short)(tail + 1), __ATOMIC_RELEASE);
+}
+
+void uring_prep_recv_multishot(struct io_uring_sqe *sqe, int fd, unsigned short bgid, uint64_t user_data)
+{
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = bgid;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->user_data = user_data;
+}
+
+void uring_prep_accept_multishot(struct io_uring_sqe *sqe, int fd, uint64_t user_data)
+{
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = fd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = user_data;
+}
+
+void uring_prep_poll_multishot(struct io_uring_sqe *sqe, int fd, unsigned events, uint64_t user_data)
+{
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = events;
+    sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->user_data = user_data;
+}
+
+void uring_prep_send(struct io_uring_sqe *sqe, int fd, const void *buf, size_t len, uint64_t user_data)
+{
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)buf;
+    sqe->len = (unsigned)len;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = user_data;
+}
+
+// msg (ve gösterdiği iovec dizisi) CQE gelene kadar geçerli kalmalıdır.
+void uring_prep_sendmsg(struct io_uring_sqe *sqe, int fd, const struct msghdr *msg, uint64_t user_data)
+{
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)msg;
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = user_data;
+}
+
+void uring_prep_cancel(struct io_uring_sqe *sqe, uint64_t target_user_data, uint64_t user_data)
+{
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = target_user_data;
+    sqe->user_data = user_data;
+}
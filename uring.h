@@ -0,0 +1,64 @@
+#ifndef URING_H
+#define URING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <linux/io_uring.h>
+#include <sys/socket.h>
+
+// liburing'e bağımlı olmamak için io_uring sistem çağrıları üzerine ince bir katman.
+typedef struct
+{
+    int ring_fd;
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned sq_entries;
+    unsigned sqe_tail; // Hazırlanmış ama henüz kernel'e bildirilmemiş SQE'ler dahil
+    struct io_uring_sqe *sqes;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_cqe *cqes;
+    void *sq_ptr;
+    size_t sq_len;
+    void *cq_ptr;
+    size_t cq_len;
+    size_t sqes_len;
+    unsigned long enter_calls; // io_uring_enter çağrı sayısı (istatistik)
+} Uring;
+
+// Kernel'in multishot recv için seçtiği sağlanmış (provided) tampon halkası.
+typedef struct
+{
+    struct io_uring_buf_ring *br;
+    size_t br_len;
+    char *base;
+    unsigned entries; // 2'nin kuvveti olmalı
+    unsigned buf_size;
+    unsigned short bgid;
+} UringBufRing;
+
+bool uring_init(Uring *ring, unsigned entries);
+void uring_destroy(Uring *ring);
+struct io_uring_sqe *uring_get_sqe(Uring *ring);
+int uring_submit(Uring *ring);
+int uring_submit_and_wait(Uring *ring, int timeout_ms);
+struct io_uring_cqe *uring_peek_cqe(Uring *ring);
+void uring_cqe_seen(Uring *ring);
+
+bool uring_buf_ring_init(Uring *ring, UringBufRing *bufs, unsigned short bgid, unsigned entries, unsigned buf_size);
+void uring_buf_ring_destroy(Uring *ring, UringBufRing *bufs);
+char *uring_buf_ring_addr(UringBufRing *bufs, unsigned bid);
+void uring_buf_ring_recycle(UringBufRing *bufs, unsigned bid);
+
+void uring_prep_recv_multishot(struct io_uring_sqe *sqe, int fd, unsigned short bgid, uint64_t user_data);
+void uring_prep_accept_multishot(struct io_uring_sqe *sqe, int fd, uint64_t user_data);
+void uring_prep_poll_multishot(struct io_uring_sqe *sqe, int fd, unsigned events, uint64_t user_data);
+void uring_prep_send(struct io_uring_sqe *sqe, int fd, const void *buf, size_t len, uint64_t user_data);
+void uring_prep_sendmsg(struct io_uring_sqe *sqe, int fd, const struct msghdr *msg, uint64_t user_data);
+void uring_prep_cancel(struct io_uring_sqe *sqe, uint64_t target_user_data, uint64_t user_data);
+
+#endif
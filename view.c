@@ -3,16 +3,20 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <errno.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <sys/un.h>
 #include <json-c/json.h>
 #include "drone.h"
 #include "survivor.h"
 #include "list.h"
+#include "snapshot.h"
 
 #define SERVER_IP "127.0.0.1"
 #define PORT 8081
+#define VIEW_UNIX_PATH "/tmp/drone_server_view.sock" // --local: sunucuyla aynı makinede
 #define CELL_SIZE 15  // Hücre boyutunu artırdık, daha görünür olsun
 #define MAP_WIDTH 60  // Harita genişliği 60
 #define MAP_HEIGHT 40 // Harita yüksekliği 40
@@ -47,6 +51,50 @@ int connect_to_server()
     return sock;
 }
 
+// --local: Unix soketi üzerinden HANDSHAKE yapar ve sunucunun paylaşımlı durum
+// bölgesini salt okunur eşler. Soket, sunucunun canlılığını izlemek için açık kalır.
+const SnapshotRegion *connect_local_snapshot(int *sock_out)
+{
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    strncpy(addr.sun_path, VIEW_UNIX_PATH, sizeof(addr.sun_path) - 1);
+    if (sock < 0 || connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        perror("Local connect failed");
+        if (sock >= 0)
+            close(sock);
+        return NULL;
+    }
+    const char *handshake = "{\"type\":\"VIEW_HANDSHAKE\",\"transport\":\"shm\"}\n";
+    send(sock, handshake, strlen(handshake), 0);
+
+    // ACK JSON'u ve bölgenin tanıtıcısı aynı mesajda gelir
+    char buffer[512];
+    char control[CMSG_SPACE(sizeof(int))];
+    struct iovec iov = {.iov_base = buffer, .iov_len = sizeof(buffer) - 1};
+    struct msghdr msg = {.msg_iov = &iov, .msg_iovlen = 1, .msg_control = control, .msg_controllen = sizeof(control)};
+    ssize_t len = recvmsg(sock, &msg, 0);
+    struct cmsghdr *cmsg = len > 0 ? CMSG_FIRSTHDR(&msg) : NULL;
+    if (!cmsg || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+    {
+        fprintf(stderr, "Local handshake failed: no snapshot descriptor received.\n");
+        close(sock);
+        return NULL;
+    }
+    int fd;
+    memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+    const SnapshotRegion *region = snapshot_map_readonly(fd);
+    close(fd); // Eşleme tanıtıcıdan bağımsız yaşar
+    if (!region)
+    {
+        fprintf(stderr, "Local handshake failed: snapshot layout mismatch.\n");
+        close(sock);
+        return NULL;
+    }
+    *sock_out = sock;
+    return region;
+}
+
 void send_json(int sock, json_object *jobj)
 {
     const char *str = json_object_to_json_string(jobj);
@@ -105,6 +153,27 @@ void draw_cell(int x, int y, SDL_Color color)
     SDL_RenderFillRect(renderer, &rect);
 }
 
+void draw_drone(int x, int y, DroneStatus status, int tx, int ty)
+{
+    SDL_Color color = (status == IDLE) ? BLUE : GREEN;
+    draw_cell(x, y, color);
+
+    if (status == ON_MISSION)
+    {
+        // Hedef koordinatların da harita sınırları içinde olduğundan emin ol
+        if (tx >= 0 && tx < MAP_HEIGHT && ty >= 0 && ty < MAP_WIDTH)
+        {
+            SDL_SetRenderDrawColor(renderer, GREEN.r, GREEN.g, GREEN.b, GREEN.a);
+            SDL_RenderDrawLine(
+                renderer,
+                y * CELL_SIZE + CELL_SIZE / 2,
+                x * CELL_SIZE + CELL_SIZE / 2,
+                ty * CELL_SIZE + CELL_SIZE / 2,
+                tx * CELL_SIZE + CELL_SIZE / 2);
+        }
+    }
+}
+
 void draw_drones()
 {
     pthread_mutex_lock(&drone_list->lock);
@@ -113,23 +182,7 @@ void draw_drones()
     {
         Drone *d = (Drone *)current->data;
         pthread_mutex_lock(&d->lock);
-        SDL_Color color = (d->status == IDLE) ? BLUE : GREEN;
-        draw_cell(d->coord.x, d->coord.y, color);
-
-        if (d->status == ON_MISSION)
-        {
-            // Hedef koordinatların da harita sınırları içinde olduğundan emin ol
-            if (d->target.x >= 0 && d->target.x < MAP_HEIGHT && d->target.y >= 0 && d->target.y < MAP_WIDTH)
-            {
-                SDL_SetRenderDrawColor(renderer, GREEN.r, GREEN.g, GREEN.b, GREEN.a);
-                SDL_RenderDrawLine(
-                    renderer,
-                    d->coord.y * CELL_SIZE + CELL_SIZE / 2,
-                    d->coord.x * CELL_SIZE + CELL_SIZE / 2,
-                    d->target.y * CELL_SIZE + CELL_SIZE / 2,
-                    d->target.x * CELL_SIZE + CELL_SIZE / 2);
-            }
-        }
+        draw_drone(d->coord.x, d->coord.y, d->status, d->target.x, d->target.y);
         pthread_mutex_unlock(&d->lock);
         current = current->next;
     }
@@ -255,8 +308,75 @@ void update_lists_from_json(json_object *jobj)
     }
 }
 
-int main()
+// Paylaşımlı çerçeveyi yerinde çizer. Çizim sırasında sunucu çerçeveyi yeniden
+// yazdıysa sonuç ekrana verilmez; bir sonraki turda tekrar denenir.
+bool draw_map_snapshot(const SnapshotRegion *region)
 {
+    uint64_t seq;
+    const SnapshotFrame *frame = snapshot_read_begin(region, &seq);
+    SDL_SetRenderDrawColor(renderer, BLACK.r, BLACK.g, BLACK.b, BLACK.a);
+    SDL_RenderClear(renderer);
+
+    uint32_t survivor_count = frame->survivor_count < SNAPSHOT_MAX_SURVIVORS ? frame->survivor_count : SNAPSHOT_MAX_SURVIVORS;
+    for (uint32_t i = 0; i < survivor_count; i++)
+        draw_cell(frame->survivors[i].x, frame->survivors[i].y, RED);
+    uint32_t drone_count = frame->drone_count < SNAPSHOT_MAX_DRONES ? frame->drone_count : SNAPSHOT_MAX_DRONES;
+    for (uint32_t i = 0; i < drone_count; i++)
+    {
+        const SnapshotDrone *d = &frame->drones[i];
+        draw_drone(d->x, d->y, d->status == IDLE ? IDLE : ON_MISSION, d->target_x, d->target_y);
+    }
+    draw_grid();
+
+    if (!snapshot_read_valid(frame, seq))
+        return false;
+    SDL_RenderPresent(renderer);
+    return true;
+}
+
+// --local döngüsü: sadece yeni bir çerçeve yayınlandığında çizer.
+int run_local_view()
+{
+    int sock;
+    const SnapshotRegion *region = connect_local_snapshot(&sock);
+    if (!region)
+        return 1;
+    if (init_sdl_window())
+    {
+        fprintf(stderr, "SDL başlatma başarısız.\n");
+        snapshot_unmap(region);
+        close(sock);
+        return 1;
+    }
+
+    uint64_t drawn_generation = 0;
+    char probe;
+    while (!check_events())
+    {
+        // Sunucu kapanınca kontrol soketi EOF verir
+        ssize_t r = recv(sock, &probe, 1, MSG_DONTWAIT);
+        if (r == 0 || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+        {
+            fprintf(stderr, "Sunucu bağlantısı kesildi.\n");
+            break;
+        }
+        uint64_t generation = snapshot_generation(region);
+        if (generation != drawn_generation && draw_map_snapshot(region))
+            drawn_generation = generation;
+        SDL_Delay(50);
+    }
+
+    snapshot_unmap(region);
+    close(sock);
+    quit_all();
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "--local") == 0)
+        return run_local_view();
+
     drone_list = create_list();
     survivor_list = create_list();
 
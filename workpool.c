@@ -0,0 +1,187 @@
+#include "workpool.h"
+#include <stdlib.h>
+
+typedef struct
+{
+    WorkPool *pool;
+    int index;
+} WorkerArg;
+
+static bool deque_pop_tail(WorkDeque *dq, int *task)
+{
+    pthread_mutex_lock(&dq->lock);
+    bool ok = dq->tail > dq->head;
+    if (ok)
+        *task = dq->items[--dq->tail];
+    pthread_mutex_unlock(&dq->lock);
+    return ok;
+}
+
+static bool deque_steal_head(WorkDeque *dq, int *task)
+{
+    pthread_mutex_lock(&dq->lock);
+    bool ok = dq->tail > dq->head;
+    if (ok)
+        *task = dq->items[dq->head++];
+    pthread_mutex_unlock(&dq->lock);
+    return ok;
+}
+
+static void *worker_main(void *arg)
+{
+    WorkerArg *wa = (WorkerArg *)arg;
+    WorkPool *pool = wa->pool;
+    int self = wa->index;
+    free(wa);
+
+    unsigned long seen = 0;
+    for (;;)
+    {
+        pthread_mutex_lock(&pool->lock);
+        while (!pool->stopping && pool->generation == seen)
+            pthread_cond_wait(&pool->start, &pool->lock);
+        if (pool->stopping)
+        {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        seen = pool->generation;
+        WorkFn fn = pool->fn;
+        void *ctx = pool->ctx;
+        pthread_mutex_unlock(&pool->lock);
+
+        unsigned long tasks = 0, steals = 0;
+        int task;
+        for (;;)
+        {
+            if (deque_pop_tail(&pool->deques[self], &task))
+            {
+                fn(ctx, task, self);
+                tasks++;
+                continue;
+            }
+            // Kendi kuyruğu boş: diğer işçilerden çal. Run sırasında yeni görev
+            // eklenmediği için hepsi boşsa bu işçinin işi bitmiştir.
+            bool stolen = false;
+            for (int k = 1; k < pool->workers && !stolen; k++)
+                stolen = deque_steal_head(&pool->deques[(self + k) % pool->workers], &task);
+            if (!stolen)
+                break;
+            fn(ctx, task, self);
+            tasks++;
+            steals++;
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        pool->stat_tasks += tasks;
+        pool->stat_steals += steals;
+        if (--pool->running == 0)
+            pthread_cond_signal(&pool->done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+WorkPool *workpool_create(int workers)
+{
+    if (workers < 1)
+        workers = 1;
+    WorkPool *pool = calloc(1, sizeof(WorkPool));
+    if (!pool)
+        return NULL;
+    pool->threads = calloc((size_t)workers, sizeof(pthread_t));
+    pool->deques = calloc((size_t)workers, sizeof(WorkDeque));
+    if (!pool->threads || !pool->deques)
+    {
+        free(pool->threads);
+        free(pool->deques);
+        free(pool);
+        return NULL;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    for (int i = 0; i < workers; i++)
+        pthread_mutex_init(&pool->deques[i].lock, NULL);
+
+    for (int i = 0; i < workers; i++)
+    {
+        WorkerArg *wa = malloc(sizeof(WorkerArg));
+        if (wa)
+        {
+            wa->pool = pool;
+            wa->index = i;
+        }
+        if (!wa || pthread_create(&pool->threads[i], NULL, worker_main, wa) != 0)
+        {
+            free(wa);
+            workpool_destroy(pool); // Sadece başlatılan pool->workers işçi durdurulur
+            return NULL;
+        }
+        pool->workers = i + 1;
+    }
+    return pool;
+}
+
+void workpool_destroy(WorkPool *pool)
+{
+    if (!pool)
+        return;
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->workers; i++)
+        pthread_join(pool->threads[i], NULL);
+    for (int i = 0; i < pool->workers; i++)
+    {
+        pthread_mutex_destroy(&pool->deques[i].lock);
+        free(pool->deques[i].items);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+    free(pool->deques);
+    free(pool->threads);
+    free(pool);
+}
+
+void workpool_run(WorkPool *pool, int task_count, WorkFn fn, void *ctx)
+{
+    if (task_count <= 0)
+        return;
+    // Görevleri işçilere sırayla dağıt; komşu bölgeler farklı işçilere düşer
+    for (int w = 0; w < pool->workers; w++)
+    {
+        WorkDeque *dq = &pool->deques[w];
+        int need = task_count / pool->workers + 1;
+        if (dq->cap < need)
+        {
+            int *items = realloc(dq->items, (size_t)need * sizeof(int));
+            if (!items)
+            {
+                // Bellek yoksa görevleri çağıran thread'de sırayla çalıştır
+                for (int t = 0; t < task_count; t++)
+                    fn(ctx, t, 0);
+                return;
+            }
+            dq->items = items;
+            dq->cap = need;
+        }
+        dq->head = dq->tail = 0;
+    }
+    for (int t = 0; t < task_count; t++)
+    {
+        WorkDeque *dq = &pool->deques[t % pool->workers];
+        dq->items[dq->tail++] = t;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->running = pool->workers;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    while (pool->running > 0)
+        pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
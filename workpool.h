@@ -0,0 +1,44 @@
+#ifndef WORKPOOL_H
+#define WORKPOOL_H
+
+#include <pthread.h>
+#include <stdbool.h>
+
+// İş çalan (work-stealing) sabit iş parçacığı havuzu. workpool_run görevleri
+// 0..task_count-1 indeksleriyle işçilerin kuyruklarına sırayla dağıtır; her işçi
+// kendi kuyruğunun sonundan alır, kuyruğu boşalınca diğerlerinin başından çalar.
+// Çağrı tüm görevler bitene kadar bloklar. Aynı anda tek bir run çalışabilir.
+typedef void (*WorkFn)(void *ctx, int task, int worker);
+
+typedef struct
+{
+    pthread_mutex_t lock;
+    int *items;
+    int head; // Hırsızlar buradan alır
+    int tail; // Sahibi buradan alır
+    int cap;
+} WorkDeque;
+
+typedef struct WorkPool
+{
+    pthread_t *threads;
+    WorkDeque *deques;
+    int workers;
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    unsigned long generation; // Her run'da artar; işçiler buna göre uyanır
+    int running;              // Bu run'da henüz bitmemiş işçi sayısı
+    bool stopping;
+    WorkFn fn;
+    void *ctx;
+    unsigned long stat_tasks;  // Tamamlanan görev
+    unsigned long stat_steals; // Başka işçinin kuyruğundan alınan görev
+} WorkPool;
+
+// workers < 1 ise 1 kullanılır. Başarısızsa NULL.
+WorkPool *workpool_create(int workers);
+void workpool_destroy(WorkPool *pool);
+void workpool_run(WorkPool *pool, int task_count, WorkFn fn, void *ctx);
+
+#endif